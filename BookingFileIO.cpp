@@ -1,6 +1,49 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: BookingFileIO.cpp
+// Rev.26 - 18/10/2026 - The indexes have their own locks, so threads may look
+//                       bookings up while another thread writes.
+// Rev.25 - 18/10/2026 - Added claimBookingStore.
+// Rev.24 - 18/10/2026 - compactBookingFile checks the index and counts the
+//                       tombstones under its whole-file lock.
+// Rev.23 - 18/10/2026 - Tombstones and compaction bump the generation in the
+//                       file header; the index is rebuilt when it changes.
+// Rev.22 - 18/10/2026 - buildBookingIndex refuses a file without the current
+//                       format header instead of indexing misread records.
+// Rev.21 - 18/10/2026 - booking.txt starts with a versioned header; files
+//                       without it are refused.
+// Rev.20 - 18/10/2026 - writeBooking checks for a duplicate under its tail lock.
+// Rev.19 - 18/10/2026 - compactBookingFile rolls back its moves if one fails.
+// Rev.18 - 18/10/2026 - deleteBookingsBySailingID rolls its transaction back
+//                       if a tombstone cannot be written.
+// Rev.17 - 17/10/2026 - Report totals and the compaction tombstone scan run as
+//                       parallel chunked scans.
+// Rev.16 - 17/10/2026 - Index keys are built from the plate stored in the record
+//                       and lookups compare it in place, without string copies.
+// Rev.15 - 17/10/2026 - Hash engine sailing loads go through hashStoreLoadSailing,
+//                       which matches keys with the scan kernel.
+// Rev.14 - 17/10/2026 - Indexes, posting lists and report totals are keyed on
+//                       the packed SailingKey instead of the SailingID text.
+// Rev.13 - 17/10/2026 - Appends, in-place writes and compaction hold exclusive
+//                       byte-range locks for other FerryQ processes.
+// Rev.12 - 17/10/2026 - Reads, writes, sizes and truncation go through a
+//                       PositionalFile (pread/pwrite) instead of the fstream.
+// Rev.11 - 17/10/2026 - Added markCheckedIn, which rewrites only the flag byte.
+// Rev.10 - 17/10/2026 - Each function also dispatches to BookingLsmStore;
+//                       added closeBookingStore.
+// Rev.9 - 17/10/2026 - Each function dispatches to BookingHashStore when the
+//                      hash engine is selected.
+// Rev.8 - 17/10/2026 - Added aggregateBookingsBySailing (one pass, hash aggregate).
+// Rev.7 - 17/10/2026 - Added per-sailing posting lists; counting, listing and
+//                      bulk-deleting a sailing's bookings cost O(k).
+// Rev.6 - 17/10/2026 - Deletes mark a tombstone in place; the file is compacted
+//                      once the dead fraction reaches the RecordStore threshold.
+// Rev.5 - 17/10/2026 - deleteBookingsBySailingID removes all of a sailing's
+//                      bookings with one scan and one truncate.
+// Rev.4 - 17/10/2026 - Writes and truncates are recorded in the write-ahead log.
+// Rev.3 - 17/10/2026 - Scans and point reads go through the mapped record store.
+// Rev.2 - 17/10/2026 - Added a hash index from (SailingID, License Plate) to
+//                      record index so point lookups no longer scan the file.
 // Rev.1 – 24/07/2025 – Implements low-level file I/O for Booking records.
 //
 // ----------------------------------------------------------------------------
@@ -11,29 +54,505 @@
 //   from the "booking.txt" binary file.
 //
 // Implementation Strategy:
-// - Data is stored as fixed-length binary records (using sizeof(Booking)).
-// - All lookups are performed using a linear search of the file.
-// - Deletion is handled with a "swap-and-truncate" method to maintain a
-//   compact, unordered data file.
+// - Data is stored as fixed-length binary records (using sizeof(Booking)),
+//   after a RecordFileHeader ("FQBK", bookingFileVersion). The first append
+//   to an empty file writes the header; a file with any other header (or
+//   none, as before version 1) is refused by checkBookingFileFormat.
+// - Reads use the RecordStore module: the file is mapped as a Booking array
+//   when possible, with positional reads as fallback. Writes, the record
+//   count and truncation use the module's PositionalFile, so the caller's
+//   fstream cursor is never moved.
+// - Lookups by (SailingID, License Plate) go through an in-memory hash index
+//   that maps the composite key to the record's position in the file. The
+//   index is built with one scan of the file and then kept up to date by
+//   writeBooking and deleteBookingRecord. If the file is changed outside this
+//   module (record count or header generation no longer matches) the index
+//   is rebuilt on next use.
+// - Both indexes key on the record's packed SailingKey (SailingKey.h), so a
+//   SailingID given by the caller is packed once and every comparison with
+//   a record is an integer compare.
+// - A second index maps each SailingKey to the positions of its bookings
+//   (a posting list). It is built and maintained alongside the key index,
+//   so a sailing's bookings are counted, listed or deleted in O(k).
+// - Every write and truncate is reported to the write-ahead log first.
+// - Other FerryQ processes may use the file at the same time. Appends hold
+//   an exclusive RecordLock on the tail, in-place writes one on their record
+//   and compaction one on the whole file; reads hold shared locks taken by
+//   RecordStore.
+// - Tombstones and compaction change records without always changing the
+//   record count, so after writing them a process bumps the generation in
+//   the file header (under an exclusive lock on the header, logged). The
+//   indexes, posting lists and tombstone count remember the generation they
+//   were built from, and every lookup or count checks it, so a delete made
+//   by another process is never answered from a stale index.
+// - Threads may call in at once. Writers, and rebuilds of the indexes, hold
+//   a recursive write lock for the whole operation, taken before any
+//   RecordLock, so a rebuild never lands between the steps of a write. The
+//   indexes and counts themselves are guarded by a second lock that is
+//   only held while they are read or changed, never across file I/O, so a
+//   lookup made beside a writer waits at most for one index update.
+// - Deletion sets the record's tombstone flag in place. Scans, the index
+//   and the counts skip tombstones. Once the dead fraction reaches the
+//   RecordStore compaction threshold, compactBookingFile fills the holes
+//   with live records from the end of the file and truncates once; moved
+//   records' index entries are updated.
+// - Whole-file aggregates (report totals, the tombstone scan of compaction)
+//   use RecordStore's parallelScanRecords: each worker thread totals its
+//   chunks of the file on its own and the partial results are added up.
+//
+// - With the hash or LSM engine selected every public function forwards to
+//   the BookingHashStore or BookingLsmStore module instead, which keeps the
+//   bookings in its own files.
 //
 // Used By: Called by the BookingUserIO.cpp module to persist booking data.
 // ----------------------------------------------------------------------------
 
 #include "BookingFileIO.h"
+#include "BookingHashStore.h"
+#include "BookingLsmStore.h"
+#include "RecordStore.h"
+#include "WriteAheadLog.h"
+#include <algorithm>
 #include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 using namespace std;
-extern "C" int truncate(const char* path, long long length);  //Needed on some systems for file truncation
 static const char* BOOKING_FILENAME = "booking.txt";  //Physical file name
 
+static const RecordFileHeader bookingFileHeader =
+    makeRecordFileHeader(bookingFileMagic, bookingFileVersion, sizeof(Booking));  //Start of the file
+static MappedRecordFile<Booking> bookingRecords(BOOKING_FILENAME, recordFileHeaderBytes);  //Mapped view of the file
+static PositionalFile bookingData(BOOKING_FILENAME, recordFileHeaderBytes);                //pread/pwrite access to the file
+static unordered_map<string, int> bookingIndex;  //Packed SailingKey + licensePlate -> record index
+static unordered_map<SailingKey, vector<int> > sailingPostings;  //SailingKey -> record indexes of its bookings
+static int indexedRecordCount = -1;              //Record count the index matches (-1 = not built)
+static int deadBookingCount = 0;                 //Tombstones among indexedRecordCount records
+static unsigned int indexedGeneration = 0;       //Header generation the index was built from
+static mutex bookingIndexLock;                   //Guards the five above; held only while they are used
+static recursive_mutex bookingWriteLock;         //Held by writes and rebuilds, before any RecordLock
+static BookingStoreEngine bookingStoreEngine = heapBookingStore;
+
+//----------------------------------------------------------------------------
+void setBookingStoreEngine(BookingStoreEngine engine){
+//Description: Selects the engine; the heap engine's indexes are dropped.
+    bookingStoreEngine = engine;
+    lock_guard<mutex> guard(bookingIndexLock);
+    indexedRecordCount = -1;
+}
+
+//----------------------------------------------------------------------------
+static void dropBookingIndex(){
+//Description: Marks the indexes stale so the next use rebuilds them.
+    lock_guard<mutex> guard(bookingIndexLock);
+    indexedRecordCount = -1;
+}
+
+//----------------------------------------------------------------------------
+BookingStoreEngine getBookingStoreEngine(){
+//Description: Returns the selected engine.
+    return bookingStoreEngine;
+}
+
+//----------------------------------------------------------------------------
+string getBookingFileName(){
+//Description: Returns the data file of the selected engine.
+    if (bookingStoreEngine == hashBookingStore) return fileNameBookingHash;
+    if (bookingStoreEngine == lsmBookingStore) return fileNameBookingLsm;
+    return BOOKING_FILENAME;
+}
+
+//----------------------------------------------------------------------------
+bool checkBookingFileFormat(){
+//Description: Under an exclusive lock on the header, gives an empty booking
+//             file its header (logged like a record write) or checks the
+//             one it has.
+    if (bookingStoreEngine != heapBookingStore) return true;
+    lock_guard<recursive_mutex> writer(bookingWriteLock);
+    RecordLock lock(bookingData, -recordFileHeaderBytes, recordFileHeaderBytes, true);
+    if (!lock.isHeld()) return false;
+    RecordFileState state = bookingData.checkHeader(bookingFileHeader);
+    if (state != recordFileEmpty) return state == recordFileCurrent;
+    logRecordWrite(BOOKING_FILENAME, 0, &bookingFileHeader, sizeof(bookingFileHeader));
+    return bookingData.writeHeader(bookingFileHeader);
+}
+
+//----------------------------------------------------------------------------
+bool claimBookingStore(){
+//Description: Claims the file of the hash or LSM engine; the heap file is
+//             shared through byte-range locks.
+    if (bookingStoreEngine == heapBookingStore) return true;
+    return claimDataFile(getBookingFileName());
+}
+
+//----------------------------------------------------------------------------
+static unsigned int readBookingGeneration(){
+//Description: Returns the generation in the file header (zero while the
+//             file has no header).
+    RecordFileHeader header;
+    return bookingData.readHeader(header) ? header.generation : 0;
+}
+
+//----------------------------------------------------------------------------
+static void bumpBookingGeneration(){
+//Description: Adds one to the generation in the file header, under an
+//             exclusive lock on the header and logged like a record write.
+//             Called once tombstones or moved records are in the file,
+//             with the write lock held. The index follows only if no other
+//             process bumped it since.
+    RecordLock lock(bookingData, -recordFileHeaderBytes, recordFileHeaderBytes, true);
+    RecordFileHeader header;
+    if (!lock.isHeld() || !bookingData.readHeader(header)){
+        dropBookingIndex();
+        return;
+    }
+    unsigned int before = header.generation;
+    ++header.generation;
+    logRecordWrite(BOOKING_FILENAME, 0, &header, sizeof(header));
+    if (!bookingData.writeHeader(header)){
+        dropBookingIndex();
+        return;
+    }
+    lock_guard<mutex> guard(bookingIndexLock);
+    if (indexedGeneration == before) indexedGeneration = header.generation;
+}
+
+//----------------------------------------------------------------------------
+static int countBookingSlots(fstream& bookingFile){
+//Description: Returns the number of record slots in the file, tombstones
+//             included.
+    if (!bookingFile.is_open()) return 0;
+
+    long long bytes = bookingData.size();
+    return bytes < 0 ? 0 : static_cast<int>(bytes / static_cast<long long>(sizeof(Booking)));
+}
+
+//----------------------------------------------------------------------------
+static string bookingKey(SailingKey sailing, const char* licensePlate){
+//Description: Builds the composite hash key: the four bytes of the packed
+//             SailingKey followed by the plate. The key has a fixed width,
+//             so no separator is needed.
+    string key(reinterpret_cast<const char*>(&sailing), sizeof(sailing));
+    return key += licensePlate;
+}
+
+//----------------------------------------------------------------------------
+static void addPosting(SailingKey sailing, int index){
+//Description: Adds a record index to the sailing's posting list. The
+//             caller holds bookingIndexLock.
+    sailingPostings[sailing].push_back(index);
+}
+
+//----------------------------------------------------------------------------
+static void movePosting(SailingKey sailing, int from, int to){
+//Description: Replaces one record index in the sailing's posting list
+//             with another, or removes it when to is -1. Order within a
+//             list is not kept. The caller holds bookingIndexLock.
+    unordered_map<SailingKey, vector<int> >::iterator it = sailingPostings.find(sailing);
+    if (it == sailingPostings.end()) return;
+    vector<int>& list = it->second;
+    for (size_t i = 0; i < list.size(); ++i){
+        if (list[i] != from) continue;
+        if (to >= 0){
+            list[i] = to;
+        } else{
+            list[i] = list.back();
+            list.pop_back();
+            if (list.empty()) sailingPostings.erase(it);
+        }
+        return;
+    }
+}
+
+//----------------------------------------------------------------------------
+static bool readBookingAt(int index, Booking& result){
+//Description: Reads the Booking record at the given zero-based index.
+    return readRecordAt(bookingData, bookingRecords, index, result);
+}
+
+//----------------------------------------------------------------------------
+static bool isBookingIndexCurrent(fstream& bookingFile){
+//Description: Returns whether the index matches the file's record count
+//             and header generation.
+    int slots = countBookingSlots(bookingFile);
+    unsigned int generation = readBookingGeneration();
+    lock_guard<mutex> guard(bookingIndexLock);
+    return indexedRecordCount >= 0 && indexedRecordCount == slots && indexedGeneration == generation;
+}
+
+//----------------------------------------------------------------------------
+static bool ensureBookingIndex(fstream& bookingFile){
+//Description: Rebuilds the index if it has not been built yet or if the
+//             file no longer has the number of records or the generation
+//             it was built from. The check is repeated under the write
+//             lock, as another thread may have rebuilt it meanwhile.
+    if (isBookingIndexCurrent(bookingFile)) return true;
+    lock_guard<recursive_mutex> writer(bookingWriteLock);
+    if (isBookingIndexCurrent(bookingFile)) return true;
+    return buildBookingIndex(bookingFile);
+}
+
+//----------------------------------------------------------------------------
+static int findBookingIndex(SailingKey sailing, const string& licensePlate,
+                            Booking& result, fstream& bookingFile){
+//Description: Returns the record index of the matching booking (loading it
+//             into result), or -1 if not found. The record at the indexed
+//             position is re-checked so a stale index is rebuilt, not trusted.
+//             The record is read with the index lock released.
+    string key = bookingKey(sailing, licensePlate.c_str());
+    for (int attempt = 0; attempt < 2; ++attempt){
+        if (!ensureBookingIndex(bookingFile)) return -1;
+        int index;
+        {
+            lock_guard<mutex> guard(bookingIndexLock);
+            unordered_map<string, int>::const_iterator it = bookingIndex.find(key);
+            if (it == bookingIndex.end()) return -1;
+            index = it->second;
+        }
+        if (readBookingAt(index, result) && !result.isDeleted() && result.hasKey(sailing, licensePlate)){
+            return index;
+        }
+
+        //Index out of step with the file; rebuild (unless another thread has) and retry once
+        lock_guard<mutex> guard(bookingIndexLock);
+        unordered_map<string, int>::const_iterator it = bookingIndex.find(key);
+        if (it != bookingIndex.end() && it->second == index) indexedRecordCount = -1;
+    }
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+bool buildBookingIndex(fstream& bookingFile){
+//Description: Rebuilds the (SailingID, License Plate) hash index with a
+//             single sequential pass over the booking file, counting the
+//             tombstones it skips. The generation is read before the scan,
+//             so a bump racing the scan triggers another rebuild. The scan
+//             fills new tables under the write lock, which are swapped in.
+    if (bookingStoreEngine == hashBookingStore) return openBookingHashStore(bookingFile);
+    if (bookingStoreEngine == lsmBookingStore) return openBookingLsmStore(bookingFile);
+    lock_guard<recursive_mutex> writer(bookingWriteLock);
+    dropBookingIndex();
+    if (!bookingFile.is_open() || !checkBookingFileFormat()) return false;
+
+    unsigned int generation = readBookingGeneration();
+    unordered_map<string, int> index;
+    unordered_map<SailingKey, vector<int> > postings;
+    int count = 0;
+    int dead = 0;
+    scanRecords(bookingData, bookingRecords, [&](const Booking& temp, int at){
+        if (temp.isDeleted()){
+            ++dead;
+        } else{
+            index[bookingKey(temp.getSailingKey(), temp.getLicensePlateChars())] = at;
+            postings[temp.getSailingKey()].push_back(at);
+        }
+        count = at + 1;
+        return true;
+    });
+    lock_guard<mutex> guard(bookingIndexLock);
+    bookingIndex.swap(index);
+    sailingPostings.swap(postings);
+    indexedRecordCount = count;
+    deadBookingCount = dead;
+    indexedGeneration = generation;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+void closeBookingStore(fstream& bookingFile){
+//Description: Lets the LSM engine flush its memtable and join its merge
+//             thread; the other engines write everything in place.
+    if (bookingStoreEngine == lsmBookingStore) closeBookingLsmStore(bookingFile);
+}
+
 //----------------------------------------------------------------------------
 bool writeBooking(const Booking& booking, fstream& bookingFile){
-    //Description: Appends a Booking record to the end of the file.
-    bookingFile.clear();
-    bookingFile.seekp(0, ios::end);  //Go to end of file
-    bookingFile.write(reinterpret_cast<const char*>(&booking), sizeof(Booking));
-    bookingFile.flush();
-    return bookingFile.good();
+    //Description: Appends a Booking record to the end of the file and
+    //             records its position in the index. The duplicate check
+    //             runs under the tail lock, so no other process can append
+    //             the same key between the check and the write.
+    if (bookingStoreEngine == hashBookingStore) return hashStorePut(bookingFile, booking);
+    if (bookingStoreEngine == lsmBookingStore) return lsmStorePut(bookingFile, booking);
+    lock_guard<recursive_mutex> writer(bookingWriteLock);
+    if (bookingData.size() == 0 && !checkBookingFileFormat()) return false;  //The first record brings the header
+    RecordLock tail(bookingData, bookingData.size(), toEndOfFile, true);  //Appends take turns at the tail
+    if (!tail.isHeld()) return false;
+    Booking existing;
+    if (findBookingIndex(booking.getSailingKey(), booking.getLicensePlate(), existing, bookingFile) >= 0){
+        return false;  //Already booked, perhaps by another process
+    }
+    long long end = bookingData.size();  //Append at the end of file
+    if (end >= 0) logRecordWrite(BOOKING_FILENAME, bookingData.fileOffset(end), &booking, sizeof(Booking));
+    if (end < 0 || !bookingData.writeAt(end, &booking, sizeof(Booking))){
+        dropBookingIndex();
+        return false;
+    }
+    lock_guard<mutex> guard(bookingIndexLock);
+    int position = static_cast<int>(end / static_cast<long long>(sizeof(Booking)));
+    if (indexedRecordCount == position){
+        bookingIndex[bookingKey(booking.getSailingKey(), booking.getLicensePlateChars())] = position;
+        addPosting(booking.getSailingKey(), position);
+        ++indexedRecordCount;
+    } else{
+        indexedRecordCount = -1;  //Rebuilt lazily on next lookup
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool writeBookingAt(int index, const Booking& booking){
+//Description: Overwrites the record at the given index (logged first).
+    long long offset = static_cast<long long>(index) * static_cast<long long>(sizeof(Booking));
+    RecordLock lock(bookingData, offset, static_cast<long long>(sizeof(Booking)), true);
+    if (!lock.isHeld()) return false;
+    logRecordWrite(BOOKING_FILENAME, bookingData.fileOffset(offset), &booking, sizeof(Booking));
+    return bookingData.writeAt(offset, &booking, sizeof(Booking));
+}
+
+//----------------------------------------------------------------------------
+static bool truncateBookingFile(int records){
+//Description: Cuts the file down to the given number of records.
+    long long newSize = static_cast<long long>(records) * static_cast<long long>(sizeof(Booking));
+    RecordLock lock(bookingData, 0, toEndOfFile, true);
+    if (!lock.isHeld()){
+        dropBookingIndex();
+        return false;
+    }
+    logFileTruncate(BOOKING_FILENAME, bookingData.fileOffset(newSize));
+    if (!bookingData.resize(newSize)){
+        dropBookingIndex();
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool tombstoneBookingAt(int index, Booking record){
+//Description: Marks the record at the given index as deleted in place.
+    record.setDeleted(true);
+    return writeBookingAt(index, record);
+}
+
+//----------------------------------------------------------------------------
+bool compactBookingFile(fstream& bookingFile){
+    //Description: Reclaims the space held by tombstones. Each tombstone
+    //             below the new end of file is filled with a live record
+    //             taken from the tail, then the file is truncated once.
+    //             If a step fails, the moves are rolled back and the file
+    //             is left as it was; otherwise the generation is bumped.
+    //             The index is checked and the tombstones counted under
+    //             the whole-file lock, so no other process can append or
+    //             delete in between.
+    if (bookingStoreEngine == hashBookingStore) return hashStoreRehash(bookingFile, hashStoreBucketCount(bookingFile));
+    if (bookingStoreEngine == lsmBookingStore) return lsmStoreCompact(bookingFile);
+    if (!bookingFile.is_open()) return false;
+    lock_guard<recursive_mutex> writer(bookingWriteLock);
+    RecordLock lock(bookingData, 0, toEndOfFile, true);  //Covers the check, the scan, the moves and the truncate
+    if (!lock.isHeld() || !ensureBookingIndex(bookingFile)) return false;
+
+    vector<int> dead;  //Tombstone indexes, ascending
+    int total = parallelScanRecords(bookingData, bookingRecords, dead,
+        [](vector<int>& partial, const Booking& temp, int index){
+            if (temp.isDeleted()) partial.push_back(index);
+        },
+        [](vector<int>& all, const vector<int>& partial){
+            all.insert(all.end(), partial.begin(), partial.end());
+        });
+    sort(dead.begin(), dead.end());  //Workers finish their chunks in any order
+    bool counted;
+    {
+        lock_guard<mutex> guard(bookingIndexLock);
+        counted = total == indexedRecordCount && static_cast<int>(dead.size()) == deadBookingCount;
+    }
+    if (!counted){
+        //Another process tombstoned a record and has not bumped the generation yet
+        if (!buildBookingIndex(bookingFile)) return false;
+        lock_guard<mutex> guard(bookingIndexLock);
+        if (indexedRecordCount != total) return false;
+    }
+    if (dead.empty()) return true;
+    int newTotal = total - static_cast<int>(dead.size());
+    bool indexFollowed = true;  //Every moved record was indexed at its source
+    beginWalTransaction();
+
+    //Fill holes below newTotal with live records taken from the end
+    size_t hole = 0;
+    size_t tailDead = dead.size();  //Tombstones at or after source are skipped
+    int source = total - 1;
+    while (hole < dead.size() && dead[hole] < newTotal){
+        while (tailDead > 0 && dead[tailDead - 1] == source){
+            --tailDead;
+            --source;
+        }
+        Booking moved;
+        if (!readBookingAt(source, moved) || !writeBookingAt(dead[hole], moved)){
+            abortWalTransaction();  //Puts back the records moved so far
+            dropBookingIndex();
+            return false;
+        }
+        {
+            lock_guard<mutex> guard(bookingIndexLock);
+            int& entry = bookingIndex[bookingKey(moved.getSailingKey(), moved.getLicensePlateChars())];
+            if (entry != source) indexFollowed = false;
+            entry = dead[hole];
+            movePosting(moved.getSailingKey(), source, dead[hole]);
+        }
+        --source;
+        ++hole;
+    }
+
+    if (!truncateBookingFile(newTotal)){
+        abortWalTransaction();
+        dropBookingIndex();
+        return false;
+    }
+    {
+        lock_guard<mutex> guard(bookingIndexLock);
+        indexedRecordCount = indexFollowed ? newTotal : -1;
+        deadBookingCount = 0;
+    }
+    bumpBookingGeneration();
+    commitWalTransaction();
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool compactBookingsIfDue(fstream& bookingFile){
+//Description: Compacts the file once enough of it is tombstones.
+    bool due;
+    {
+        lock_guard<mutex> guard(bookingIndexLock);
+        due = isCompactionDue(deadBookingCount, indexedRecordCount);
+    }
+    return !due || compactBookingFile(bookingFile);
+}
+
+//----------------------------------------------------------------------------
+bool markCheckedIn(const string& sailingID, const string& licensePlate, fstream& bookingFile){
+    //Description: Finds the record through the index and overwrites its
+    //             checkedIn byte in place; the index stays valid.
+    if (bookingStoreEngine == hashBookingStore) return hashStoreMarkCheckedIn(bookingFile, sailingID, licensePlate);
+    if (bookingStoreEngine == lsmBookingStore){
+        //Runs are immutable; the newer copy shadows the old one
+        Booking record;
+        if (!lsmStoreFind(bookingFile, sailingID, licensePlate, record)) return false;
+        record.setCheckedIn(true);
+        return lsmStorePut(bookingFile, record);
+    }
+    if (!bookingFile.is_open()) return false;
+
+    lock_guard<recursive_mutex> writer(bookingWriteLock);
+    Booking target;
+    int index = findBookingIndex(packSailingKey(sailingID), licensePlate, target, bookingFile);
+    if (index < 0) return false;
+    const bool flag = true;
+    long long record = static_cast<long long>(index) * static_cast<long long>(sizeof(Booking));
+    long long offset = record + static_cast<long long>(Booking::checkedInOffset());
+    RecordLock lock(bookingData, record, static_cast<long long>(sizeof(Booking)), true);
+    if (!lock.isHeld()) return false;
+    logRecordWrite(BOOKING_FILENAME, bookingData.fileOffset(offset), &flag, sizeof(flag));
+    return bookingData.writeAt(offset, &flag, sizeof(flag));
 }
 
 //----------------------------------------------------------------------------
@@ -41,80 +560,124 @@ bool deleteBookingRecord(const string& sailingID,
                          const string& licensePlate,
                          fstream& bookingFile){
     //Description: Deletes a Booking record by matching sailing ID and license plate.
-    //             Replaces the target with the last record and truncates the file.
-
-    if (!bookingFile.good()) return false;
-    //Compute total records
-    bookingFile.clear();
-    bookingFile.seekg(0, ios::end);
-    int total = static_cast<int>(bookingFile.tellg() / sizeof(Booking));
-    if (total <= 0) return false;
-    //Find target index
-    bookingFile.clear();
-    bookingFile.seekg(0, ios::beg);
-    Booking temp;
-    int targetIndex = -1;
-    for (int i = 0; i < total; ++i){
-        bookingFile.read(reinterpret_cast<char*>(&temp), sizeof(Booking));
-        if (temp.getSailingID() == sailingID && temp.getLicensePlate() == licensePlate){
-            targetIndex = i;
-            break;
-        }
-    }
+    //             The target is located through the index and marked as a
+    //             tombstone in place and the generation bumped; the file is
+    //             compacted if that pushes the dead fraction over the threshold.
+    if (bookingStoreEngine == hashBookingStore) return hashStoreErase(bookingFile, sailingID, licensePlate);
+    if (bookingStoreEngine == lsmBookingStore) return lsmStoreErase(bookingFile, sailingID, licensePlate);
+
+    if (!bookingFile.is_open()) return false;
+    lock_guard<recursive_mutex> writer(bookingWriteLock);
+    SailingKey sailing = packSailingKey(sailingID);
+    Booking target;
+    int targetIndex = findBookingIndex(sailing, licensePlate, target, bookingFile);
     if (targetIndex < 0) return false;
-    int lastIndex = total - 1;
-    //Overwrite if not last
-    if (targetIndex != lastIndex){
-        bookingFile.clear();
-        bookingFile.seekg(static_cast<streampos>(lastIndex) * sizeof(Booking), ios::beg);
-        Booking lastRec;
-        bookingFile.read(reinterpret_cast<char*>(&lastRec), sizeof(Booking));
-        bookingFile.clear();
-        bookingFile.seekp(static_cast<streampos>(targetIndex) * sizeof(Booking), ios::beg);
-        bookingFile.write(reinterpret_cast<const char*>(&lastRec), sizeof(Booking));
-        bookingFile.flush();
-    }
-    //Truncate file
-    bookingFile.close();
-    long newSize = static_cast<long>(lastIndex) * static_cast<long>(sizeof(Booking));
-    if (truncate(BOOKING_FILENAME, newSize) != 0){
+    if (!tombstoneBookingAt(targetIndex, target)){
+        dropBookingIndex();
         return false;
     }
-    //Reopen file for further operations
-    bookingFile.open(BOOKING_FILENAME, ios::in | ios::out | ios::binary);
-    return bookingFile.is_open();
+    {
+        lock_guard<mutex> guard(bookingIndexLock);
+        bookingIndex.erase(bookingKey(sailing, licensePlate.c_str()));
+        movePosting(sailing, targetIndex, -1);
+        ++deadBookingCount;
+    }
+    bumpBookingGeneration();
+    compactBookingsIfDue(bookingFile);  //The delete stands even if compaction fails
+    return true;
 }
 
 //----------------------------------------------------------------------------
+static bool collectSailingBookings(SailingKey sailing, fstream& bookingFile,
+                                   vector<int>& indexes, vector<Booking>& records){
+//Description: Reads the sailing's bookings through its posting list, in
+//             file order. Each record is checked against the list so a
+//             stale index is rebuilt and the read retried once.
+    for (int attempt = 0; attempt < 2; ++attempt){
+        indexes.clear();
+        records.clear();
+        if (!ensureBookingIndex(bookingFile)) return false;
+        {
+            lock_guard<mutex> guard(bookingIndexLock);
+            unordered_map<SailingKey, vector<int> >::const_iterator it = sailingPostings.find(sailing);
+            if (it == sailingPostings.end()) return true;
+            indexes = it->second;
+        }
+        sort(indexes.begin(), indexes.end());
+        bool consistent = true;
+        for (size_t i = 0; i < indexes.size() && consistent; ++i){
+            Booking temp;
+            consistent = readBookingAt(indexes[i], temp) && !temp.isDeleted() &&
+                         temp.getSailingKey() == sailing;
+            records.push_back(temp);
+        }
+        if (consistent) return true;
+        dropBookingIndex();  //Index out of step with the file; rebuild and retry once
+    }
+    indexes.clear();
+    records.clear();
+    return false;
+}
 
-bool deleteBookingsBySailingID(fstream& bookingFile, const string& sailingID) {
-    if (!bookingFile.good()) return false;
-
-    bool deletedAtLeastOne = false;
-    bool deletedThisPass;
+//----------------------------------------------------------------------------
+int deleteBookingsBySailingID(fstream& bookingFile, const string& sailingID){
+    //Description: Removes every booking on a sailing. The k bookings are
+    //             found through the sailing's posting list and each is
+    //             tombstoned in place, all in one transaction that is
+    //             rolled back if any of them fails; the generation is bumped
+    //             either way, as other processes may have indexed some of
+    //             the tombstones. Returns the number removed.
+    if (bookingStoreEngine == hashBookingStore) return hashStoreEraseSailing(bookingFile, sailingID);
+    if (bookingStoreEngine == lsmBookingStore) return lsmStoreEraseSailing(bookingFile, sailingID);
+    if (!bookingFile.is_open()) return 0;
 
-    do {
-        deletedThisPass = false;
-        bookingFile.clear();
-        bookingFile.seekg(0, ios::beg);
+    lock_guard<recursive_mutex> writer(bookingWriteLock);
+    SailingKey sailing = packSailingKey(sailingID);
+    vector<int> matches;        //Indexes of the sailing's bookings, ascending
+    vector<Booking> records;    //Their contents, to write back as tombstones
+    if (!collectSailingBookings(sailing, bookingFile, matches, records) || matches.empty()) return 0;
 
-        Booking temp;
-        while (bookingFile.read(reinterpret_cast<char*>(&temp), sizeof(Booking))) {
-            if (temp.getSailingID() == sailingID) {
-                // Delete this booking (license plate needed for deleteBookingRecord)
-                if (deleteBookingRecord(sailingID, temp.getLicensePlate(), bookingFile)) {
-                    deletedAtLeastOne = true;
-                    deletedThisPass = true;
-                    break; // restart loop because file changed
-                }
-            }
+    beginWalTransaction();
+    for (size_t i = 0; i < matches.size(); ++i){
+        if (!tombstoneBookingAt(matches[i], records[i])){
+            abortWalTransaction();  //All of the sailing's bookings stay
+            dropBookingIndex();
+            bumpBookingGeneration();
+            return 0;
         }
-    } while (deletedThisPass);
-
-    return deletedAtLeastOne;
+        lock_guard<mutex> guard(bookingIndexLock);
+        bookingIndex.erase(bookingKey(sailing, records[i].getLicensePlateChars()));
+        ++deadBookingCount;
+    }
+    {
+        lock_guard<mutex> guard(bookingIndexLock);
+        sailingPostings.erase(sailing);
+    }
+    bumpBookingGeneration();
+    compactBookingsIfDue(bookingFile);
+    commitWalTransaction();
+    return static_cast<int>(matches.size());
 }
 
-
+//----------------------------------------------------------------------------
+bool loadBookingsForSailing(const string& sailingID, vector<Booking>& result, fstream& bookingFile){
+    //Description: Loads every live booking on a sailing into result, in
+    //             file order, through the sailing's posting list.
+    result.clear();
+    if (!bookingFile.is_open()) return false;
+    SailingKey sailing = packSailingKey(sailingID);
+    if (bookingStoreEngine == hashBookingStore) return hashStoreLoadSailing(bookingFile, sailingID, result);
+    if (bookingStoreEngine == lsmBookingStore){
+        //Keys sort by SailingID, so the sailing's bookings are consecutive
+        if (!lsmStoreReady(bookingFile)) return false;
+        LsmMergeCursor cursor(sailingID);
+        Booking temp;
+        while (cursor.next(temp) && temp.getSailingKey() == sailing) result.push_back(temp);
+        return true;
+    }
+    vector<int> indexes;
+    return collectSailingBookings(sailing, bookingFile, indexes, result);
+}
 
 //----------------------------------------------------------------------------
 bool loadBookingByKey(const string& sailingID,
@@ -122,47 +685,74 @@ bool loadBookingByKey(const string& sailingID,
                       Booking& result,
                       fstream& bookingFile){
     //Description: Loads a booking by sailing ID and license plate into result.
-    //             Returns true if found.
-    if (!bookingFile.good()) return false;
-
-    bookingFile.clear();
-    bookingFile.seekg(0, ios::beg);
-    Booking temp;
-
-    //Linear search for matching booking
-    while (bookingFile.read(reinterpret_cast<char*>(&temp), sizeof(Booking))){
-        if (temp.getSailingID() == sailingID && temp.getLicensePlate() == licensePlate){
-            result = temp;
-            return true;
-        }
-    }
-    return false;
+    //             Returns true if found. Uses the hash index, so the cost is
+    //             one positional read regardless of file size.
+    if (bookingStoreEngine == hashBookingStore) return hashStoreFind(bookingFile, sailingID, licensePlate, result);
+    if (bookingStoreEngine == lsmBookingStore) return lsmStoreFind(bookingFile, sailingID, licensePlate, result);
+    if (!bookingFile.is_open()) return false;
+    return findBookingIndex(packSailingKey(sailingID), licensePlate, result, bookingFile) >= 0;
 }
 
 //----------------------------------------------------------------------------
 int countBookingRecords(fstream& bookingFile){
-    //Description: Returns the number of Booking records in the file.
-    if (!bookingFile.good()) return 0;
-
-    bookingFile.clear();
-    bookingFile.seekg(0, ios::end);
-    return static_cast<int>(bookingFile.tellg() / sizeof(Booking));
+    //Description: Returns the number of live Booking records in the file
+    //             (record slots minus tombstones).
+    if (bookingStoreEngine == hashBookingStore) return hashStoreCount(bookingFile);
+    if (bookingStoreEngine == lsmBookingStore) return lsmStoreCount(bookingFile);
+    if (!bookingFile.is_open() || !ensureBookingIndex(bookingFile)) return 0;
+    lock_guard<mutex> guard(bookingIndexLock);
+    return indexedRecordCount - deadBookingCount;
 }
 
 //----------------------------------------------------------------------------
 int countBookingsForSailing(const string& sailingID, fstream& bookingFile) {
-    //Description: Counts the number of bookings for a specific sailing.
-    if (!bookingFile.good()) return 0;
+    //Description: Counts the number of bookings for a specific sailing by
+    //             reading the length of its posting list.
+    if (bookingStoreEngine == hashBookingStore) return hashStoreCountSailing(bookingFile, sailingID);
+    if (bookingStoreEngine == lsmBookingStore) return lsmStoreCountSailing(bookingFile, sailingID);
+    if (!bookingFile.is_open() || !ensureBookingIndex(bookingFile)) return 0;
 
-    bookingFile.clear();
-    bookingFile.seekg(0, ios::beg);
-    Booking temp;
-    int count = 0;
+    lock_guard<mutex> guard(bookingIndexLock);
+    unordered_map<SailingKey, vector<int> >::const_iterator it = sailingPostings.find(packSailingKey(sailingID));
+    return it == sailingPostings.end() ? 0 : static_cast<int>(it->second.size());
+}
 
-    while (bookingFile.read(reinterpret_cast<char*>(&temp), sizeof(Booking))) {
-        if (temp.getSailingID() == sailingID) {
-            count++;
-        }
+//----------------------------------------------------------------------------
+bool aggregateBookingsBySailing(fstream& bookingFile, unordered_map<SailingKey, SailingBookingTotals>& totals){
+    //Description: Builds per-sailing vehicle and check-in totals in a hash
+    //             table with a single pass over the file, split over the
+    //             scan worker threads for the heap file.
+    totals.clear();
+    if (!bookingFile.is_open()) return false;
+
+    auto addBooking = [&](const Booking& temp){
+        SailingBookingTotals& entry = totals[temp.getSailingKey()];
+        ++entry.vehicles;
+        if (temp.getCheckedIn()) ++entry.checkedIn;
+        return true;
+    };
+    if (bookingStoreEngine == hashBookingStore){
+        hashStoreScan(bookingFile, addBooking);
+        return true;
+    }
+    if (bookingStoreEngine == lsmBookingStore){
+        lsmStoreScan(bookingFile, addBooking);
+        return true;
     }
-    return count;
-}
\ No newline at end of file
+    typedef unordered_map<SailingKey, SailingBookingTotals> SailingTotals;
+    parallelScanRecords(bookingData, bookingRecords, totals,
+        [](SailingTotals& partial, const Booking& temp, int){
+            if (temp.isDeleted()) return;
+            SailingBookingTotals& entry = partial[temp.getSailingKey()];
+            ++entry.vehicles;
+            if (temp.getCheckedIn()) ++entry.checkedIn;
+        },
+        [](SailingTotals& all, const SailingTotals& partial){
+            for (SailingTotals::const_iterator it = partial.begin(); it != partial.end(); ++it){
+                SailingBookingTotals& entry = all[it->first];
+                entry.vehicles += it->second.vehicles;
+                entry.checkedIn += it->second.checkedIn;
+            }
+        });
+    return true;
+}
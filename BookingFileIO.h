@@ -1,13 +1,41 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: BookingFileIO.h
+// Rev.18 - 18/10/2026 - Added claimBookingStore.
+// Rev.17 - 18/10/2026 - Counts and lookups see deletes made by other processes.
+// Rev.16 - 18/10/2026 - buildBookingIndex refuses files of an older layout.
+// Rev.15 - 18/10/2026 - Added the booking.txt format header and
+//                       checkBookingFileFormat.
+// Rev.14 - 18/10/2026 - writeBooking refuses a duplicate key under the tail lock.
+// Rev.13 - 18/10/2026 - A failed compaction leaves the file unchanged.
+// Rev.12 - 18/10/2026 - deleteBookingsBySailingID removes all or none.
+// Rev.11 - 17/10/2026 - aggregateBookingsBySailing spreads the heap file over
+//                       the scan worker threads.
+// Rev.10 - 17/10/2026 - aggregateBookingsBySailing totals by packed SailingKey.
+// Rev.9 - 17/10/2026 - Added markCheckedIn (one-byte in-place update).
+// Rev.8 - 17/10/2026 - Added the LSM engine of BookingLsmStore and
+//                      closeBookingStore.
+// Rev.7 - 17/10/2026 - Added a selectable storage engine: the heap file or the
+//                      on-disk hash table of BookingHashStore.
+// Rev.6 - 17/10/2026 - Added aggregateBookingsBySailing for the report engine.
+// Rev.5 - 17/10/2026 - Added loadBookingsForSailing; per-sailing counts and
+//                      listings go through a posting list.
+// Rev.4 - 17/10/2026 - Deletes leave tombstones; added compactBookingFile.
+// Rev.3 - 17/10/2026 - deleteBookingsBySailingID returns the number removed.
+// Rev.2 - 17/10/2026 - Added buildBookingIndex for the (SailingID, Plate) hash index.
 // Rev.1 – 24/07/2025 – Interface for low-level Booking file I/O operations.
 //
 // ----------------------------------------------------------------------------
 // This header declares the low-level functions for direct, binary file
 // manipulation of Booking records. It serves as the data persistence layer
 // for bookings, abstracting away the specifics of file access patterns like
-// linear searching and the swap-and-truncate deletion method.
+// the key index, tombstone deletes and compaction.
+//
+// Three storage engines sit behind the same functions: the heap file
+// (booking.txt, unordered records plus in-memory indexes), the hash store
+// (booking.hash, see BookingHashStore.h) and the LSM store (booking.lsm,
+// see BookingLsmStore.h). The caller opens the file named by
+// getBookingFileName() for the selected engine.
 //
 // All operations assume the file stream is opened and managed by a
 // higher-level module.
@@ -19,32 +47,137 @@
 #include "BookingUserIO.h"
 #include <fstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 using namespace std;
 
+const char bookingFileMagic[] = "FQBK";     //First bytes of booking.txt
+const unsigned int bookingFileVersion = 1;  //Layout of the 40-byte Booking, in the files
+                                            //of every engine (before 1: no header)
+
+//Primary storage engine behind the functions in this header
+enum BookingStoreEngine{
+    heapBookingStore,  //booking.txt: unordered records, in-memory indexes (default)
+    hashBookingStore,  //booking.hash: on-disk open-addressing hash table
+    lsmBookingStore    //booking.lsm: memtable and sorted runs, for write bursts
+};
+
+//Per-sailing totals produced by aggregateBookingsBySailing
+struct SailingBookingTotals{
+    SailingBookingTotals() : vehicles(0), checkedIn(0){}
+    int vehicles;   //Live bookings on the sailing
+    int checkedIn;  //Of those, how many have checked in
+};
+
+//----------------------------------------------------------------------------
+void setBookingStoreEngine(BookingStoreEngine engine);
+//Job: Selects the storage engine used by every function below.
+//Usage: Called at startup, before the booking file is opened.
+//Restrictions: The engines use different files and formats; switching does
+//              not convert existing bookings.
+
+//----------------------------------------------------------------------------
+BookingStoreEngine getBookingStoreEngine();
+//Job: Returns the selected storage engine.
+//Usage: Used to dispatch each booking file operation.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+string getBookingFileName();
+//Job: Returns the name of the data file used by the selected engine.
+//Usage: Used by main to open the booking file.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+bool checkBookingFileFormat();
+//Job: Writes the format header into an empty booking.txt, or checks that
+//     the file has the header of this version.
+//Usage: Called by main before the file is used; the first append also
+//       calls it.
+//Restrictions: Returns false for a file written by an older FerryQ (or
+//              not a booking file), which must not be read or written.
+//              True with the hash or LSM engine, whose files are checked
+//              when they are opened.
+
+//----------------------------------------------------------------------------
+bool claimBookingStore();
+//Job: Claims the hash or LSM engine's file for this process.
+//Usage: Called by main before the store is opened, to refuse a second
+//       process with a clear message; opening the store claims it too.
+//Restrictions: Returns false while another process holds the file. These
+//              engines keep their layout and counts in memory and serve
+//              one process at a time. Always true for the heap engine,
+//              which locks byte ranges instead.
+
+//----------------------------------------------------------------------------
+bool buildBookingIndex(fstream& bookingFile);
+//Job: Builds the hash index from (SailingID, License Plate) to record position
+//     (heap engine), or opens and checks the store (hash and LSM engines).
+//Usage: Called once at startup. Lookups rebuild it automatically if the file
+//       was changed without going through this module.
+//Restrictions: File must be opened in binary read mode. Returns false,
+//              indexing nothing, for a file of an older record layout.
+
+//----------------------------------------------------------------------------
+void closeBookingStore(fstream& bookingFile);
+//Job: Finishes background work of the selected engine before the file is closed.
+//Usage: Called once by main on shutdown.
+//Restrictions: Only the LSM engine has work to finish; for the others it
+//              does nothing.
+
 //----------------------------------------------------------------------------
 bool writeBooking(const Booking& booking, fstream& bookingFile);
 //Job: Appends a Booking record to the end of the binary booking file.
 //Usage: Called when a new booking is created.
-//Restrictions: File must be opened in binary write mode.
+//Restrictions: File must be opened in binary write mode. Returns false if
+//              the vehicle is already booked on the sailing; the check and
+//              the append happen under one lock, so two processes cannot
+//              both add the same booking.
+
+//----------------------------------------------------------------------------
+bool markCheckedIn(const string& sailingID, const string& licensePlate, fstream& bookingFile);
+//Job: Sets the checked-in flag of a booking without moving the record.
+//Usage: Called by the check-in workflow.
+//       One index lookup and a one-byte write at the flag's offset, so the
+//       cost does not depend on the size of the file.
+//Restrictions: File must be opened in binary read/write mode. Returns false
+//              if the booking is not found.
 
 //----------------------------------------------------------------------------
 bool deleteBookingRecord(const string& sailingID, const string& licensePlate, fstream& bookingFile);
-//Job: Deletes a Booking matching the given SailingID and License Plate by replacing it with the last record and truncating the file.
+//Job: Deletes a Booking matching the given SailingID and License Plate by marking it as a tombstone in place.
 //Usage: Called by check-in or booking cancellation workflows.
 //Restrictions: File must be opened in binary read/write mode.
 
+//----------------------------------------------------------------------------
+int deleteBookingsBySailingID(fstream& bookingFile, const string& sailingID);
+//Job: Deletes every Booking on the given sailing, found through its
+//     posting list, marking each as a tombstone in place.
+//Usage: Called when a sailing is deleted.
+//Restrictions: File must be opened in binary read/write mode. Returns the
+//              number of bookings removed; 0 if any of them could not be
+//              removed, in which case none is.
 
-bool deleteBookingsBySailingID(fstream& bookingFile, const string& sailingID);//COMMENT THIS SHI
+//----------------------------------------------------------------------------
+bool compactBookingFile(fstream& bookingFile);
+//Job: Removes all tombstones by moving live records from the end of the
+//     file into their slots and truncating once.
+//Usage: Called automatically when the dead fraction reaches the RecordStore
+//       compaction threshold; may also be called directly (e.g. at shutdown).
+//Restrictions: File must be opened in binary read/write mode. Record
+//              positions change; the index is updated to match. On failure
+//              the file is left as it was.
 
 //----------------------------------------------------------------------------
 bool loadBookingByKey(const string& sailingID, const string& licensePlate, Booking& result, fstream& bookingFile);
-//Job: Searches for and loads a Booking record by SailingID and License Plate.
+//Job: Looks up and loads a Booking record by SailingID and License Plate.
 //Usage: Used to check if a booking exists or to retrieve its data.
+//       Constant time through the hash index.
 //Restrictions: File must be opened in binary read mode. Returns false if not found.
 
 //----------------------------------------------------------------------------
 int countBookingRecords(fstream& bookingFile);
-//Job: Returns the total number of Booking records in the binary file.
+//Job: Returns the number of live (non-deleted) Booking records in the binary file.
 //Usage: Used for iteration, reporting, or validation.
 //Restrictions: File must be opened in binary mode.
 
@@ -52,7 +185,23 @@ int countBookingRecords(fstream& bookingFile);
 int countBookingsForSailing(const string& sailingID, fstream& bookingFile);
 //Job: Counts the number of bookings for a specific sailing.
 //Usage: Used in the sailings report to show the number of vehicles.
+//       Constant time through the sailing's posting list, rebuilt first if
+//       another process has deleted or moved bookings since it was built.
 //Restrictions: File must be open.
 
+//----------------------------------------------------------------------------
+bool loadBookingsForSailing(const string& sailingID, vector<Booking>& result, fstream& bookingFile);
+//Job: Loads every booking on a sailing, in file order.
+//Usage: Used wherever one sailing's bookings are listed; reads only the
+//       sailing's k records through its posting list.
+//Restrictions: File must be open. Returns false if the index cannot be built.
+
+//----------------------------------------------------------------------------
+bool aggregateBookingsBySailing(fstream& bookingFile, unordered_map<SailingKey, SailingBookingTotals>& totals);
+//Job: Totals the vehicles and check-ins of every sailing with one
+//     pass over the booking file, in parallel chunks for the heap file.
+//Usage: Used by the sailings report engine as the booking side of its join.
+//Restrictions: File must be open. totals is cleared first.
+
 
 #endif //BOOKING_IO_H
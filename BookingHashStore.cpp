@@ -0,0 +1,613 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: BookingHashStore.cpp
+// Rev.11 - 18/10/2026 - Opening the table claims booking.hash for the process.
+// Rev.10 - 18/10/2026 - hashStoreEraseSailing rolls its transaction back if a
+//                       tombstone cannot be written.
+// Rev.9 - 18/10/2026 - Resizes are incremental: each write moves a few
+//                      buckets into the new table. Puts of a stored key are
+//                      refused.
+// Rev.8 - 18/10/2026 - Tables of another Booking layout are refused at open.
+// Rev.7 - 17/10/2026 - Hashing and probes read the plate in place instead of
+//                      copying it into a string.
+// Rev.6 - 17/10/2026 - Sailing scans match the SailingKey with the scan kernel;
+//                      added hashStoreLoadSailing.
+// Rev.5 - 17/10/2026 - Buckets are hashed, probed and tallied on the packed
+//                      SailingKey of the booking.
+// Rev.4 - 17/10/2026 - Scans through a StoreSnapshot take the bucket count
+//                      from the snapshot's header, not the open table.
+// Rev.3 - 17/10/2026 - Buckets are read and written with pread/pwrite through
+//                      a PositionalFile instead of seeking the fstream.
+// Rev.2 - 17/10/2026 - Added hashStoreMarkCheckedIn.
+// Rev.1 - 17/10/2026 - Implements the on-disk open-addressing booking store.
+//
+// ----------------------------------------------------------------------------
+// This module stores bookings in "booking.hash" as an open-addressing hash
+// table on disk.
+//
+// Implementation Strategy:
+// - The bucket of a key is the FNV-1a hash of the four bytes of the packed
+//   SailingKey followed by the license plate, modulo the bucket count (a
+//   power of two); collisions probe the following buckets. The SailingID is
+//   packed once per call, so probing compares integers before plates.
+// - A probe reads hashStoreProbeWindow buckets with one read, which at the
+//   load factors used almost always contains the key or an empty bucket.
+// - Insert, check-in and delete write the one bucket involved, in place.
+//   Deletes leave tombstones so probe chains stay intact; inserts reuse them.
+//   A put whose key is already stored is refused.
+// - The live and tombstone counts and a per-sailing tally are kept in memory.
+//   They are rebuilt with one pass whenever the table is (re)opened, so the
+//   header is only written when the table is created or a resize moves on.
+// - When live records plus tombstones would pass hashStoreMaxLoad, a resize
+//   starts: to twice the buckets if the table is genuinely full, otherwise
+//   to the same number, which drops the tombstones. The new table goes in
+//   front of the current one if the unused slots there hold it, otherwise
+//   right after it, so the file stays within a few times the table size.
+//   Slots past the end of the file are zero once the file is extended by
+//   writing the new table's last bucket; slots that held an older table
+//   are zeroed first. Every later write then does hashStoreResizeStep
+//   buckets of the resize (zeroing, then moving the old table's live
+//   bookings into the new one) as one small transaction with the header,
+//   and the step that moves the last bucket makes the new table current.
+// - While the new table is being filled, inserts go to it and lookups probe
+//   it first, then the old table. A booking found in an old bucket already
+//   moved was deleted after the move, so it does not count. Deletes and
+//   check-ins of a booking still in the old table are done there, and the
+//   move carries them over.
+// - Every write is reported to the write-ahead log first.
+// - The table layout and counts live in memory and in-place writes leave
+//   the file size alone, so another process's writes could not be noticed.
+//   Opening the table therefore claims booking.hash (RecordStore's
+//   claimDataFile) and fails while another process holds it.
+// - All file access is positional (RecordStore's PositionalFile), so probes
+//   never move a shared cursor.
+// - Scans for one sailing hand each block of buckets to the scan kernel
+//   (ScanKernel.h), which finds the buckets holding its SailingKey without
+//   unpacking a record.
+// - A scan made through a StoreSnapshot reads the table as the snapshot
+//   sees it, header included, and leaves the in-memory counts alone: they
+//   describe the current table and belong to the writers.
+//
+// Used By: Called by BookingFileIO.cpp when the hash engine is selected.
+// ----------------------------------------------------------------------------
+
+#include "BookingHashStore.h"
+#include "RecordStore.h"
+#include "WriteAheadLog.h"
+#include "ScanKernel.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+using namespace std;
+
+static PositionalFile hashData(fileNameBookingHash);  //pread/pwrite access to the table
+static BookingHashHeader table;      //Layout of the open table (bucketCount 0 = not open)
+static long long tableFileBytes = 0; //File size the open table was left at
+static int liveCount = 0;     //Buckets holding a booking, in both tables during a resize
+static int deadCount = 0;     //Tombstoned buckets in the table inserts go to
+static unordered_map<SailingKey, int> sailingCounts;  //SailingKey -> bookings in the table
+
+//----------------------------------------------------------------------------
+static long long slotOffset(long long slot){
+//Description: Returns the file offset of a bucket slot.
+    return static_cast<long long>(sizeof(BookingHashHeader)) +
+           slot * static_cast<long long>(sizeof(Booking));
+}
+
+//----------------------------------------------------------------------------
+static long long hashFileSize(){
+//Description: Returns the current size of the hash file in bytes.
+    return hashData.size();
+}
+
+//----------------------------------------------------------------------------
+static bool isResizing(const BookingHashHeader& layout){
+//Description: Returns whether a resize is under way.
+    return layout.nextBuckets > 0;
+}
+
+//----------------------------------------------------------------------------
+static bool isFilling(const BookingHashHeader& layout){
+//Description: Returns whether a resize has zeroed its new table and is
+//             moving bookings into it (inserts then go to the new table).
+    return layout.nextBuckets > 0 && layout.cleared == layout.nextBuckets;
+}
+
+//----------------------------------------------------------------------------
+static void insertTable(const BookingHashHeader& layout, int& start, int& buckets){
+//Description: Returns the first slot and bucket count of the table that
+//             inserts go to.
+    bool next = isFilling(layout);
+    start = static_cast<int>(next ? layout.nextStart : layout.tableStart);
+    buckets = static_cast<int>(next ? layout.nextBuckets : layout.bucketCount);
+}
+
+//----------------------------------------------------------------------------
+static int logicalBuckets(const BookingHashHeader& layout){
+//Description: Returns the number of buckets a scan visits: the table, or
+//             while a resize fills a new table, the new table and the old
+//             buckets not yet moved.
+    if (!isFilling(layout)) return static_cast<int>(layout.bucketCount);
+    return static_cast<int>(layout.nextBuckets + layout.bucketCount - layout.migrated);
+}
+
+//----------------------------------------------------------------------------
+static long long logicalSlot(const BookingHashHeader& layout, int bucket, int& run){
+//Description: Returns the slot of a bucket numbered as a scan visits them,
+//             and in run how many buckets follow it in the same table.
+    if (isFilling(layout)){
+        int nextBuckets = static_cast<int>(layout.nextBuckets);
+        if (bucket < nextBuckets){
+            run = nextBuckets - bucket;
+            return static_cast<long long>(layout.nextStart) + bucket;
+        }
+        bucket += static_cast<int>(layout.migrated) - nextBuckets;
+    }
+    run = static_cast<int>(layout.bucketCount) - bucket;
+    return static_cast<long long>(layout.tableStart) + bucket;
+}
+
+//----------------------------------------------------------------------------
+static unsigned int hashKey(SailingKey sailing, const char* licensePlate){
+//Description: 32-bit FNV-1a of the key's bytes (low byte first), then the plate.
+    unsigned int hash = 2166136261u;
+    for (int shift = 0; shift < 32; shift += 8){
+        hash = (hash ^ ((sailing >> shift) & 0xffu)) * 16777619u;
+    }
+    for (const char* c = licensePlate; *c != '\0'; ++c){
+        hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+    }
+    return hash;
+}
+
+//----------------------------------------------------------------------------
+static bool isEmptyBucket(const Booking& bucket){
+//Description: An empty bucket is all zeros, so it has no SailingKey.
+    return !bucket.isDeleted() && bucket.getSailingKey() == noSailingKey;
+}
+
+//----------------------------------------------------------------------------
+static bool writeHashBytes(long long offset, const void* data, size_t bytes){
+//Description: Writes bytes at an offset of the hash file (logged first).
+    logRecordWrite(fileNameBookingHash, offset, data, bytes);
+    return hashData.writeAt(offset, data, bytes);
+}
+
+//----------------------------------------------------------------------------
+static bool ensureHashStoreOpen(fstream& hashFile){
+//Description: Reopens the table if it was never opened or if the file no
+//             longer has the size the table left it at.
+    if (!hashFile.is_open()) return false;
+    if (table.bucketCount > 0 && hashFileSize() == tableFileBytes) return true;
+    return openBookingHashStore(hashFile);
+}
+
+//----------------------------------------------------------------------------
+static bool readLayout(fstream& hashFile, BookingHashHeader& layout){
+//Description: Returns the layout of the open table, or of the table the
+//             calling thread's snapshot sees.
+    if (!isSnapshotActive()){
+        if (!ensureHashStoreOpen(hashFile)) return false;
+        layout = table;
+        return true;
+    }
+    return hashFile.is_open() && hashData.readAt(0, &layout, sizeof(layout)) == sizeof(layout);
+}
+
+//----------------------------------------------------------------------------
+int hashStoreReadBuckets(fstream& hashFile, int first, int count, Booking* out){
+//Description: Reads up to count buckets starting at first with one read,
+//             stopping at the end of the table the first one is in.
+    if (first < 0 || count <= 0) return 0;
+    BookingHashHeader layout;
+    if (!readLayout(hashFile, layout) || first >= logicalBuckets(layout)) return 0;
+    int run;
+    long long slot = logicalSlot(layout, first, run);
+    count = min(count, run);
+    size_t got = hashData.readAt(slotOffset(slot), out, static_cast<size_t>(count) * sizeof(Booking));
+    return static_cast<int>(got / sizeof(Booking));
+}
+
+//----------------------------------------------------------------------------
+int hashStoreBucketCount(fstream& hashFile){
+//Description: Returns the number of buckets a scan of the open table, or of
+//             the table the calling thread's snapshot sees, visits.
+    BookingHashHeader layout;
+    return readLayout(hashFile, layout) ? logicalBuckets(layout) : 0;
+}
+
+//----------------------------------------------------------------------------
+static int probeBucket(int start, int buckets, SailingKey sailing, const string& licensePlate,
+                       Booking& found, int& freeBucket, bool& freeIsTombstone){
+//Description: Walks the probe chain of a key in the table of the given
+//             buckets from slot start, one window at a time. Returns the
+//             key's bucket (loading it into found) or -1. freeBucket is set
+//             to the first tombstone or empty bucket on the chain.
+    freeBucket = -1;
+    freeIsTombstone = false;
+    unsigned int mask = static_cast<unsigned int>(buckets) - 1;
+    int home = static_cast<int>(hashKey(sailing, licensePlate.c_str()) & mask);
+    Booking window[hashStoreProbeWindow];
+
+    int scanned = 0;
+    while (scanned < buckets){
+        int first = (home + scanned) & static_cast<int>(mask);
+        int count = min(hashStoreProbeWindow, min(buckets - first, buckets - scanned));
+        size_t bytes = hashData.readAt(slotOffset(static_cast<long long>(start) + first), window,
+                                       static_cast<size_t>(count) * sizeof(Booking));
+        int got = static_cast<int>(bytes / sizeof(Booking));
+        if (got <= 0) return -1;
+        for (int i = 0; i < got; ++i){
+            const Booking& bucket = window[i];
+            if (isEmptyBucket(bucket)){
+                if (freeBucket < 0) freeBucket = first + i;
+                return -1;
+            }
+            if (bucket.isDeleted()){
+                if (freeBucket < 0){
+                    freeBucket = first + i;
+                    freeIsTombstone = true;
+                }
+                continue;
+            }
+            if (bucket.hasKey(sailing, licensePlate)){
+                found = bucket;
+                return first + i;
+            }
+        }
+        scanned += got;
+    }
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+static long long findKeySlot(SailingKey sailing, const string& licensePlate, Booking& found, bool& inInsertTable){
+//Description: Returns the slot of the key's booking (loading it into
+//             found), or -1. While a resize fills a new table, that table
+//             is probed first; a hit in an old bucket already moved is a
+//             booking deleted since, and is not returned.
+    int freeBucket;
+    bool freeIsTombstone;
+    if (isFilling(table)){
+        int at = probeBucket(static_cast<int>(table.nextStart), static_cast<int>(table.nextBuckets),
+                             sailing, licensePlate, found, freeBucket, freeIsTombstone);
+        if (at >= 0){
+            inInsertTable = true;
+            return static_cast<long long>(table.nextStart) + at;
+        }
+        at = probeBucket(static_cast<int>(table.tableStart), static_cast<int>(table.bucketCount),
+                         sailing, licensePlate, found, freeBucket, freeIsTombstone);
+        if (at < static_cast<int>(table.migrated)) return -1;
+        inInsertTable = false;
+        return static_cast<long long>(table.tableStart) + at;
+    }
+    int at = probeBucket(static_cast<int>(table.tableStart), static_cast<int>(table.bucketCount),
+                         sailing, licensePlate, found, freeBucket, freeIsTombstone);
+    inInsertTable = true;
+    return at < 0 ? -1 : static_cast<long long>(table.tableStart) + at;
+}
+
+//----------------------------------------------------------------------------
+static bool stepResize(){
+//Description: Does the next hashStoreResizeStep buckets of a resize under
+//             way, as one transaction with the header: zeroes buckets of
+//             the new table while any are left, otherwise moves the live
+//             bookings of the next old buckets into it. Moving the last
+//             one makes the new table current. On failure the step is
+//             rolled back and the table reopened from the file.
+    if (!isResizing(table)) return true;
+    BookingHashHeader next = table;
+    bool ok = true;
+    beginWalTransaction();
+    if (next.cleared < next.nextBuckets){
+        unsigned int end = min(next.clearLimit, next.cleared + static_cast<unsigned int>(hashStoreResizeStep));
+        if (end > next.cleared){
+            vector<char> zero(static_cast<size_t>(end - next.cleared) * sizeof(Booking), 0);
+            ok = writeHashBytes(slotOffset(static_cast<long long>(next.nextStart) + next.cleared), &zero[0], zero.size());
+        }
+        next.cleared = end >= next.clearLimit ? next.nextBuckets : end;
+    } else{
+        unsigned int end = min(next.bucketCount, next.migrated + static_cast<unsigned int>(hashStoreResizeStep));
+        Booking moving[hashStoreResizeStep];
+        size_t bytes = static_cast<size_t>(end - next.migrated) * sizeof(Booking);
+        ok = hashData.readAt(slotOffset(static_cast<long long>(next.tableStart) + next.migrated), moving, bytes) == bytes;
+        for (unsigned int i = 0; ok && i < end - next.migrated; ++i){
+            if (moving[i].isDeleted() || isEmptyBucket(moving[i])) continue;
+            Booking found;
+            int freeBucket;
+            bool freeIsTombstone;
+            probeBucket(static_cast<int>(next.nextStart), static_cast<int>(next.nextBuckets), moving[i].getSailingKey(),
+                        moving[i].getLicensePlate(), found, freeBucket, freeIsTombstone);
+            ok = freeBucket >= 0 &&
+                 writeHashBytes(slotOffset(static_cast<long long>(next.nextStart) + freeBucket), &moving[i], sizeof(Booking));
+            if (ok && freeIsTombstone) --deadCount;
+        }
+        next.migrated = end;
+        if (end == next.bucketCount){
+            //Everything moved: the new table becomes the table
+            next.bucketCount = next.nextBuckets;
+            next.tableStart = next.nextStart;
+            next.nextBuckets = next.nextStart = next.cleared = next.clearLimit = next.migrated = 0;
+        }
+    }
+    ok = ok && writeHashBytes(0, &next, sizeof(next));
+    if (!ok){
+        abortWalTransaction();
+        table.bucketCount = 0;  //Reopened and recounted from the file on next use
+        return false;
+    }
+    commitWalTransaction();
+    bool startsFilling = !isFilling(table) && isFilling(next);
+    table = next;
+    if (startsFilling) deadCount = 0;  //Inserts now go to the new, empty table
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool startResize(int newBucketCount){
+//Description: Records in the header a resize to newBucketCount buckets,
+//             placed in front of the table if the slots there hold it,
+//             otherwise right after it. Slots past the end of the file are
+//             made by writing the last one; the rest are zeroed by the
+//             resize steps.
+    int buckets = static_cast<int>(table.bucketCount);  //The table never shrinks
+    while (buckets < newBucketCount || buckets * hashStoreMaxLoad <= liveCount) buckets *= 2;
+
+    BookingHashHeader next = table;
+    next.nextBuckets = static_cast<unsigned int>(buckets);
+    next.nextStart = next.nextBuckets <= table.tableStart ? 0 : table.tableStart + table.bucketCount;
+    long long fileSlots = (tableFileBytes - slotOffset(0)) / static_cast<long long>(sizeof(Booking));
+    long long inFile = max(0LL, min(static_cast<long long>(buckets), fileSlots - next.nextStart));
+    next.clearLimit = static_cast<unsigned int>(inFile);
+    next.cleared = inFile > 0 ? 0 : next.nextBuckets;
+    next.migrated = 0;
+
+    long long end = slotOffset(static_cast<long long>(next.nextStart) + buckets);
+    bool ok = true;
+    beginWalTransaction();
+    if (end > tableFileBytes){
+        char empty[sizeof(Booking)] = {};
+        ok = writeHashBytes(end - static_cast<long long>(sizeof(Booking)), empty, sizeof(empty));
+    }
+    ok = ok && writeHashBytes(0, &next, sizeof(next));
+    if (!ok){
+        abortWalTransaction();
+        table.bucketCount = 0;
+        return false;
+    }
+    commitWalTransaction();
+    table = next;
+    tableFileBytes = max(tableFileBytes, end);
+    if (isFilling(table)) deadCount = 0;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool openBookingHashStore(fstream& hashFile){
+//Description: Validates (or creates) the table, then counts live records,
+//             tombstones and bookings per sailing in one pass over the
+//             buckets a scan visits.
+    table = BookingHashHeader();
+    tableFileBytes = 0;
+    liveCount = 0;
+    deadCount = 0;
+    sailingCounts.clear();
+    if (!hashFile.is_open() || !claimDataFile(fileNameBookingHash)) return false;
+
+    long long size = hashFileSize();
+    if (size == 0){
+        //New table: header followed by empty buckets
+        BookingHashHeader header;
+        header.bucketCount = hashStoreInitialBuckets;
+        vector<char> image(static_cast<size_t>(slotOffset(hashStoreInitialBuckets)), 0);
+        memcpy(&image[0], &header, sizeof(header));
+        if (!writeHashBytes(0, &image[0], image.size())) return false;
+        table = header;
+        tableFileBytes = static_cast<long long>(image.size());
+        return true;
+    }
+
+    BookingHashHeader header;
+    if (hashData.readAt(0, &header, sizeof(header)) != sizeof(header)) return false;
+    BookingHashHeader expected;
+    unsigned int buckets = header.bucketCount;
+    unsigned int next = header.nextBuckets;
+    long long end = slotOffset(static_cast<long long>(header.tableStart) + buckets);
+    if (next > 0) end = max(end, slotOffset(static_cast<long long>(header.nextStart) + next));
+    bool nextFits = next == 0 ||
+        ((next & (next - 1)) == 0 && header.cleared <= next && header.clearLimit <= next &&
+         header.migrated <= buckets &&
+         (header.nextStart + next <= header.tableStart || header.tableStart + buckets <= header.nextStart));
+    if (memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+        header.version != expected.version || header.recordBytes != expected.recordBytes ||
+        buckets == 0 || (buckets & (buckets - 1)) != 0 || !nextFits || size < end){
+        return false;
+    }
+
+    table = header;
+    tableFileBytes = size;
+    int start, insertBuckets;
+    insertTable(table, start, insertBuckets);
+    int total = logicalBuckets(table);
+    vector<Booking> block(1024);
+    for (int first = 0; first < total;){
+        int got = hashStoreReadBuckets(hashFile, first, static_cast<int>(block.size()), &block[0]);
+        if (got <= 0) break;
+        for (int i = 0; i < got; ++i){
+            if (block[i].isDeleted()){
+                if (first + i < insertBuckets) ++deadCount;  //Scans visit the insert table first
+            } else if (!isEmptyBucket(block[i])){
+                ++liveCount;
+                ++sailingCounts[block[i].getSailingKey()];
+            }
+        }
+        first += got;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool hashStoreRehash(fstream& hashFile, int newBucketCount){
+//Description: Starts a resize unless one is under way; later writes move
+//             the buckets.
+    if (!ensureHashStoreOpen(hashFile)) return false;
+    return isResizing(table) || startResize(newBucketCount);
+}
+
+//----------------------------------------------------------------------------
+bool hashStoreFind(fstream& hashFile, const string& sailingID, const string& licensePlate, Booking& result){
+//Description: Returns the booking with this key, if any.
+    if (!ensureHashStoreOpen(hashFile)) return false;
+    bool inInsertTable;
+    return findKeySlot(packSailingKey(sailingID), licensePlate, result, inInsertTable) >= 0;
+}
+
+//----------------------------------------------------------------------------
+bool hashStorePut(fstream& hashFile, const Booking& booking){
+//Description: Refuses a key already stored. Otherwise does a step of a
+//             resize under way, starts one if the insert would push the
+//             insert table past its maximum load, and fills the first free
+//             bucket on the key's probe chain in the insert table.
+    if (!ensureHashStoreOpen(hashFile)) return false;
+    Booking record = booking;
+    record.setDeleted(false);
+
+    Booking existing;
+    bool inInsertTable;
+    if (findKeySlot(record.getSailingKey(), record.getLicensePlate(), existing, inInsertTable) >= 0) return false;
+    if (!stepResize()) return false;
+
+    int start, buckets;
+    insertTable(table, start, buckets);
+    if (!isResizing(table) && liveCount + deadCount + 1 > buckets * hashStoreMaxLoad){
+        //Double only if the live records alone fill half the limit
+        bool full = liveCount + 1 > buckets * hashStoreMaxLoad / 2;
+        if (!startResize(full ? buckets * 2 : buckets)) return false;
+        insertTable(table, start, buckets);
+    }
+    int freeBucket;
+    bool freeIsTombstone;
+    probeBucket(start, buckets, record.getSailingKey(), record.getLicensePlate(), existing, freeBucket, freeIsTombstone);
+    if (freeBucket < 0) return false;
+    if (!writeHashBytes(slotOffset(static_cast<long long>(start) + freeBucket), &record, sizeof(Booking))) return false;
+
+    if (freeIsTombstone) --deadCount;
+    ++liveCount;
+    ++sailingCounts[record.getSailingKey()];
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool hashStoreMarkCheckedIn(fstream& hashFile, const string& sailingID, const string& licensePlate){
+//Description: Probes for the key's bucket and rewrites only its flag byte.
+    if (!ensureHashStoreOpen(hashFile) || !stepResize()) return false;
+    Booking existing;
+    bool inInsertTable;
+    long long slot = findKeySlot(packSailingKey(sailingID), licensePlate, existing, inInsertTable);
+    if (slot < 0) return false;
+    const bool flag = true;
+    return writeHashBytes(slotOffset(slot) + static_cast<long long>(Booking::checkedInOffset()), &flag, sizeof(flag));
+}
+
+//----------------------------------------------------------------------------
+static bool tombstoneBucket(long long slot, Booking record, bool inInsertTable){
+//Description: Marks a bucket as a tombstone and updates the tallies; only
+//             the insert table's tombstones count towards its load.
+    record.setDeleted(true);
+    if (!writeHashBytes(slotOffset(slot), &record, sizeof(Booking))) return false;
+    --liveCount;
+    if (inInsertTable) ++deadCount;
+    unordered_map<SailingKey, int>::iterator it = sailingCounts.find(record.getSailingKey());
+    if (it != sailingCounts.end() && --it->second <= 0) sailingCounts.erase(it);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool hashStoreErase(fstream& hashFile, const string& sailingID, const string& licensePlate){
+//Description: Finds the key's bucket and turns it into a tombstone.
+    if (!ensureHashStoreOpen(hashFile) || !stepResize()) return false;
+    Booking existing;
+    bool inInsertTable;
+    long long slot = findKeySlot(packSailingKey(sailingID), licensePlate, existing, inInsertTable);
+    if (slot < 0) return false;
+    return tombstoneBucket(slot, existing, inInsertTable);
+}
+
+//----------------------------------------------------------------------------
+static void collectSailingBuckets(fstream& hashFile, SailingKey sailing, vector<int>& buckets, vector<Booking>& records){
+//Description: Reads the buckets in blocks and lets the scan kernel find the
+//             ones holding the sailing's key; tombstones keep their key, so
+//             each hit is checked before it is kept. Buckets are numbered
+//             as hashStoreReadBuckets numbers them.
+    int total = hashStoreBucketCount(hashFile);
+    vector<Booking> block(1024);
+    for (int first = 0; first < total;){
+        int got = hashStoreReadBuckets(hashFile, first, static_cast<int>(block.size()), &block[0]);
+        if (got <= 0) return;
+        for (int at = 0; at < got; ++at){
+            int hit = findRecordKey(&block[at], sizeof(Booking), got - at, Booking::sailingKeyOffset(),
+                                    &sailing, sizeof(sailing));
+            if (hit < 0) break;
+            at += hit;
+            if (block[at].isDeleted()) continue;
+            buckets.push_back(first + at);
+            records.push_back(block[at]);
+        }
+        first += got;
+    }
+}
+
+//----------------------------------------------------------------------------
+int hashStoreEraseSailing(fstream& hashFile, const string& sailingID){
+//Description: Walks the buckets in blocks and tombstones each booking on
+//             the sailing, as one write-ahead log transaction. If one
+//             fails the transaction is rolled back and the table reopened,
+//             so all of the sailing's bookings stay.
+    if (!ensureHashStoreOpen(hashFile) || !stepResize()) return 0;
+    SailingKey sailing = packSailingKey(sailingID);
+    if (sailingCounts.find(sailing) == sailingCounts.end()) return 0;
+
+    vector<int> buckets;
+    vector<Booking> records;
+    collectSailingBuckets(hashFile, sailing, buckets, records);
+
+    int start, insertBuckets;
+    insertTable(table, start, insertBuckets);
+    beginWalTransaction();
+    for (size_t i = 0; i < buckets.size(); ++i){
+        int run;
+        long long slot = logicalSlot(table, buckets[i], run);
+        if (!tombstoneBucket(slot, records[i], buckets[i] < insertBuckets)){
+            abortWalTransaction();
+            openBookingHashStore(hashFile);  //Counts follow the restored buckets
+            return 0;
+        }
+    }
+    commitWalTransaction();
+    return static_cast<int>(buckets.size());
+}
+
+//----------------------------------------------------------------------------
+bool hashStoreLoadSailing(fstream& hashFile, const string& sailingID, vector<Booking>& result){
+//Description: Collects the sailing's bookings in bucket order.
+    result.clear();
+    if (!ensureHashStoreOpen(hashFile)) return false;
+    vector<int> buckets;
+    collectSailingBuckets(hashFile, packSailingKey(sailingID), buckets, result);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+int hashStoreCount(fstream& hashFile){
+//Description: Returns the number of live bookings.
+    return ensureHashStoreOpen(hashFile) ? liveCount : 0;
+}
+
+//----------------------------------------------------------------------------
+int hashStoreCountSailing(fstream& hashFile, const string& sailingID){
+//Description: Returns the sailing's tally.
+    if (!ensureHashStoreOpen(hashFile)) return 0;
+    unordered_map<SailingKey, int>::const_iterator it = sailingCounts.find(packSailingKey(sailingID));
+    return it == sailingCounts.end() ? 0 : it->second;
+}
@@ -0,0 +1,210 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: BookingHashStore.h
+// Rev.7 - 18/10/2026 - hashStoreEraseSailing removes all of a sailing's
+//                      bookings or none.
+// Rev.6 - 18/10/2026 - Resizes move the table a few buckets per write instead
+//                      of rewriting it at once; hashStorePut refuses a stored key.
+// Rev.5 - 18/10/2026 - The header carries the Booking layout version and size.
+// Rev.4 - 17/10/2026 - Added hashStoreLoadSailing.
+// Rev.3 - 17/10/2026 - hashStoreScan tells empty buckets by their SailingKey.
+// Rev.2 - 17/10/2026 - Added hashStoreMarkCheckedIn.
+// Rev.1 - 17/10/2026 - Interface for the on-disk open-addressing booking store.
+//
+// ----------------------------------------------------------------------------
+// This header declares an alternative primary storage engine for bookings:
+// a hash file with a fixed number of buckets, keyed on (SailingID, License
+// Plate) and resolved with linear probing. Inserts, check-ins and deletes
+// are done in place, so each costs one positional write, and a lookup
+// normally costs one positional read (a window of neighbouring buckets is
+// read at once). Inserting a key that is already stored is refused.
+//
+// File layout: a BookingHashHeader, then Booking-sized bucket slots. The
+// table occupies bucketCount slots from tableStart; slots outside it are
+// unused (left by earlier tables). An all-zero bucket is empty; a bucket
+// with the deleted flag is a tombstone. A table whose header names another
+// Booking layout (bookingFileVersion, record size) is refused rather than
+// read, as is a table of the older "FQHS" layout, which had no resize state.
+//
+// Once live records and tombstones pass hashStoreMaxLoad of the buckets,
+// the table is resized: doubled, or rebuilt at the same size when most of
+// the load is tombstones. The new table is placed in unused slots and each
+// later write first does hashStoreResizeStep buckets of the move (zeroing
+// the new table's slots, then moving the old table's bookings into it), so
+// no single write pays for the whole table. While the move is under way
+// inserts go to the new table and lookups try it before the old one.
+// Selected through BookingFileIO.h; the other modules never call this one
+// directly.
+// ----------------------------------------------------------------------------
+
+#ifndef BOOKING_HASH_STORE_H
+#define BOOKING_HASH_STORE_H
+
+#include "BookingUserIO.h"
+#include "BookingFileIO.h"
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+const string fileNameBookingHash = "booking.hash";  //Hash store file name
+const int hashStoreInitialBuckets = 1024;           //Buckets in a new table
+const float hashStoreMaxLoad = 0.5f;                //Live + dead fraction that triggers a resize
+const int hashStoreProbeWindow = 8;                 //Buckets read per probe I/O
+const int hashStoreResizeStep = 16;                 //Buckets of a resize done per write
+
+//First bytes of the hash file
+struct BookingHashHeader{
+    BookingHashHeader()
+        : magic{'F', 'Q', 'H', '2'}, version(bookingFileVersion), recordBytes(sizeof(Booking)), bucketCount(0),
+          tableStart(0), nextBuckets(0), nextStart(0), cleared(0), clearLimit(0), migrated(0){}
+    char magic[4];             //"FQH2"
+    unsigned int version;      //Booking layout of the buckets
+    unsigned int recordBytes;  //Size of one bucket
+    unsigned int bucketCount;  //Buckets in the table
+    unsigned int tableStart;   //Slot of its first bucket
+    unsigned int nextBuckets;  //Buckets in the table a resize is moving to (0 = no resize)
+    unsigned int nextStart;    //Slot of its first bucket
+    unsigned int cleared;      //Its buckets zeroed so far (nextBuckets once all are usable)
+    unsigned int clearLimit;   //Its buckets that held old data and need zeroing
+    unsigned int migrated;     //Buckets of the table already moved into it
+};
+
+//----------------------------------------------------------------------------
+bool openBookingHashStore(fstream& hashFile//input
+                          );
+//Job: Checks the header (creating an empty table in an empty file) and
+//     counts the live records and tombstones with one pass.
+//Usage: Called through buildBookingIndex at startup; other calls reopen
+//       the table automatically if the file size no longer matches it.
+//Restrictions: File must be open in binary read/write mode. Returns false
+//              for a file that is not a booking hash store of the current
+//              Booking layout.
+
+//----------------------------------------------------------------------------
+bool hashStoreFind(fstream& hashFile,          //input
+                   const string& sailingID,    //input
+                   const string& licensePlate, //input
+                   Booking& result             //output
+                   );
+//Job: Looks up a booking by key.
+//Usage: Backs loadBookingByKey.
+//Restrictions: Returns false if not found.
+
+//----------------------------------------------------------------------------
+bool hashStorePut(fstream& hashFile,    //input
+                  const Booking& booking//input
+                  );
+//Job: Inserts a booking.
+//Usage: Backs writeBooking.
+//Restrictions: Returns false if a booking with the same key is stored, as
+//              the other engines do. Does a step of a resize under way
+//              first, and may start one.
+
+//----------------------------------------------------------------------------
+bool hashStoreMarkCheckedIn(fstream& hashFile,          //input
+                            const string& sailingID,    //input
+                            const string& licensePlate  //input
+                            );
+//Job: Sets the checked-in flag of a booking with a one-byte write to its bucket.
+//Usage: Backs markCheckedIn.
+//Restrictions: Returns false if not found. Does a step of a resize under way.
+
+//----------------------------------------------------------------------------
+bool hashStoreErase(fstream& hashFile,          //input
+                    const string& sailingID,    //input
+                    const string& licensePlate  //input
+                    );
+//Job: Deletes a booking by turning its bucket into a tombstone.
+//Usage: Backs deleteBookingRecord.
+//Restrictions: Returns false if not found. Does a step of a resize under way.
+
+//----------------------------------------------------------------------------
+int hashStoreEraseSailing(fstream& hashFile,      //input
+                          const string& sailingID //input
+                          );
+//Job: Tombstones every booking on a sailing with one pass over the buckets.
+//Usage: Backs deleteBookingsBySailingID.
+//Restrictions: Returns the number of bookings removed; 0, with every
+//              booking kept, if a tombstone cannot be written.
+
+//----------------------------------------------------------------------------
+bool hashStoreLoadSailing(fstream& hashFile,       //input
+                          const string& sailingID, //input
+                          vector<Booking>& result  //output
+                          );
+//Job: Loads every live booking on a sailing, matching its key a block of
+//     buckets at a time.
+//Usage: Backs loadBookingsForSailing.
+//Restrictions: Returns false if the table cannot be opened.
+
+//----------------------------------------------------------------------------
+bool hashStoreRehash(fstream& hashFile, //input
+                     int bucketCount    //input
+                     );
+//Job: Starts moving the table into one with the given number of buckets,
+//     which leaves the tombstones behind.
+//Usage: Called when the table fills up, and by compactBookingFile.
+//Restrictions: The result is rounded up to a power of two large enough
+//              for the live records; the table never shrinks. Later writes
+//              finish the move; nothing is started while one is under way.
+
+//----------------------------------------------------------------------------
+int hashStoreCount(fstream& hashFile//input
+                   );
+//Job: Returns the number of live bookings in the table.
+//Usage: Backs countBookingRecords.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+int hashStoreCountSailing(fstream& hashFile,      //input
+                          const string& sailingID //input
+                          );
+//Job: Returns the number of bookings on a sailing from an in-memory tally.
+//Usage: Backs countBookingsForSailing.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+int hashStoreReadBuckets(fstream& hashFile, //input
+                         int first,         //input
+                         int count,         //input
+                         Booking* out       //output
+                         );
+//Job: Reads up to count buckets starting at first with one read. Buckets
+//     are numbered across the table, or while a resize fills a new table,
+//     across the new table followed by the old buckets not yet moved.
+//Usage: Used by hashStoreScan and the per-sailing scans.
+//Restrictions: Returns the number of buckets read, which stops short at
+//              the end of the new table.
+
+//----------------------------------------------------------------------------
+int hashStoreBucketCount(fstream& hashFile//input
+                         );
+//Job: Returns the number of buckets hashStoreReadBuckets numbers (0 if the
+//     table cannot be opened).
+//Usage: Used by hashStoreScan.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+template<class Visitor>
+void hashStoreScan(fstream& hashFile, //input
+                   Visitor visit      //input
+                   ){
+//Job: Calls visit(booking) for every live booking, reading the buckets in
+//     large sequential blocks.
+//Usage: Backs the full-scan functions of BookingFileIO.h.
+//Restrictions: visit returns false to stop early.
+    int buckets = hashStoreBucketCount(hashFile);
+    vector<Booking> block(1024);
+    for (int first = 0; first < buckets;){
+        int got = hashStoreReadBuckets(hashFile, first, static_cast<int>(block.size()), &block[0]);
+        if (got <= 0) return;
+        first += got;
+        for (int i = 0; i < got; ++i){
+            if (block[i].isDeleted() || block[i].getSailingKey() == noSailingKey) continue;
+            if (!visit(block[i])) return;
+        }
+    }
+}
+
+#endif //BOOKING_HASH_STORE_H
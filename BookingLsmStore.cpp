@@ -0,0 +1,902 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: BookingLsmStore.cpp
+// Rev.7 - 18/10/2026 - Opening the store claims booking.lsm for the process.
+// Rev.6 - 18/10/2026 - lsmStoreEraseSailing rolls its transaction back if a
+//                      tombstone cannot be appended.
+// Rev.5 - 18/10/2026 - The journal and run files carry the Booking layout
+//                      version; files of another layout are refused.
+// Rev.4 - 17/10/2026 - Sort keys are built from the plate stored in the record.
+// Rev.3 - 17/10/2026 - Run blocks are searched with the scan kernel.
+// Rev.2 - 17/10/2026 - Keys start with the packed SailingKey; lookups and
+//                      tallies compare integers.
+// Rev.1 - 17/10/2026 - Implements the log-structured (LSM) booking store.
+//
+// ----------------------------------------------------------------------------
+// This module keeps bookings in a memtable, a journal and sorted run files.
+//
+// Implementation Strategy:
+// - The memtable is a std::map keyed on the packed SailingKey (four bytes,
+//   most significant first) followed by the license plate, so it is always
+//   in (SailingID, License Plate) order. A delete stores the booking with its deleted flag
+//   set (a tombstone) to hide older copies in the runs.
+// - Every put and delete is appended to the journal (booking.lsm) through
+//   the write-ahead log, then applied to the memtable. Opening the store
+//   replays the journal, so the memtable survives a restart.
+// - The journal starts with a RecordFileHeader and each run file with an
+//   LsmRunHeader, both naming the Booking layout (bookingFileVersion and
+//   record size). Opening the store refuses a journal or run of any other
+//   layout rather than replay misread records.
+// - At lsmMemtableLimit entries the memtable is written out as a run:
+//   records in key order, then a Bloom filter. The run is synced, added to
+//   the manifest (written to a temporary file and renamed), and only then
+//   is the journal emptied. A flush is held back while the memtable has
+//   writes of the open transaction, since these could still be rolled back.
+// - Runs never change once written, so a background thread can merge them
+//   while the foreground keeps reading. Runs are merged size-tiered: once
+//   lsmMergeFanIn of the newest runs are of a similar size they become one.
+//   Tombstones are dropped when the merge includes the oldest run.
+// - For each run the Bloom filter and every lsmFenceInterval-th key are
+//   kept in memory, so a lookup reads at most one block per run, and only
+//   from runs whose filter says the key may be there. The block is searched
+//   with the scan kernel (ScanKernel.h), which compares the key and plate
+//   fields of the records as raw bytes against a probe booking.
+// - The live count and a per-sailing tally are rebuilt with one merged pass
+//   at open and then kept up to date by put and delete.
+// - The memtable, run list and journal length are this process's alone, so
+//   opening the store claims booking.lsm (RecordStore's claimDataFile) and
+//   fails while another process holds it.
+//
+// Used By: Called by BookingFileIO.cpp when the LSM engine is selected.
+// ----------------------------------------------------------------------------
+
+#include "BookingLsmStore.h"
+#include "BookingFileIO.h"
+#include "RecordStore.h"
+#include "WriteAheadLog.h"
+#include "SailingKey.h"
+#include "ScanKernel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//First bytes of a run file; the sorted records follow, then the Bloom filter
+struct LsmRunHeader{
+    LsmRunHeader()
+        : magic{'F', 'Q', 'R', 'N'}, version(bookingFileVersion), recordBytes(sizeof(Booking)), count(0), bloomBytes(0){}
+    char magic[4];            //"FQRN"
+    unsigned int version;     //Booking layout of the records
+    unsigned int recordBytes; //Size of one record
+    unsigned int count;       //Records in the run
+    unsigned int bloomBytes;  //Size of the Bloom filter after the records
+};
+
+//An immutable sorted run and its in-memory summaries
+struct LsmRun{
+    LsmRun() : count(0), obsolete(false){}
+    ~LsmRun(){
+        reader.close();
+        if (obsolete) remove(fileName.c_str());  //Merged away and no longer read
+    }
+    string fileName;
+    int count;
+    vector<unsigned char> bloom;
+    vector<string> fences;  //Key of every lsmFenceInterval-th record
+    ifstream reader;        //Point lookups (foreground thread only)
+    atomic<bool> obsolete;  //The last owner removes the file
+};
+typedef shared_ptr<LsmRun> LsmRunPtr;
+
+//Joins the merge thread before the store's state is destroyed at exit
+struct LsmMergeThread{
+    ~LsmMergeThread(){
+        if (worker.joinable()) worker.join();
+    }
+    thread worker;
+};
+
+static const long long runHeaderBytes = sizeof(LsmRunHeader);
+static const RecordFileHeader journalHeader =
+    makeRecordFileHeader("FQLJ", bookingFileVersion, sizeof(Booking));  //Start of the journal
+static const int lsmBloomProbes = 7;
+static const size_t lsmBlockRecords = 1024;  //Records per sequential read or write
+
+static bool storeOpen = false;
+static map<string, Booking> memtable;   //Key -> newest record, tombstones included
+static unsigned int memtableTxn = 0;     //WAL transaction of the last memtable write
+static long long journalRecords = 0;     //Records in the journal
+static int liveCount = 0;                //Live bookings in the whole store
+static unordered_map<SailingKey, int> sailingCounts;  //SailingKey -> live bookings
+static vector<LsmRunPtr> runs;           //Oldest first
+static int nextRunSeq = 1;               //Number of the next run file
+static mutex runsLock;                   //Guards runs, nextRunSeq and the manifest
+static atomic<bool> mergeRunning(false);
+static LsmMergeThread mergeThread;
+
+//----------------------------------------------------------------------------
+static string lsmKey(SailingKey sailing, const char* licensePlate){
+//Description: Builds the sort key. The SailingKey has a fixed width and is
+//             stored high byte first, so keys order by SailingID, then
+//             License Plate.
+    char prefix[4] = {
+        static_cast<char>(sailing >> 24), static_cast<char>(sailing >> 16),
+        static_cast<char>(sailing >> 8), static_cast<char>(sailing)
+    };
+    return string(prefix, sizeof(prefix)) + licensePlate;
+}
+
+//----------------------------------------------------------------------------
+static string recordKey(const Booking& booking){
+//Description: Returns the sort key of a booking.
+    return lsmKey(booking.getSailingKey(), booking.getLicensePlateChars());
+}
+
+//----------------------------------------------------------------------------
+static unsigned long long hashKey64(const string& key){
+//Description: 64-bit FNV-1a of a key; its halves seed the Bloom probes.
+    unsigned long long hash = 14695981039346656037ull;
+    for (size_t i = 0; i < key.size(); ++i){
+        hash = (hash ^ static_cast<unsigned char>(key[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+//----------------------------------------------------------------------------
+static void bloomAdd(vector<unsigned char>& bloom, unsigned long long hash){
+//Description: Sets the filter bits of a key (double hashing).
+    unsigned long long bits = static_cast<unsigned long long>(bloom.size()) * 8;
+    unsigned long long h1 = hash & 0xffffffffull;
+    unsigned long long h2 = (hash >> 32) | 1;
+    for (int i = 0; i < lsmBloomProbes; ++i){
+        unsigned long long bit = (h1 + i * h2) % bits;
+        bloom[bit / 8] |= static_cast<unsigned char>(1u << (bit % 8));
+    }
+}
+
+//----------------------------------------------------------------------------
+static bool bloomMayContain(const vector<unsigned char>& bloom, unsigned long long hash){
+//Description: False only if the key is certainly not in the run.
+    if (bloom.empty()) return true;
+    unsigned long long bits = static_cast<unsigned long long>(bloom.size()) * 8;
+    unsigned long long h1 = hash & 0xffffffffull;
+    unsigned long long h2 = (hash >> 32) | 1;
+    for (int i = 0; i < lsmBloomProbes; ++i){
+        unsigned long long bit = (h1 + i * h2) % bits;
+        if ((bloom[bit / 8] & (1u << (bit % 8))) == 0) return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static void syncPath(const string& path){
+//Description: Forces a file (or a directory entry) to stable storage.
+#if !defined(_WIN32)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+#else
+    (void)path;
+#endif
+}
+
+//----------------------------------------------------------------------------
+static string runFileName(int seq){
+//Description: Returns the file name of run number seq.
+    return fileNameBookingLsm + ".run" + to_string(seq);
+}
+
+//----------------------------------------------------------------------------
+static int runSeqOf(const string& fileName){
+//Description: Returns the run number in a run file name (0 if none).
+    size_t at = fileName.rfind(".run");
+    return at == string::npos ? 0 : atoi(fileName.c_str() + at + 4);
+}
+
+//----------------------------------------------------------------------------
+static long long recordOffset(long long record){
+//Description: Returns the offset of a record in a run file.
+    return runHeaderBytes + record * static_cast<long long>(sizeof(Booking));
+}
+
+//----------------------------------------------------------------------------
+template<class Source>
+static bool writeRun(const string& fileName, size_t expectedKeys, Source next, LsmRunPtr& run){
+//Description: Streams the records returned by next() into a new run file
+//             (header, records, Bloom filter, then the real header) and
+//             syncs it. run is left null if there were no records.
+    run.reset();
+    LsmRunPtr built(new LsmRun);
+    built->fileName = fileName;
+    ofstream out(fileName.c_str(), ios::binary | ios::trunc);
+    if (!out) return false;
+
+    LsmRunHeader header;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    vector<unsigned long long> hashes;
+    hashes.reserve(expectedKeys);
+    vector<Booking> block;
+    block.reserve(lsmBlockRecords);
+    Booking record;
+    while (next(record)){
+        string key = recordKey(record);
+        if (built->count % lsmFenceInterval == 0) built->fences.push_back(key);
+        hashes.push_back(hashKey64(key));
+        block.push_back(record);
+        ++built->count;
+        if (block.size() == lsmBlockRecords){
+            out.write(reinterpret_cast<const char*>(&block[0]), block.size() * sizeof(Booking));
+            block.clear();
+        }
+    }
+    if (!block.empty()) out.write(reinterpret_cast<const char*>(&block[0]), block.size() * sizeof(Booking));
+
+    built->bloom.assign(max<size_t>(8, (hashes.size() * lsmBloomBitsPerKey + 7) / 8), 0);
+    for (size_t i = 0; i < hashes.size(); ++i) bloomAdd(built->bloom, hashes[i]);
+    out.write(reinterpret_cast<const char*>(&built->bloom[0]), built->bloom.size());
+
+    header.count = static_cast<unsigned int>(built->count);
+    header.bloomBytes = static_cast<unsigned int>(built->bloom.size());
+    out.seekp(0, ios::beg);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (out.fail() || built->count == 0){
+        remove(fileName.c_str());
+        return !out.fail();
+    }
+    syncPath(fileName);
+
+    built->reader.open(fileName.c_str(), ios::binary);
+    if (!built->reader) return false;
+    run = built;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool loadRun(const string& fileName, LsmRunPtr& run){
+//Description: Checks a run file and loads its Bloom filter and fence keys.
+    LsmRunPtr loaded(new LsmRun);
+    loaded->fileName = fileName;
+    ifstream in(fileName.c_str(), ios::binary);
+    LsmRunHeader header;
+    LsmRunHeader expected;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+        header.version != expected.version || header.recordBytes != expected.recordBytes) return false;
+    in.seekg(0, ios::end);
+    if (static_cast<long long>(in.tellg()) != recordOffset(header.count) + header.bloomBytes) return false;
+
+    loaded->count = static_cast<int>(header.count);
+    loaded->bloom.resize(header.bloomBytes);
+    in.seekg(static_cast<streampos>(recordOffset(header.count)), ios::beg);
+    if (header.bloomBytes > 0 && !in.read(reinterpret_cast<char*>(&loaded->bloom[0]), header.bloomBytes)) return false;
+
+    vector<Booking> block(lsmBlockRecords);
+    in.seekg(static_cast<streampos>(runHeaderBytes), ios::beg);
+    for (int first = 0; first < loaded->count; first += static_cast<int>(block.size())){
+        int count = min(static_cast<int>(block.size()), loaded->count - first);
+        if (!in.read(reinterpret_cast<char*>(&block[0]), static_cast<streamsize>(count) * sizeof(Booking))) return false;
+        for (int i = (lsmFenceInterval - first % lsmFenceInterval) % lsmFenceInterval; i < count; i += lsmFenceInterval){
+            loaded->fences.push_back(recordKey(block[i]));
+        }
+    }
+
+    loaded->reader.open(fileName.c_str(), ios::binary);
+    if (!loaded->reader) return false;
+    run = loaded;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool writeManifest(){
+//Description: Replaces the manifest with the current run list. The new
+//             list is synced under a temporary name and renamed into place,
+//             so a crash leaves either the old list or the new one.
+//             The caller holds runsLock.
+    string temporary = fileNameBookingLsmManifest + ".tmp";
+    ofstream out(temporary.c_str(), ios::trunc);
+    out << "FQLSM1\n";
+    for (size_t i = 0; i < runs.size(); ++i) out << runs[i]->fileName << '\n';
+    out.close();
+    if (out.fail()) return false;
+    syncPath(temporary);
+    if (rename(temporary.c_str(), fileNameBookingLsmManifest.c_str()) != 0) return false;
+    syncPath(".");
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool readManifest(vector<string>& fileNames){
+//Description: Reads the run list; a missing manifest means no runs yet.
+    fileNames.clear();
+    ifstream in(fileNameBookingLsmManifest.c_str());
+    if (!in) return true;
+    string line;
+    if (!getline(in, line) || line != "FQLSM1") return false;
+    while (getline(in, line)){
+        if (!line.empty()) fileNames.push_back(line);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static vector<LsmRunPtr> snapshotRuns(){
+//Description: Copies the run list, keeping every run alive while it is read.
+    lock_guard<mutex> guard(runsLock);
+    return runs;
+}
+
+//----------------------------------------------------------------------------
+static bool runFind(LsmRun& run, SailingKey sailing, const string& licensePlate,
+                    const string& key, unsigned long long hash, Booking& result){
+//Description: Looks a key up in one run: Bloom filter, then the fence
+//             keys, then one read of the block that can hold the key.
+    if (run.count == 0 || !bloomMayContain(run.bloom, hash)) return false;
+    size_t fence = upper_bound(run.fences.begin(), run.fences.end(), key) - run.fences.begin();
+    if (fence == 0) return false;
+    int first = static_cast<int>(fence - 1) * lsmFenceInterval;
+    int count = min(lsmFenceInterval, run.count - first);
+
+    Booking block[lsmFenceInterval];
+    run.reader.clear();
+    run.reader.seekg(static_cast<streampos>(recordOffset(first)), ios::beg);
+    run.reader.read(reinterpret_cast<char*>(block), static_cast<streamsize>(count) * sizeof(Booking));
+    int got = static_cast<int>(run.reader.gcount() / static_cast<streamsize>(sizeof(Booking)));
+
+    Booking probe;  //Zero-filled, so its key bytes match a stored record's
+    probe.setSailingKey(sailing);
+    probe.setLicensePlate(licensePlate);
+    if (!probe.hasLicensePlate(licensePlate)) return false;  //Cannot be stored
+    int hit = findRecordKey(block, sizeof(Booking), got, Booking::sailingKeyOffset(),
+                            reinterpret_cast<const char*>(&probe) + Booking::sailingKeyOffset(), Booking::keyBytes());
+    if (hit < 0) return false;
+    result = block[hit];
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool lookupKey(SailingKey sailing, const string& licensePlate, Booking& result){
+//Description: Returns the newest record of a key, tombstone or not, from
+//             the memtable or the newest run that has it.
+    string key = lsmKey(sailing, licensePlate.c_str());
+    map<string, Booking>::const_iterator it = memtable.find(key);
+    if (it != memtable.end()){
+        result = it->second;
+        return true;
+    }
+    unsigned long long hash = hashKey64(key);
+    vector<LsmRunPtr> current = snapshotRuns();
+    for (size_t i = current.size(); i-- > 0; ){
+        if (runFind(*current[i], sailing, licensePlate, key, hash, result)) return true;
+    }
+    return false;
+}
+
+//One input of a merge: a run read in blocks, or the memtable
+struct LsmSource{
+    LsmSource() : fromMemtable(false), pos(0), fill(0), remaining(0), valid(false){}
+    bool fromMemtable;
+    map<string, Booking>::const_iterator at, end;
+    ifstream in;
+    vector<Booking> block;
+    size_t pos, fill;
+    long long remaining;  //Records of the run not yet read into block
+    Booking current;
+    string key;
+    bool valid;           //current holds a record
+};
+
+//----------------------------------------------------------------------------
+static void advanceSource(LsmSource& source){
+//Description: Moves a source to its next record.
+    if (source.fromMemtable){
+        source.valid = source.at != source.end;
+        if (source.valid){
+            source.key = source.at->first;
+            source.current = source.at->second;
+            ++source.at;
+        }
+        return;
+    }
+    if (source.pos == source.fill){
+        source.pos = 0;
+        source.fill = 0;
+        if (source.remaining > 0){
+            size_t want = static_cast<size_t>(min<long long>(source.remaining, lsmBlockRecords));
+            source.in.read(reinterpret_cast<char*>(&source.block[0]), static_cast<streamsize>(want * sizeof(Booking)));
+            source.fill = static_cast<size_t>(source.in.gcount()) / sizeof(Booking);
+            source.remaining = source.fill == want ? source.remaining - static_cast<long long>(want) : 0;
+        }
+        if (source.fill == 0){
+            source.valid = false;
+            return;
+        }
+    }
+    source.current = source.block[source.pos++];
+    source.key = recordKey(source.current);
+    source.valid = true;
+}
+
+//Merged, key-ordered view over a set of sources (newest first)
+struct LsmMergeCursor::State{
+    State() : keepTombstones(false){}
+    vector<LsmRunPtr> runs;                      //Keeps the runs alive
+    vector<unique_ptr<LsmSource> > sources;     //Newest first
+    bool keepTombstones;
+
+    void open(const vector<LsmRunPtr>& inputs, bool withMemtable, const string& fromKey, bool tombstones);
+    bool next(Booking& result);
+};
+
+//----------------------------------------------------------------------------
+void LsmMergeCursor::State::open(const vector<LsmRunPtr>& inputs, bool withMemtable,
+                                 const string& fromKey, bool tombstones){
+//Description: Positions one source per input at the first key not below
+//             fromKey, using the fence keys to skip whole blocks of a run.
+    runs = inputs;
+    keepTombstones = tombstones;
+    sources.clear();
+    if (withMemtable){
+        unique_ptr<LsmSource> source(new LsmSource);
+        source->fromMemtable = true;
+        source->at = fromKey.empty() ? memtable.begin() : memtable.lower_bound(fromKey);
+        source->end = memtable.end();
+        advanceSource(*source);
+        sources.push_back(move(source));
+    }
+    for (size_t i = runs.size(); i-- > 0; ){
+        const LsmRun& run = *runs[i];
+        unique_ptr<LsmSource> source(new LsmSource);
+        source->in.open(run.fileName.c_str(), ios::binary);
+        source->block.resize(lsmBlockRecords);
+        size_t fence = upper_bound(run.fences.begin(), run.fences.end(), fromKey) - run.fences.begin();
+        long long first = fence == 0 ? 0 : static_cast<long long>(fence - 1) * lsmFenceInterval;
+        source->in.seekg(static_cast<streampos>(recordOffset(first)), ios::beg);
+        source->remaining = source->in ? run.count - first : 0;
+        advanceSource(*source);
+        while (source->valid && source->key < fromKey) advanceSource(*source);
+        sources.push_back(move(source));
+    }
+}
+
+//----------------------------------------------------------------------------
+bool LsmMergeCursor::State::next(Booking& result){
+//Description: Takes the smallest key among the sources; on a tie the
+//             newest source wins and the older copies are skipped.
+    for (;;){
+        int best = -1;
+        for (size_t i = 0; i < sources.size(); ++i){
+            if (sources[i]->valid && (best < 0 || sources[i]->key < sources[best]->key)) best = static_cast<int>(i);
+        }
+        if (best < 0) return false;
+
+        result = sources[best]->current;
+        string key = sources[best]->key;
+        for (size_t i = 0; i < sources.size(); ++i){
+            if (sources[i]->valid && sources[i]->key == key) advanceSource(*sources[i]);
+        }
+        if (keepTombstones || !result.isDeleted()) return true;
+    }
+}
+
+//----------------------------------------------------------------------------
+LsmMergeCursor::LsmMergeCursor(const string& fromSailingID) : state(new State){
+//Description: Opens a view over the memtable and a snapshot of the runs.
+    state->open(snapshotRuns(), true, fromSailingID.empty() ? string() : lsmKey(packSailingKey(fromSailingID), ""), false);
+}
+
+//----------------------------------------------------------------------------
+LsmMergeCursor::~LsmMergeCursor(){
+//Description: Closes the run readers.
+    delete state;
+}
+
+//----------------------------------------------------------------------------
+bool LsmMergeCursor::next(Booking& result){
+//Description: Returns the next live booking.
+    return state->next(result);
+}
+
+//----------------------------------------------------------------------------
+static int runTier(int count){
+//Description: Size class of a run: 0 below lsmMergeFanIn memtables,
+//             then one more for every further factor of lsmMergeFanIn.
+    int tier = 0;
+    long long limit = static_cast<long long>(lsmMemtableLimit) * lsmMergeFanIn;
+    while (count >= limit){
+        ++tier;
+        limit *= lsmMergeFanIn;
+    }
+    return tier;
+}
+
+//----------------------------------------------------------------------------
+static bool pickMerge(size_t& first, size_t& count){
+//Description: Chooses the newest runs that share the size class of the
+//             newest one, if there are at least lsmMergeFanIn of them.
+//             The caller holds runsLock.
+    if (runs.size() < static_cast<size_t>(lsmMergeFanIn)) return false;
+    int tier = runTier(runs.back()->count);
+    first = runs.size() - 1;
+    while (first > 0 && runTier(runs[first - 1]->count) <= tier) --first;
+    count = runs.size() - first;
+    return count >= static_cast<size_t>(lsmMergeFanIn);
+}
+
+//----------------------------------------------------------------------------
+static bool mergeRuns(const vector<LsmRunPtr>& inputs, size_t first, int seq){
+//Description: Merges consecutive runs into one new run and swaps it into
+//             the list in their place. Tombstones are kept unless the
+//             oldest run is among the inputs, since they may still hide
+//             older copies.
+    LsmMergeCursor::State state;
+    state.open(inputs, false, string(), first != 0);
+    size_t expected = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) expected += static_cast<size_t>(inputs[i]->count);
+
+    LsmRunPtr merged;
+    if (!writeRun(runFileName(seq), expected,
+                  [&](Booking& record){ return state.next(record); }, merged)){
+        remove(runFileName(seq).c_str());
+        return false;
+    }
+
+    lock_guard<mutex> guard(runsLock);
+    runs.erase(runs.begin() + first, runs.begin() + first + inputs.size());
+    if (merged) runs.insert(runs.begin() + first, merged);
+    if (!writeManifest()){
+        if (merged){
+            runs.erase(runs.begin() + first);
+            merged->obsolete = true;
+        }
+        runs.insert(runs.begin() + first, inputs.begin(), inputs.end());
+        return false;
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) inputs[i]->obsolete = true;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static void mergeLoop(){
+//Description: Body of the merge thread: merges until no size class has
+//             lsmMergeFanIn runs (one merge can make the next one due).
+    for (;;){
+        vector<LsmRunPtr> inputs;
+        size_t first = 0;
+        size_t count = 0;
+        int seq = 0;
+        {
+            lock_guard<mutex> guard(runsLock);
+            if (!pickMerge(first, count)) break;
+            inputs.assign(runs.begin() + first, runs.begin() + first + count);
+            seq = nextRunSeq++;
+        }
+        if (!mergeRuns(inputs, first, seq)) break;
+    }
+    mergeRunning = false;
+}
+
+//----------------------------------------------------------------------------
+static void waitForMerge(){
+//Description: Waits for the merge thread, if any, to finish.
+    if (mergeThread.worker.joinable()) mergeThread.worker.join();
+}
+
+//----------------------------------------------------------------------------
+static void startMergeIfDue(){
+//Description: Starts the merge thread when a size class is full and no
+//             merge is already running.
+    if (mergeRunning) return;
+    waitForMerge();
+    {
+        lock_guard<mutex> guard(runsLock);
+        size_t first;
+        size_t count;
+        if (!pickMerge(first, count)) return;
+    }
+    mergeRunning = true;
+    mergeThread.worker = thread(mergeLoop);
+}
+
+//----------------------------------------------------------------------------
+static bool emptyJournal(fstream& journalFile){
+//Description: Truncates the journal down to its header (logged first) and
+//             reopens the stream.
+    journalFile.close();
+    logFileTruncate(fileNameBookingLsm, recordFileHeaderBytes);
+    bool truncated = truncate(fileNameBookingLsm.c_str(), static_cast<off_t>(recordFileHeaderBytes)) == 0;
+    journalFile.open(fileNameBookingLsm, ios::in | ios::out | ios::binary);
+    if (truncated) journalRecords = 0;
+    return truncated && journalFile.is_open();
+}
+
+//----------------------------------------------------------------------------
+static bool flushMemtable(fstream& journalFile){
+//Description: Writes the memtable out as the newest run, records it in the
+//             manifest, then empties the journal and the memtable. If the
+//             journal cannot be emptied the memtable is kept, so its
+//             entries are never older than the journal they replay from.
+    if (memtable.empty()) return true;
+    int seq;
+    {
+        lock_guard<mutex> guard(runsLock);
+        seq = nextRunSeq++;
+    }
+    map<string, Booking>::const_iterator at = memtable.begin();
+    LsmRunPtr run;
+    if (!writeRun(runFileName(seq), memtable.size(), [&](Booking& record){
+            if (at == memtable.end()) return false;
+            record = at->second;
+            ++at;
+            return true;
+        }, run) || !run){
+        remove(runFileName(seq).c_str());
+        return false;
+    }
+    {
+        lock_guard<mutex> guard(runsLock);
+        runs.push_back(run);
+        if (!writeManifest()){
+            runs.pop_back();
+            run->obsolete = true;
+            return false;
+        }
+    }
+    if (!emptyJournal(journalFile)) return false;
+    memtable.clear();
+    memtableTxn = 0;
+    startMergeIfDue();
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static void flushIfFull(fstream& journalFile){
+//Description: Flushes a full memtable unless it holds writes of the open
+//             write-ahead log transaction.
+    if (static_cast<int>(memtable.size()) < lsmMemtableLimit) return;
+    unsigned int txn = getWalTransactionId();
+    if (txn != 0 && txn == memtableTxn) return;
+    flushMemtable(journalFile);
+}
+
+//----------------------------------------------------------------------------
+static bool appendToJournal(fstream& journalFile, const Booking& record){
+//Description: Appends a record to the journal (logged first), then
+//             applies it to the memtable.
+    long long offset = recordFileHeaderBytes + journalRecords * static_cast<long long>(sizeof(Booking));
+    journalFile.clear();
+    journalFile.seekp(static_cast<streampos>(offset), ios::beg);
+    logRecordWrite(fileNameBookingLsm, offset, &record, sizeof(Booking));
+    journalFile.write(reinterpret_cast<const char*>(&record), sizeof(Booking));
+    journalFile.flush();
+    if (!journalFile.good()) return false;
+    ++journalRecords;
+    memtable[recordKey(record)] = record;
+    memtableTxn = getWalTransactionId();
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static void countOut(SailingKey sailing){
+//Description: Takes one booking off the live count and the sailing tally.
+    --liveCount;
+    unordered_map<SailingKey, int>::iterator it = sailingCounts.find(sailing);
+    if (it != sailingCounts.end() && --it->second <= 0) sailingCounts.erase(it);
+}
+
+//----------------------------------------------------------------------------
+bool openBookingLsmStore(fstream& journalFile){
+//Description: Loads the runs named in the manifest, replays the journal
+//             into the memtable and counts the live bookings.
+    waitForMerge();
+    storeOpen = false;
+    memtable.clear();
+    memtableTxn = 0;
+    journalRecords = 0;
+    liveCount = 0;
+    sailingCounts.clear();
+    {
+        lock_guard<mutex> guard(runsLock);
+        runs.clear();
+        nextRunSeq = 1;
+    }
+    if (!journalFile.is_open() || !claimDataFile(fileNameBookingLsm)) return false;
+
+    vector<string> fileNames;
+    if (!readManifest(fileNames)) return false;
+    vector<LsmRunPtr> loaded;
+    int seq = 1;
+    for (size_t i = 0; i < fileNames.size(); ++i){
+        LsmRunPtr run;
+        if (!loadRun(fileNames[i], run)) return false;
+        loaded.push_back(run);
+        seq = max(seq, runSeqOf(fileNames[i]) + 1);
+    }
+    {
+        lock_guard<mutex> guard(runsLock);
+        runs = loaded;
+        nextRunSeq = seq;
+    }
+
+    //An empty journal gets its header (logged); any other must have this one
+    journalFile.clear();
+    journalFile.seekg(0, ios::end);
+    long long journalBytes = static_cast<long long>(journalFile.tellg());
+    if (journalBytes == 0){
+        logRecordWrite(fileNameBookingLsm, 0, &journalHeader, sizeof(journalHeader));
+        journalFile.seekp(0, ios::beg);
+        journalFile.write(reinterpret_cast<const char*>(&journalHeader), sizeof(journalHeader));
+        journalFile.flush();
+        if (!journalFile.good()) return false;
+        journalBytes = recordFileHeaderBytes;
+    }
+    RecordFileHeader found;
+    journalFile.seekg(0, ios::beg);
+    if (journalBytes < recordFileHeaderBytes || !journalFile.read(reinterpret_cast<char*>(&found), sizeof(found)) ||
+        memcmp(&found, &journalHeader, sizeof(found)) != 0){
+        return false;
+    }
+
+    //Replay the journal; a torn record at the end is overwritten by the next append
+    journalRecords = (journalBytes - recordFileHeaderBytes) / static_cast<long long>(sizeof(Booking));
+    vector<Booking> block(lsmBlockRecords);
+    for (long long first = 0; first < journalRecords; first += static_cast<long long>(block.size())){
+        long long count = min<long long>(static_cast<long long>(block.size()), journalRecords - first);
+        if (!journalFile.read(reinterpret_cast<char*>(&block[0]), static_cast<streamsize>(count * sizeof(Booking)))) return false;
+        for (long long i = 0; i < count; ++i) memtable[recordKey(block[i])] = block[i];
+    }
+
+    LsmMergeCursor::State state;
+    state.open(loaded, true, string(), false);
+    Booking booking;
+    while (state.next(booking)){
+        ++liveCount;
+        ++sailingCounts[booking.getSailingKey()];
+    }
+    storeOpen = true;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool lsmStoreReady(fstream& journalFile){
+//Description: Opens the store if it has not been opened yet.
+    if (storeOpen) return true;
+    if (!journalFile.is_open()) return false;
+    return openBookingLsmStore(journalFile);
+}
+
+//----------------------------------------------------------------------------
+void closeBookingLsmStore(fstream& journalFile){
+//Description: Leaves an empty journal behind and joins the merge thread.
+    if (!storeOpen) return;
+    flushMemtable(journalFile);
+    waitForMerge();
+    storeOpen = false;
+}
+
+//----------------------------------------------------------------------------
+bool lsmStoreFind(fstream& journalFile, const string& sailingID, const string& licensePlate, Booking& result){
+//Description: Returns the newest copy of the key unless it is a tombstone.
+    if (!lsmStoreReady(journalFile)) return false;
+    return lookupKey(packSailingKey(sailingID), licensePlate, result) && !result.isDeleted();
+}
+
+//----------------------------------------------------------------------------
+bool lsmStorePut(fstream& journalFile, const Booking& booking){
+//Description: Appends the booking and counts it if the key was not live.
+    if (!lsmStoreReady(journalFile)) return false;
+    flushIfFull(journalFile);
+    Booking record = booking;
+    record.setDeleted(false);
+
+    Booking existing;
+    bool existed = lookupKey(record.getSailingKey(), record.getLicensePlate(), existing) && !existing.isDeleted();
+    if (!appendToJournal(journalFile, record)) return false;
+    if (!existed){
+        ++liveCount;
+        ++sailingCounts[record.getSailingKey()];
+    }
+    flushIfFull(journalFile);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool lsmStoreErase(fstream& journalFile, const string& sailingID, const string& licensePlate){
+//Description: Appends a tombstone for a live key.
+    if (!lsmStoreReady(journalFile)) return false;
+    flushIfFull(journalFile);
+    Booking existing;
+    if (!lookupKey(packSailingKey(sailingID), licensePlate, existing) || existing.isDeleted()) return false;
+    existing.setDeleted(true);
+    if (!appendToJournal(journalFile, existing)) return false;
+    countOut(existing.getSailingKey());
+    flushIfFull(journalFile);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+int lsmStoreEraseSailing(fstream& journalFile, const string& sailingID){
+//Description: Collects the sailing's bookings with a cursor that starts at
+//             the sailing, then appends their tombstones as one transaction.
+//             If one fails the transaction is rolled back and the store
+//             reopened from the restored journal, so all of them stay.
+    if (!lsmStoreReady(journalFile)) return 0;
+    SailingKey sailing = packSailingKey(sailingID);
+    if (sailingCounts.find(sailing) == sailingCounts.end()) return 0;
+
+    vector<Booking> victims;
+    {
+        LsmMergeCursor cursor(sailingID);
+        Booking booking;
+        while (cursor.next(booking) && booking.getSailingKey() == sailing) victims.push_back(booking);
+    }
+
+    beginWalTransaction();
+    for (size_t i = 0; i < victims.size(); ++i){
+        victims[i].setDeleted(true);
+        if (!appendToJournal(journalFile, victims[i])){
+            abortWalTransaction();
+            openBookingLsmStore(journalFile);  //Memtable and tallies follow the journal
+            return 0;
+        }
+        countOut(sailing);
+    }
+    commitWalTransaction();
+    flushIfFull(journalFile);
+    return static_cast<int>(victims.size());
+}
+
+//----------------------------------------------------------------------------
+bool lsmStoreCompact(fstream& journalFile){
+//Description: Flushes, waits for the background merge, then merges every
+//             run into one without tombstones.
+    if (!lsmStoreReady(journalFile)) return false;
+    if (!flushMemtable(journalFile)) return false;
+    waitForMerge();
+
+    vector<LsmRunPtr> inputs;
+    int seq;
+    {
+        lock_guard<mutex> guard(runsLock);
+        if (runs.empty()) return true;
+        inputs = runs;
+        seq = nextRunSeq++;
+    }
+    return mergeRuns(inputs, 0, seq);
+}
+
+//----------------------------------------------------------------------------
+int lsmStoreCount(fstream& journalFile){
+//Description: Returns the number of live bookings.
+    return lsmStoreReady(journalFile) ? liveCount : 0;
+}
+
+//----------------------------------------------------------------------------
+int lsmStoreCountSailing(fstream& journalFile, const string& sailingID){
+//Description: Returns the sailing's tally.
+    if (!lsmStoreReady(journalFile)) return 0;
+    unordered_map<SailingKey, int>::const_iterator it = sailingCounts.find(packSailingKey(sailingID));
+    return it == sailingCounts.end() ? 0 : it->second;
+}
+
+//----------------------------------------------------------------------------
+int lsmStoreRunCount(){
+//Description: Returns the length of the run list.
+    lock_guard<mutex> guard(runsLock);
+    return static_cast<int>(runs.size());
+}
@@ -0,0 +1,177 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: BookingLsmStore.h
+// Rev.3 - 18/10/2026 - lsmStoreEraseSailing removes all of a sailing's
+//                      bookings or none.
+// Rev.2 - 18/10/2026 - Journals and runs of another Booking layout are refused.
+// Rev.1 - 17/10/2026 - Interface for the log-structured (LSM) booking store.
+//
+// ----------------------------------------------------------------------------
+// This header declares a write-optimized storage engine for bookings, meant
+// for bursts such as a popular sailing opening for sale.
+//
+// - New bookings, updates and deletes go to an in-memory sorted memtable and
+//   are appended to a journal file (booking.lsm) so nothing is lost.
+// - A full memtable is flushed to an immutable sorted run file with a Bloom
+//   filter. The list of live runs is kept in a manifest.
+// - Once enough runs pile up, a background thread merges them into one,
+//   dropping overwritten records and deletes.
+// - A lookup checks the memtable, then each run from newest to oldest;
+//   the Bloom filters let almost every run that lacks the key be skipped
+//   without a read.
+//
+// Selected through BookingFileIO.h; the other modules never call this one
+// directly.
+// ----------------------------------------------------------------------------
+
+#ifndef BOOKING_LSM_STORE_H
+#define BOOKING_LSM_STORE_H
+
+#include "BookingUserIO.h"
+#include <fstream>
+#include <string>
+using namespace std;
+
+const string fileNameBookingLsm = "booking.lsm";                   //Journal of the memtable
+const string fileNameBookingLsmManifest = "booking.lsm.manifest";  //List of live runs
+const int lsmMemtableLimit = 4096;     //Memtable entries that trigger a flush
+const int lsmMergeFanIn = 4;           //Runs that trigger a background merge
+const int lsmFenceInterval = 64;       //Records per fence (sparse in-memory index)
+const int lsmBloomBitsPerKey = 10;     //About 1% false positives with 7 probes
+
+//Sequential, merged view over the memtable and every run (newest wins)
+class LsmMergeCursor{
+public:
+    explicit LsmMergeCursor(const string& fromSailingID = string()//input
+                            );
+    //Job: Opens a merged view starting at the first booking of fromSailingID
+    //     (or at the first booking of all when it is empty).
+    //Usage: Used by lsmStoreScan and by per-sailing reads.
+    //Restrictions: The store must already be open.
+
+    ~LsmMergeCursor();
+
+//----------------------------------------------------------------------------
+    bool next(Booking& result//output
+              );
+    //Job: Returns the next live booking in (SailingID, License Plate) order.
+    //Usage: Called in a loop by lsmStoreScan.
+    //Restrictions: Returns false at the end. The store must not be changed
+    //              while a cursor is in use.
+
+//----------------------------------------------------------------------------
+    struct State;  //Merge state, defined in BookingLsmStore.cpp (also drives run merges)
+
+private:
+    LsmMergeCursor(const LsmMergeCursor&);
+    LsmMergeCursor& operator=(const LsmMergeCursor&);
+    State* state;  //Per-run readers and the memtable position
+};
+
+//----------------------------------------------------------------------------
+bool openBookingLsmStore(fstream& journalFile//input
+                         );
+//Job: Loads the manifest and the runs it lists, replays the journal into
+//     the memtable, and counts the live bookings with one merged pass.
+//Usage: Called through buildBookingIndex at startup.
+//Restrictions: journalFile must be booking.lsm, open in binary read/write mode.
+//              Returns false if the journal or a run was written for
+//              another Booking layout.
+
+//----------------------------------------------------------------------------
+void closeBookingLsmStore(fstream& journalFile//input
+                          );
+//Job: Flushes the memtable and waits for a background merge to finish.
+//Usage: Called through closeBookingStore before the program exits.
+//Restrictions: Must not be called inside a write-ahead log transaction.
+
+//----------------------------------------------------------------------------
+bool lsmStoreFind(fstream& journalFile,       //input
+                  const string& sailingID,    //input
+                  const string& licensePlate, //input
+                  Booking& result             //output
+                  );
+//Job: Looks up a booking by key.
+//Usage: Backs loadBookingByKey.
+//Restrictions: Returns false if not found or deleted.
+
+//----------------------------------------------------------------------------
+bool lsmStorePut(fstream& journalFile, //input
+                 const Booking& booking//input
+                 );
+//Job: Inserts or replaces a booking.
+//Usage: Backs writeBooking.
+//Restrictions: A full memtable is flushed only when it holds no writes of
+//              the open write-ahead log transaction, so a run never
+//              contains work that could still be rolled back.
+
+//----------------------------------------------------------------------------
+bool lsmStoreErase(fstream& journalFile,       //input
+                   const string& sailingID,    //input
+                   const string& licensePlate  //input
+                   );
+//Job: Deletes a booking by recording a tombstone for its key.
+//Usage: Backs deleteBookingRecord.
+//Restrictions: Returns false if not found.
+
+//----------------------------------------------------------------------------
+int lsmStoreEraseSailing(fstream& journalFile,   //input
+                         const string& sailingID //input
+                         );
+//Job: Records a tombstone for every booking on a sailing.
+//Usage: Backs deleteBookingsBySailingID.
+//Restrictions: Returns the number of bookings removed; 0, with every
+//              booking kept, if a tombstone cannot be appended.
+
+//----------------------------------------------------------------------------
+bool lsmStoreCompact(fstream& journalFile//input
+                     );
+//Job: Flushes the memtable and merges every run into one, in the foreground.
+//Usage: Backs compactBookingFile.
+//Restrictions: Must not be called inside a write-ahead log transaction.
+
+//----------------------------------------------------------------------------
+int lsmStoreCount(fstream& journalFile//input
+                  );
+//Job: Returns the number of live bookings.
+//Usage: Backs countBookingRecords.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+int lsmStoreCountSailing(fstream& journalFile,   //input
+                         const string& sailingID //input
+                         );
+//Job: Returns the number of bookings on a sailing from an in-memory tally.
+//Usage: Backs countBookingsForSailing.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+bool lsmStoreReady(fstream& journalFile//input
+                   );
+//Job: Opens the store on first use.
+//Usage: Called by lsmStoreScan and by callers that create their own cursor.
+//Restrictions: Returns false if the store cannot be opened.
+
+//----------------------------------------------------------------------------
+int lsmStoreRunCount();
+//Job: Returns the number of sorted runs currently listed in the manifest.
+//Usage: Used by tests and diagnostics.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+template<class Visitor>
+void lsmStoreScan(fstream& journalFile, //input
+                  Visitor visit         //input
+                  ){
+//Job: Calls visit(booking) for every live booking in key order.
+//Usage: Backs the full-scan functions of BookingFileIO.h.
+//Restrictions: visit returns false to stop early; it must not modify the store.
+    if (!lsmStoreReady(journalFile)) return;
+    LsmMergeCursor cursor;
+    Booking booking;
+    while (cursor.next(booking)){
+        if (!visit(booking)) return;
+    }
+}
+
+#endif //BOOKING_LSM_STORE_H
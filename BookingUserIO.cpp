@@ -1,6 +1,24 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: BookingUserIO.cpp
+// Rev.13 - 18/10/2026 - A failed check-in rebuilds the booking index and drops
+//                       the sailing's counters, like booking and delete.
+// Rev.12 - 18/10/2026 - Booking, check-in and delete roll their transaction
+//                       back when a step fails instead of committing the rest.
+// Rev.11 - 17/10/2026 - Added Booking::hasLicensePlate and hasKey.
+// Rev.10 - 17/10/2026 - Added Booking::sailingKeyOffset and keyBytes.
+// Rev.9 - 17/10/2026 - The SailingID is packed into a SailingKey when set.
+// Rev.8 - 17/10/2026 - createBooking reserves deck space before writing the
+//                      booking; bookings and deletes go through SailingCapacity.
+// Rev.7 - 17/10/2026 - checkIn flips the check-in flag in place with
+//                      markCheckedIn instead of deleting and re-appending.
+// Rev.6 - 17/10/2026 - Booking, check-in and delete keep the sailing's vehicle
+//                      counts up to date with its capacities.
+// Rev.5 - 17/10/2026 - Added the Booking tombstone flag accessors.
+// Rev.4 - 17/10/2026 - Multi-record workflows run as write-ahead log transactions;
+//                      a new vehicle is now saved together with its booking.
+// Rev.3 - 17/10/2026 - createBooking validates the SailingID format before the
+//                      single index lookup instead of looking it up twice.
 // Rev.2 - 05/08/2025 - Updated user input logic to correctly check for blank inputs.
 //                    - Functions now clear the terminal before outputting their result.
 // Rev.1 - 24/07/2025 - Initial implementation of Booking class and UI functions.
@@ -23,7 +41,9 @@
 #include "SailingUserIO.h"
 #include "BookingFileIO.h"
 #include "SailingFileIO.h"
+#include "SailingCapacity.h"
 #include "UserInterface.h"
+#include "WriteAheadLog.h"
 #include <iostream>
 #include <fstream>
 #include <cstring>
@@ -42,13 +62,13 @@ Booking::Booking(const string& licensePlate,
     strncpy(this->licensePlate, licensePlate.c_str(), sizeof(this->licensePlate) - 1);
     this->licensePlate[sizeof(this->licensePlate) - 1] = '\0';
 
-    strncpy(this->sailingId, sailingId.c_str(), sizeof(this->sailingId) - 1);
-    this->sailingId[sizeof(this->sailingId) - 1] = '\0';
+    this->sailingKey = packSailingKey(sailingId);
 
     strncpy(this->phoneNumber, phoneNumber.c_str(), sizeof(this->phoneNumber) - 1);
     this->phoneNumber[sizeof(this->phoneNumber) - 1] = '\0';
 
     this->checkedIn = checkedIn;
+    this->deleted = false;
 }
 
 //----------------------------------------------------------------------------
@@ -68,7 +88,7 @@ void createBooking(fstream& vehicleFile,
             cout << endl << "Enter pressed. Now aborting to the previous Menu" << endl;
             return;
         }
-        if (findSailingIndexByID(sailingFile, sailingId) == -1){
+        if (!isValidSailingID(sailingId)){
             cout << "Bad entry! Sailing ID format is ccc-dd-dd." << endl;
             continue;
         }
@@ -104,8 +124,9 @@ void createBooking(fstream& vehicleFile,
 
     float height, length;
 
-    //If vehicle is new, ask for its dimensions and save
-    if (!isVehicleExist(vehicleFile, plate)){
+    //If vehicle is new, ask for its dimensions (saved along with the booking)
+    bool newVehicle = !isVehicleExist(vehicleFile, plate);
+    if (newVehicle){
         //Input and validate height
         while (true){
             cout << "Enter height (0 to " << maxHeight << "): ";
@@ -131,11 +152,6 @@ void createBooking(fstream& vehicleFile,
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             break;
         }
-
-        Vehicle v(plate, height, length);
-        if (!writeVehicle(vehicleFile, v)){
-            cerr << "Error: Unable to append vehicle record." << endl;
-        }
     } else{
         //Retrieve vehicle dimensions from file
         if (!getVehicleDimensions(vehicleFile, plate, length, height)){
@@ -172,32 +188,37 @@ void createBooking(fstream& vehicleFile,
         break;
     }
 
-    Booking b(plate, sailingId, phone, false);
-    if (!writeBooking(b, bookingFile)){
+    bool isSpecial = (height > maxHeightForRegularSizedVehicle || length > maxLengthForRegularSizedVehicle);
+    float regularLengthUsed = isSpecial ? 0.0f : length;
+    float specialLengthUsed = isSpecial ? length : 0.0f;
+
+    //Capacity, vehicle and booking are committed as one operation. The deck
+    //space is reserved first, so a full sailing is refused before anything
+    //is written; if a later step fails, everything is rolled back.
+    beginWalTransaction();
+    bool booked = false;
+    if (!reserveSailingCapacity(sailingFile, sailingId, regularLengthUsed, specialLengthUsed)){
+        cerr << "Error: The vessel does not have enough space to fit this vehicle." << endl;
+        cout << "Would you like to create another booking? (Y/N) ";
+    } else if (newVehicle && !writeVehicle(vehicleFile, Vehicle(plate, height, length))){
+        cerr << "Error: Unable to append vehicle record." << endl;
+    } else if (!writeBooking(Booking(plate, sailingId, phone, false), bookingFile)){
         cerr << "Error: Unable to append booking record." << endl;
     } else{
-        
-        // Update sailing capacity
-        bool isSpecial = (height > maxHeightForRegularSizedVehicle || length > maxLengthForRegularSizedVehicle);
-        if(isSpecial){
-            system("cls");
-            cout << "Special-sized vehicle with a \'" << plate 
-            << "\' license plate has been booked for sailing "
-            << sailingId << ". Would you like to create another booking? (Y/N) ";
-        }
-        else{
-            system("cls");
-            cout << "Normal-sized vehicle with a \'" << plate 
-            << "\' license plate has been booked for sailing "
-            << sailingId << ". Would you like to create another booking? (Y/N) ";
-        }
-        float regularLengthUsed = isSpecial ? 0.0f : length;
-        float specialLengthUsed = isSpecial ? length : 0.0f;
-
-        if (!updateSailingCapacities(sailingFile, sailingId, regularLengthUsed, specialLengthUsed)) {
-            cerr << "Error: The vessel does not have enough space to fit this vehicle." << endl;
-        }
+        booked = true;
+        system("cls");
+        cout << (isSpecial ? "Special" : "Normal") << "-sized vehicle with a \'" << plate
+             << "\' license plate has been booked for sailing "
+             << sailingId << ". Would you like to create another booking? (Y/N) ";
     }
+    if (booked){
+        commitWalTransaction();
+    } else{
+        abortWalTransaction();
+        buildBookingIndex(bookingFile);
+        forgetSailingCapacity(sailingId);  //Counters reload from the restored record
+    }
+
     string resp;
     getline(cin, resp);
     resp = trim(resp);
@@ -210,7 +231,7 @@ void checkIn(fstream& bookingFile,
              fstream& vehicleFile,
              fstream& sailingFile){
 //Description: Marks a booking as checked in and recalculates fare.
-//             Rewrites the record with checkedIn=true.
+//             Only the record's checkedIn byte is rewritten, in place.
 
     while (true){
         string sid, plate;
@@ -276,16 +297,24 @@ void checkIn(fstream& bookingFile,
         cout << "The fare is " << fare << ". Press <enter> once it has been collected.";
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-        //Replace record with updated (checked-in) version
-        if (!deleteBookingRecord(sid, plate, bookingFile)){
-            cerr << "Error: Unable to delete old booking record." << endl;
-            return;
+        //Set the flag in place; the record keeps its position. The LSM
+        //engine appends a copy instead, so a rollback reloads the store.
+        beginWalTransaction();
+        bool checkedIn = false;
+        if (!markCheckedIn(sid, plate, bookingFile)){
+            cerr << "Error: Unable to update the booking record." << endl;
+        } else if (!updateSailingCapacities(sailingFile, sid, 0.0f, 0.0f, 0, 1)){
+            cerr << "Error: Unable to update the sailing's checked-in count." << endl;
+        } else{
+            checkedIn = true;
         }
-
-        Booking updated(plate, sid, found.getPhoneNumber(), true);
-        if (!writeBooking(updated, bookingFile)){
-            cerr << "Error: Unable to append updated booking record." << endl;
+        if (!checkedIn){
+            abortWalTransaction();
+            buildBookingIndex(bookingFile);
+            forgetSailingCapacity(sid);  //Counters reload from the restored record
+            continue;
         }
+        commitWalTransaction();
 
         system("cls");
         cout << "Checked in \'" << plate << "\' onto " << sid << endl;
@@ -341,14 +370,19 @@ void promptToDeleteBooking(fstream& bookingFile, fstream& vehicleFile, fstream&
             float regularLengthRestored = isSpecial ? 0.0f : length;
             float specialLengthRestored = isSpecial ? length : 0.0f;
 
-            if (deleteBookingRecord(sid, plate, bookingFile)) {
-                cout << "Booking has been successfully deleted" << endl;
-                // Restore sailing capacity
-                if (!updateSailingCapacities(sailingFile, sid, -regularLengthRestored, -specialLengthRestored)) { // Note the negative sign to add back
-                    cerr << "Error: Failed to restore sailing capacity." << endl;
-                }
+            beginWalTransaction();
+            if (!deleteBookingRecord(sid, plate, bookingFile)) {
+                cout << "Error deleting booking." << endl;
+                abortWalTransaction();
+            } else if (!releaseSailingCapacity(sailingFile, sid, regularLengthRestored, specialLengthRestored,
+                                               bookingToDelete.getCheckedIn())) {
+                cerr << "Error: Failed to restore sailing capacity." << endl;
+                abortWalTransaction();  //The booking stays rather than losing its deck space
+                buildBookingIndex(bookingFile);
+                forgetSailingCapacity(sid);
             } else {
-                 cout << "Error deleting booking." << endl;
+                commitWalTransaction();
+                cout << "Booking has been successfully deleted" << endl;
             }
         } else {
             cout << "Could not find vehicle to restore capacity." << endl;
@@ -373,9 +407,13 @@ float calculateFare(const float& length, const float& height){
 //----------------------------------------------------------------------------
 void Booking::setSailingID(const string& id){
 //Description: Sets the SailingID (e.g., "YVR-08-10") for this booking.
-    strncpy(this->sailingId, id.c_str(), sizeof(this->sailingId) - 1);
+    this->sailingKey = packSailingKey(id);
+}
 
-    this->sailingId[sizeof(this->sailingId) - 1] = '\0'; //Force null termination
+//----------------------------------------------------------------------------
+void Booking::setSailingKey(SailingKey key){
+//Description: Sets the packed SailingID for this booking.
+    this->sailingKey = key;
 }
 
 //----------------------------------------------------------------------------
@@ -401,7 +439,7 @@ void Booking::setCheckedIn(bool status){
 //----------------------------------------------------------------------------
 string Booking::getSailingID() const{ 
 //Description: Returns the SailingID for this booking.
-    return sailingId; 
+    return unpackSailingKey(sailingKey); 
 }
 
 //----------------------------------------------------------------------------
@@ -416,6 +454,18 @@ string Booking::getPhoneNumber() const{
     return phoneNumber; 
 }
 
+//----------------------------------------------------------------------------
+bool Booking::hasLicensePlate(const string& plate) const{
+//Description: Compares the stored characters with plate, no copy made.
+    return plate.compare(licensePlate) == 0;
+}
+
+//----------------------------------------------------------------------------
+bool Booking::hasKey(SailingKey key, const string& plate) const{
+//Description: Integer compare first; the plate only on a SailingKey match.
+    return sailingKey == key && plate.compare(licensePlate) == 0;
+}
+
 //----------------------------------------------------------------------------
 bool Booking::getCheckedIn() const{ 
 //Description: Returns whether the booking has been checked in.
@@ -423,4 +473,37 @@ bool Booking::getCheckedIn() const{
 }
 
 //----------------------------------------------------------------------------
+void Booking::setDeleted(bool status){
+//Description: Sets or clears the tombstone flag.
+    this->deleted = status;
+}
+
+//----------------------------------------------------------------------------
+bool Booking::isDeleted() const{
+//Description: Returns whether this record is a tombstone.
+    return deleted;
+}
+
+//----------------------------------------------------------------------------
+size_t Booking::checkedInOffset(){
+//Description: Returns offsetof(Booking, checkedIn); members are private,
+//             so the offset is taken inside the class.
+    return offsetof(Booking, checkedIn);
+}
+
+//----------------------------------------------------------------------------
+size_t Booking::sailingKeyOffset(){
+//Description: Returns offsetof(Booking, sailingKey).
+    return offsetof(Booking, sailingKey);
+}
+
+//----------------------------------------------------------------------------
+size_t Booking::keyBytes(){
+//Description: Spans the SailingKey and the plate, which are adjacent.
+    static_assert(offsetof(Booking, licensePlate) == offsetof(Booking, sailingKey) + sizeof(SailingKey),
+                  "the license plate must follow the SailingKey");
+    return sizeof(SailingKey) + sizeof(licensePlate);
+}
+
+//----------------------------------------------------------------------------
 
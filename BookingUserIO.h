@@ -1,6 +1,11 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: BookingUserIO.h
+// Rev.7 - 17/10/2026 - Added non-allocating accessors and key-equality helpers.
+// Rev.6 - 17/10/2026 - Added Booking::sailingKeyOffset and keyBytes for scan kernels.
+// Rev.5 - 17/10/2026 - Booking records store the SailingID as a packed SailingKey.
+// Rev.4 - 17/10/2026 - Added Booking::checkedInOffset for in-place check-ins.
+// Rev.3 - 17/10/2026 - Booking records carry a tombstone flag for in-place deletes.
 // Rev.2 - 24/07/2025 - Changed the module name from 'Booking.h' to current
 //                    - Modified function declarations to match implementation
 // Rev.1 - 09/07/2025 - BookingUserIO module header created
@@ -21,6 +26,8 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <cstddef>
+#include "SailingKey.h"
 using namespace std;
 
 //Constants used in fare calculations and validation
@@ -34,7 +41,7 @@ const string fileNameBooking = "booking.txt";
 //Booking record class (fixed-length for binary I/O)
 class Booking{
 public:
-    Booking() = default;
+    Booking() : sailingKey(noSailingKey), licensePlate{0}, phoneNumber{0}, checkedIn(false), deleted(false){}
     Booking(const string& licensePlate,  //input
             const string& sailingId,     //input
             const string& phoneNumber,   //input
@@ -50,6 +57,12 @@ public:
     //Usage: Called when creating or editing a booking.
     //Restrictions: ID must be a valid formatted string (e.g., "YVR-08-10").
 
+//----------------------------------------------------------------------------
+    void setSailingKey(SailingKey key);
+    //Job: Sets the packed SailingID of the booking.
+    //Usage: Used where the key is already packed.
+    //Restrictions: None.
+
 //----------------------------------------------------------------------------
     void setLicensePlate(const string& plate);
     //Job: Sets the license plate for the booking.
@@ -74,6 +87,12 @@ public:
     //Usage: Used for searching, validation, or report output.
     //Restrictions: None.
 
+//----------------------------------------------------------------------------
+    SailingKey getSailingKey() const{ return sailingKey; }
+    //Job: Retrieves the packed SailingID of the booking.
+    //Usage: Used by the FileIO modules to compare, hash and sort bookings.
+    //Restrictions: None.
+
 //----------------------------------------------------------------------------
     string getLicensePlate() const;
     //Job: Retrieves the license plate from the booking.
@@ -86,17 +105,76 @@ public:
     //Usage: Used when contacting customers or displaying booking info.
     //Restrictions: None.
 
+//----------------------------------------------------------------------------
+    const char* getLicensePlateChars() const{ return licensePlate; }
+    //Job: Returns the license plate as it is stored in the record.
+    //Usage: Scan loops that must not build a string per record.
+    //Restrictions: Null-terminated; valid as long as the record is.
+
+//----------------------------------------------------------------------------
+    const char* getPhoneNumberChars() const{ return phoneNumber; }
+    //Job: Returns the phone number as it is stored in the record.
+    //Usage: Scan loops that must not build a string per record.
+    //Restrictions: Null-terminated; valid as long as the record is.
+
+//----------------------------------------------------------------------------
+    bool hasLicensePlate(const string& plate//input
+                         ) const;
+    //Job: Returns true if the booking is for this license plate.
+    //Usage: Compares in place, without copying the plate out.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    bool hasKey(SailingKey key,          //input
+                const string& plate      //input
+                ) const;
+    //Job: Returns true if the booking has this (SailingID, License Plate) key.
+    //Usage: Lookups and probes; the integer is compared first.
+    //Restrictions: None.
+
 //----------------------------------------------------------------------------
     bool getCheckedIn() const;
     //Job: Returns the check-in status of the booking.
     //Usage: Used in validation, reporting, or boarding checks.
     //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    void setDeleted(bool status);
+    //Job: Marks the record as a tombstone (deleted in place).
+    //Usage: Called by BookingFileIO when a booking is deleted.
+    //Restrictions: Tombstoned records are skipped by every scan and lookup.
+
+//----------------------------------------------------------------------------
+    bool isDeleted() const;
+    //Job: Returns whether the record is a tombstone.
+    //Usage: Used by BookingFileIO scans and compaction.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    static size_t checkedInOffset();
+    //Job: Returns the byte offset of the check-in flag within a record.
+    //Usage: Used by BookingFileIO to rewrite the flag in place.
+    //Restrictions: The flag is one byte (a bool).
+
+//----------------------------------------------------------------------------
+    static size_t sailingKeyOffset();
+    //Job: Returns the byte offset of the SailingKey within a record.
+    //Usage: Key field passed to findRecordKey (ScanKernel.h).
+    //Restrictions: The license plate follows it directly.
+
+//----------------------------------------------------------------------------
+    static size_t keyBytes();
+    //Job: Returns the width of the SailingKey and license plate fields
+    //     together, starting at sailingKeyOffset().
+    //Usage: Matches a whole booking key with one findRecordKey call.
+    //Restrictions: The plate is zero-padded, so equal keys have equal bytes.
 //----------------------------------------------------------------------------
 private:
-    char sailingId[16];      //Format: ccc-dd-dd (max 15 chars + null)
+    SailingKey sailingKey;   //Packed ccc-dd-hh (noSailingKey if unset)
     char licensePlate[16];   //Max 15 characters
     char phoneNumber[16];    //Max 15 characters
     bool checkedIn;          //Check-in status
+    bool deleted;            //Tombstone flag, reclaimed by compaction
 };
 
 //----------------------------------------------------------------------------
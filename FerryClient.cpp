@@ -0,0 +1,549 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: FerryClient.cpp
+// Rev.1 - 17/10/2026 - Implements the ferryqd terminal client and its menus.
+//
+// ----------------------------------------------------------------------------
+// This module runs a FerryQ terminal against a ferryqd server.
+//
+// Implementation Strategy:
+// - FerryClient sends one request line and blocks for its reply; replies
+//   with rows are read in full before request returns.
+// - The menus keep the prompts and input checks of the local console, so
+//   operators see the same screens. Format checks are made locally; every
+//   check against the data (sailing exists, booking exists, space left) is
+//   made by the server when the request arrives, and its message is shown.
+// - Rows are turned back into Sailing objects and printed with the same
+//   printSailingRow and pageSailingReport as the local reports.
+//
+// Used By: Called by main.cpp in client mode.
+// ----------------------------------------------------------------------------
+
+#include "FerryClient.h"
+#include "FerryProtocol.h"
+#include "SailingUserIO.h"
+#include "SailingReport.h"
+#include "VehicleFileIO.h"
+#include "UserInterface.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <regex>
+#include <cstring>
+#include <cstdlib>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+FerryClient::~FerryClient(){
+//Description: Closes the connection if still open.
+    disconnect();
+}
+
+#if !defined(_WIN32)
+
+//----------------------------------------------------------------------------
+bool FerryClient::connectTo(const string& socketPath){
+//Description: Opens a stream socket to the server's path.
+    disconnect();
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) return false;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0){
+        disconnect();
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+void FerryClient::disconnect(){
+//Description: Closes the socket and forgets unread bytes.
+    if (fd >= 0) close(fd);
+    fd = -1;
+    buffer.clear();
+}
+
+#else
+
+//----------------------------------------------------------------------------
+bool FerryClient::connectTo(const string&){
+//Description: Unix-domain sockets are not supported on this platform.
+    return false;
+}
+
+//----------------------------------------------------------------------------
+void FerryClient::disconnect(){
+//Description: Nothing is ever open on this platform.
+    fd = -1;
+}
+
+#endif
+
+//----------------------------------------------------------------------------
+bool FerryClient::isConnected() const{
+//Description: A closed connection has no socket.
+    return fd >= 0;
+}
+
+//----------------------------------------------------------------------------
+bool FerryClient::request(const vector<string>& fields, vector<string>& reply, vector<vector<string> >* rows){
+//Description: Sends the request, reads the reply line and, if it is
+//             "OK n" and rows were asked for, the n row lines after it.
+    string line;
+    if (fd < 0 || !sendFerryBytes(fd, joinFerryFields(fields)) || !receiveFerryLine(fd, buffer, line)){
+        disconnect();
+        return false;
+    }
+    reply = splitFerryFields(line);
+    if (reply.empty()){
+        disconnect();
+        return false;
+    }
+    if (rows == NULL || reply[0] != ferryReplyOk || reply.size() < 2) return true;
+
+    rows->clear();
+    int count = atoi(reply[1].c_str());
+    for (int i = 0; i < count; ++i){
+        if (!receiveFerryLine(fd, buffer, line)){
+            disconnect();
+            return false;
+        }
+        rows->push_back(splitFerryFields(line));
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool ask(FerryClient& client, const vector<string>& fields, vector<string>& reply,
+                vector<vector<string> >* rows = NULL){
+//Description: Sends a request; a lost connection is reported and turned
+//             into an ERR reply so callers handle one kind of failure.
+    if (client.request(fields, reply, rows)) return reply[0] == ferryReplyOk;
+    cerr << "Error: lost connection to the server." << endl;
+    reply.assign(1, ferryReplyError);
+    reply.push_back("Lost connection to the server.");
+    return false;
+}
+
+//----------------------------------------------------------------------------
+static vector<string> requestOf(const string& verb, const string& first = "", const string& second = ""){
+//Description: Builds a request of up to two arguments.
+    vector<string> fields(1, verb);
+    if (!first.empty()) fields.push_back(first);
+    if (!second.empty()) fields.push_back(second);
+    return fields;
+}
+
+//----------------------------------------------------------------------------
+static float toNumber(const string& text){
+//Description: Parses a number from a reply, 0 if it is malformed.
+    try{
+        return stof(text);
+    } catch (...){
+        return 0.0f;
+    }
+}
+
+//----------------------------------------------------------------------------
+static bool toReportRow(const vector<string>& fields, SailingReportRow& row){
+//Description: Rebuilds a report row from a sailing row of the protocol.
+    if (fields.size() != 6) return false;
+    row.sailing.setSailingID(fields[0]);
+    row.sailing.setVesselName(fields[1]);
+    row.sailing.setCurrentCapacitySmall(toNumber(fields[2]));
+    row.sailing.setCurrentCapacityBig(toNumber(fields[3]));
+    row.vehicles = atoi(fields[4].c_str());
+    row.deckUsage = toNumber(fields[5]);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool sailingExists(FerryClient& client, const string& sid){
+//Description: Asks the server whether a sailing exists.
+    vector<string> reply;
+    vector<vector<string> > rows;
+    return ask(client, requestOf(ferryVerbQuery, sid), reply, &rows) && !rows.empty();
+}
+
+//----------------------------------------------------------------------------
+static bool promptDimension(const string& name, float limit, const string& range, float& value){
+//Description: Reads one vehicle dimension like createBooking does.
+    while (true){
+        cout << "Enter " << name << " (0 to " << limit << "): ";
+        if (!(cin >> value) || value < 0 || value > limit || cin.peek() != '\n'){
+            if (cin.eof()) return false;
+            cout << (name == "height" ? "Height" : "Length") << " must be a number between " << range << ". Try again." << endl;
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            continue;
+        }
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return true;
+    }
+}
+
+//----------------------------------------------------------------------------
+static void clientCreateBooking(FerryClient& client){
+//Description: Collects a booking like createBooking and sends it as BOOK.
+    string sid;
+    while (true){
+        cout << endl << "Enter Sailing ID (ccc-dd-dd) or blank to cancel: ";
+        getline(cin, sid);
+        sid = trim(sid);
+        if (sid.empty()){
+            system("cls");
+            cout << endl << "Enter pressed. Now aborting to the previous Menu" << endl;
+            return;
+        }
+        if (!isValidSailingID(sid)){
+            cout << "Bad entry! Sailing ID format is ccc-dd-dd." << endl;
+            continue;
+        }
+        if (!sailingExists(client, sid)){
+            if (!client.isConnected()) return;
+            cout << "Error: Sailing not found." << endl;
+            continue;
+        }
+        break;
+    }
+
+    string plate;
+    while (true){
+        cout << "Enter license plate (3-10 chars) or blank to cancel: ";
+        getline(cin, plate);
+        plate = trim(plate);
+        if (plate.empty()){
+            system("cls");
+            cout << endl << "Enter pressed. Now aborting to the previous Menu" << endl;
+            return;
+        }
+        if (plate.size() < 3 || plate.size() > 10){
+            cout << "Bad entry! Plate must be 3-10 characters.\n";
+            continue;
+        }
+        break;
+    }
+
+    //A known vehicle keeps its stored dimensions; ask only for new ones
+    float height = 0, length = 0;
+    vector<string> reply;
+    if (ask(client, requestOf(ferryVerbVehicle, plate), reply) && reply.size() == 3){
+        length = toNumber(reply[1]);
+        height = toNumber(reply[2]);
+        cout << "Using stored dimensions. Height: " << height << " ; Length: " << length << endl;
+    } else{
+        if (!client.isConnected()) return;
+        if (!promptDimension("height", maxHeight, "0.0-9.9", height) ||
+            !promptDimension("length", maxLength, "0.0-99.9", length)) return;
+    }
+
+    string phone;
+    while (true){
+        cout << "Enter customer phone number (between 7 and 15 characters) or blank to cancel: ";
+        getline(cin, phone);
+        phone = trim(phone);
+        if (phone.empty()){
+            system("cls");
+            cout << "\nEnter pressed. Now aborting to the previous Menu\n";
+            return;
+        }
+        if (!regex_match(phone, regex("^[0-9]+$"))){
+            cout << "Bad entry! Phone must contain digits only.\n";
+            continue;
+        }
+        if (!regex_match(phone, regex("^[0-9]{7,15}$"))){
+            if (phone.size() < 7)
+                cout << "Too few digits. Try again.\n";
+            else
+                cout << "Too many digits. Try again.\n";
+            continue;
+        }
+        break;
+    }
+
+    vector<string> book = requestOf(ferryVerbBook, sid, plate);
+    book.push_back(phone);
+    book.push_back(to_string(length));
+    book.push_back(to_string(height));
+    if (!ask(client, book, reply)){
+        if (!client.isConnected()) return;
+        cerr << "Error: " << (reply.size() > 1 ? reply[1] : "") << endl;
+        cout << "Would you like to create another booking? (Y/N) ";
+    } else{
+        system("cls");
+        cout << (reply.size() > 1 && reply[1] == "special" ? "Special" : "Normal")
+             << "-sized vehicle with a \'" << plate << "\' license plate has been booked for sailing "
+             << sid << ". Would you like to create another booking? (Y/N) ";
+    }
+
+    string resp;
+    getline(cin, resp);
+    resp = trim(resp);
+    if (!resp.empty() && (resp[0] == 'Y' || resp[0] == 'y')) clientCreateBooking(client);
+}
+
+//----------------------------------------------------------------------------
+static void clientDeleteBooking(FerryClient& client){
+//Description: Asks for a booking like promptToDeleteBooking and sends CANCEL.
+    string sid, plate;
+    while (true){
+        cout << endl << "Enter SailingID (ccc-dd-dd) or blank to cancel: ";
+        getline(cin, sid);
+        sid = trim(sid);
+        if (sid.empty()){
+            cout << endl << "Enter pressed. Now aborting to the previous Menu\n";
+            system("cls");
+            return;
+        }
+        if (isValidSailingID(sid)) break;
+        cout << "Bad Entry!Please use format ccc-dd-dd. Try again.\n";
+    }
+    while (true){
+        cout << "Enter license plate (3-10 characterss) or blank to cancel: ";
+        getline(cin, plate);
+        plate = trim(plate);
+        if (plate.empty()){
+            system("cls");
+            cout << endl << "Enter pressed. Now aborting to the previous Menu\n";
+            return;
+        }
+        if (plate.size() < 3 || plate.size() > 10){
+            cout << "\nBad entry! License plate must be 3-10 characters. Try again.\n";
+            continue;
+        }
+        break;
+    }
+    system("cls");
+
+    vector<string> reply;
+    if (ask(client, requestOf(ferryVerbCancel, sid, plate), reply)){
+        cout << "Booking has been successfully deleted" << endl;
+    } else if (client.isConnected()){
+        cout << (reply.size() > 1 ? reply[1] : "Error deleting booking.") << endl;
+    }
+}
+
+//----------------------------------------------------------------------------
+static void clientCheckIn(FerryClient& client){
+//Description: Shows the fare (FARE), waits until it is collected, then
+//             checks the vehicle in (CHECKIN), like checkIn.
+    while (client.isConnected()){
+        string sid, plate;
+        while (true){
+            cout << endl << "Enter SailingID (ccc-dd-dd) or blank to cancel: ";
+            getline(cin, sid);
+            sid = trim(sid);
+            if (sid.empty()){
+                system("cls");
+                cout << endl << "Enter pressed. Now aborting to the previous Menu" << endl;
+                return;
+            }
+            if (!isValidSailingID(sid)){
+                cout << "Bad entry! Sailing ID format is ccc-dd-dd.\n";
+                continue;
+            }
+            if (!sailingExists(client, sid)){
+                if (!client.isConnected()) return;
+                cout << "No Sailing with SailingID" << sid << " was found. Try again." << endl;
+                continue;
+            }
+            break;
+        }
+        while (true){
+            cout << "Enter the vehicle's license plate (3 - 10 characters) or blank to cancel: ";
+            getline(cin, plate);
+            plate = trim(plate);
+            if (plate.empty()){
+                system("cls");
+                cout << endl << "Enter pressed. Now aborting to the previous Menu" << endl;
+                return;
+            }
+            if (plate.size() < 3 || plate.size() > 10){
+                cout << "\nBad entry! Must be between 3 and 10 characters." << endl;
+                continue;
+            }
+            break;
+        }
+
+        vector<string> reply;
+        if (!ask(client, requestOf(ferryVerbFare, sid, plate), reply)){
+            if (client.isConnected()) cout << (reply.size() > 1 ? reply[1] : "") << endl;
+            continue;
+        }
+        cout << "The fare is " << (reply.size() > 1 ? reply[1] : "") << ". Press <enter> once it has been collected.";
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        //Another terminal may have checked the vehicle in meanwhile
+        if (!ask(client, requestOf(ferryVerbCheckIn, sid, plate), reply)){
+            if (client.isConnected()) cerr << "Error: " << (reply.size() > 1 ? reply[1] : "") << endl;
+            continue;
+        }
+        system("cls");
+        cout << "Checked in \'" << plate << "\' onto " << sid << endl;
+    }
+}
+
+//----------------------------------------------------------------------------
+static void clientPrintReport(FerryClient& client){
+//Description: Fetches the report rows with REPORT and pages them like printReport.
+    system("cls");
+    cout << endl << "== Sailings Report ==" << endl;
+    printSailingReportHeader();
+
+    vector<string> reply;
+    vector<vector<string> > rows;
+    if (!ask(client, requestOf(ferryVerbReport), reply, &rows)){
+        cout << "Error reading sailing data." << endl;
+        return;
+    }
+    vector<SailingReportRow> report(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) toReportRow(rows[i], report[i]);
+    pageSailingReport(report);
+}
+
+//----------------------------------------------------------------------------
+static void clientQuerySailing(FerryClient& client){
+//Description: Asks for a SailingID or terminal like querySailing and shows
+//             the rows of the QUERY reply.
+    while (client.isConnected()){
+        cout << endl << "Enter SailingID (ccc-dd-dd), terminal (ccc or ccc-dd) or blank to return: ";
+        string sid;
+        getline(cin, sid);
+        sid = trim(sid);
+        if (sid.empty()){
+            system("cls");
+            cout << endl << "Enter pressed. Now aborting to the previous Menu" << endl;
+            return;
+        }
+        bool isPrefix = regex_match(sid, regex("^[A-Za-z]{3}(-\\d{2})?$"));
+        if (!isPrefix && !isValidSailingID(sid)){
+            cout << "Bad Entry! SailingID must have format ccc-dd-hh. Try again" << endl;
+            continue;
+        }
+
+        system("cls");
+        vector<string> reply;
+        vector<vector<string> > rows;
+        if (!ask(client, requestOf(ferryVerbQuery, sid), reply, &rows)){
+            if (client.isConnected()) cout << (reply.size() > 1 ? reply[1] : "") << endl;
+        } else if (rows.empty()){
+            if (isPrefix) cout << "No sailings found for " << sid << ".\n";
+            else cout << "No sailing  with SailingID" << sid << " found.\n";
+        } else{
+            if (isPrefix) cout << "== Sailings for " << sid << " ==\n";
+            else cout << "== Sailing Details ==\n";
+            printSailingReportHeader();
+            for (size_t i = 0; i < rows.size(); ++i){
+                SailingReportRow row;
+                if (toReportRow(rows[i], row)){
+                    printSailingRow(static_cast<int>(i) + 1, row.sailing, row.vehicles, row.deckUsage);
+                }
+            }
+        }
+
+        cout << "\nQuery another? (Y/N): ";
+        string r;
+        getline(cin, r);
+        r = trim(r);
+        if (r.empty() || (r[0] != 'Y' && r[0] != 'y')) break;
+    }
+}
+
+//----------------------------------------------------------------------------
+static int readMenuChoice(){
+//Description: Reads a menu number; -1 for anything else, -2 for a blank line.
+    string inputLine;
+    getline(cin, inputLine);
+    if (!cin) return 0;
+    if (inputLine.empty()) return -2;
+    try{
+        return stoi(inputLine);
+    } catch (...){
+        return -1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void clientInterfaceLoop(FerryClient& client){
+//Description: Main menu of a terminal; sub-menus only offer the operations
+//             the server handles.
+    while (client.isConnected()){
+        cout << "=== Main Menu ===" << endl;
+        cout << "[1] Check-in" << endl;
+        cout << "[2] Bookings" << endl;
+        cout << "[3] Sailings" << endl;
+        cout << "[0] Quit" << endl;
+        cout << "Enter a number (0-3): ";
+
+        int choice = readMenuChoice();
+        if (choice == -2){
+            cout << "Bad Entry! Please try again." << endl;
+            continue;
+        }
+        switch (choice){
+            case 1:
+                system("cls");
+                clientCheckIn(client);
+                break;
+            case 2:
+                system("cls");
+                while (client.isConnected()){
+                    cout << "==Bookings==" << endl;
+                    cout << "[1] Create a booking" << endl;
+                    cout << "[2] Delete a booking" << endl;
+                    cout << "[0] Back" << endl;
+                    cout << "Enter a number (0-2): ";
+                    int sub = readMenuChoice();
+                    if (sub == -2 || sub == 0){
+                        system("cls");
+                        break;
+                    }
+                    if (sub == 1) clientCreateBooking(client);
+                    else if (sub == 2) clientDeleteBooking(client);
+                    else cout << "Bad Entry! Please try again." << endl;
+                    cout << "\n";
+                }
+                break;
+            case 3:
+                system("cls");
+                while (client.isConnected()){
+                    cout << "==Sailings==" << endl;
+                    cout << "[1] View Sailings Report" << endl;
+                    cout << "[2] Query a Sailing" << endl;
+                    cout << "[0] Back" << endl;
+                    cout << "Enter a number (0-2): ";
+                    int sub = readMenuChoice();
+                    if (sub == -2 || sub == 0){
+                        system("cls");
+                        break;
+                    }
+                    if (sub == 1) clientPrintReport(client);
+                    else if (sub == 2) clientQuerySailing(client);
+                    else cout << "Bad Entry! Please try again." << endl;
+                    cout << "\n";
+                }
+                break;
+            case 0:
+                cout << endl << "Shutting down FerryQ. Goodbye!" << endl;
+                client.disconnect();
+                break;
+            default:
+                cout << "Bad Entry! Please try again." << endl;
+                break;
+        }
+        cout << "\n";
+    }
+}
@@ -0,0 +1,71 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: FerryClient.h
+// Rev.1 - 17/10/2026 - Interface for the thin terminal client of ferryqd.
+//
+// ----------------------------------------------------------------------------
+// This header declares the client side of ferryqd: a connection that sends
+// one request and waits for its reply, and the console menus a terminal
+// runs on top of it. The menus prompt exactly like the local console, but
+// every check and write is made by the server.
+// ----------------------------------------------------------------------------
+
+#ifndef FERRY_CLIENT_H
+#define FERRY_CLIENT_H
+
+#include <string>
+#include <vector>
+using namespace std;
+
+//Connection to a ferryqd server
+class FerryClient{
+public:
+    FerryClient() : fd(-1){}
+    ~FerryClient();
+
+//----------------------------------------------------------------------------
+    bool connectTo(const string& socketPath//input
+                   );
+    //Job: Connects to the server listening on socketPath.
+    //Usage: Called once before the first request.
+    //Restrictions: Returns false if no server is listening there.
+
+//----------------------------------------------------------------------------
+    bool request(const vector<string>& fields,    //input
+                 vector<string>& reply,           //output
+                 vector<vector<string> >* rows    //output
+                 );
+    //Job: Sends one request and reads its reply. reply[0] is "OK" or "ERR";
+    //     for replies that carry rows, rows receives them.
+    //Usage: Called by the client menus and tests.
+    //Restrictions: Returns false, and disconnects, if the connection was lost.
+
+//----------------------------------------------------------------------------
+    bool isConnected() const;
+    //Job: Returns whether the connection is still open.
+    //Usage: Checked by the menus after a request fails.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    void disconnect();
+    //Job: Closes the connection.
+    //Usage: Called when the terminal quits; also done by the destructor.
+    //Restrictions: None.
+//----------------------------------------------------------------------------
+private:
+    FerryClient(const FerryClient&);
+    FerryClient& operator=(const FerryClient&);
+    int fd;          //Connected socket, or -1
+    string buffer;   //Bytes received past the last reply line
+};
+
+//----------------------------------------------------------------------------
+void clientInterfaceLoop(FerryClient& client//input
+                         );
+//Job: Runs the main menu of a terminal connected to ferryqd: check-in,
+//     bookings, the sailings report and sailing queries.
+//Usage: Called from main() for --connect instead of userInterfaceLoop.
+//Restrictions: client must be connected. Creating or deleting sailings and
+//              vessels is only possible in the local console.
+
+#endif //FERRY_CLIENT_H
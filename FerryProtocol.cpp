@@ -0,0 +1,116 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: FerryProtocol.cpp
+// Rev.1 - 17/10/2026 - Implements the ferryqd line protocol helpers.
+//
+// ----------------------------------------------------------------------------
+// This module encodes and decodes protocol lines and moves them over a
+// socket.
+//
+// Implementation Strategy:
+// - Fields are joined with tabs; any tab or line break inside a field is
+//   replaced by a space so a field can never split a message.
+// - Sends use send() with MSG_NOSIGNAL, so a client that disconnects while
+//   a reply is written cannot stop the server with SIGPIPE.
+// - Receiving appends to a per-connection buffer and cuts complete lines
+//   off its front, so pipelined requests are handled in order.
+//
+// Used By: Called by FerryServer.cpp and FerryClient.cpp.
+// ----------------------------------------------------------------------------
+
+#include "FerryProtocol.h"
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+string joinFerryFields(const vector<string>& fields){
+//Description: Joins the fields with tabs and ends the line.
+    string line;
+    for (size_t i = 0; i < fields.size(); ++i){
+        if (i > 0) line += '\t';
+        for (size_t j = 0; j < fields[i].size(); ++j){
+            char c = fields[i][j];
+            line += (c == '\t' || c == '\n' || c == '\r') ? ' ' : c;
+        }
+    }
+    line += '\n';
+    return line;
+}
+
+//----------------------------------------------------------------------------
+vector<string> splitFerryFields(const string& line){
+//Description: Splits on tabs; an empty line gives no fields.
+    vector<string> fields;
+    string text = line;
+    if (!text.empty() && text[text.size() - 1] == '\r') text.erase(text.size() - 1);
+    if (text.empty()) return fields;
+    size_t start = 0;
+    for (;;){
+        size_t tab = text.find('\t', start);
+        fields.push_back(text.substr(start, tab == string::npos ? string::npos : tab - start));
+        if (tab == string::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+//----------------------------------------------------------------------------
+bool takeFerryLine(string& buffer, string& line){
+//Description: Cuts the first line (without its '\n') off the buffer.
+    size_t end = buffer.find('\n');
+    if (end == string::npos) return false;
+    line = buffer.substr(0, end);
+    buffer.erase(0, end + 1);
+    return true;
+}
+
+#if !defined(_WIN32)
+
+//----------------------------------------------------------------------------
+bool sendFerryBytes(int fd, const string& bytes){
+//Description: Sends until everything is written, retrying interrupted calls.
+    size_t sent = 0;
+    while (sent < bytes.size()){
+        ssize_t n = send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool receiveFerryLine(int fd, string& buffer, string& line){
+//Description: Reads into the buffer until it holds a complete line.
+    char chunk[4096];
+    while (!takeFerryLine(buffer, line)){
+        if (buffer.size() > maxFerryLineBytes) return false;
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    return true;
+}
+
+#else
+
+//----------------------------------------------------------------------------
+bool sendFerryBytes(int, const string&){
+//Description: Unix-domain sockets are not supported on this platform.
+    return false;
+}
+
+//----------------------------------------------------------------------------
+bool receiveFerryLine(int, string&, string&){
+//Description: Unix-domain sockets are not supported on this platform.
+    return false;
+}
+
+#endif
@@ -0,0 +1,87 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: FerryProtocol.h
+// Rev.1 - 17/10/2026 - Wire format shared by the ferryqd server and its clients.
+//
+// ----------------------------------------------------------------------------
+// This header declares the request/reply format spoken over the ferryqd
+// Unix-domain socket.
+//
+// Every message is one line of tab-separated fields ending in '\n'.
+//   Request: VERB<TAB>arg<TAB>arg...
+//   Reply:   OK<TAB>field...   or   ERR<TAB>message
+// A reply that carries rows (QUERY, REPORT) is "OK<TAB>n" followed by n
+// row lines. A client may send its next request as soon as it has read the
+// whole reply.
+//
+// Requests:
+//   VEHICLE plate                            -> OK length height
+//   BOOK    sid plate phone length height    -> OK regular|special
+//   FARE    sid plate                        -> OK fare
+//   CHECKIN sid plate                        -> OK fare
+//   CANCEL  sid plate                        -> OK
+//   QUERY   sid | ccc | ccc-dd               -> OK n, then n sailing rows
+//   REPORT                                   -> OK n, then n sailing rows
+// A sailing row is: sid vessel regularLeft specialLeft vehicles deckUsage.
+// ----------------------------------------------------------------------------
+
+#ifndef FERRY_PROTOCOL_H
+#define FERRY_PROTOCOL_H
+
+#include <string>
+#include <vector>
+using namespace std;
+
+const string defaultFerrySocket = "ferryq.sock";  //Socket path, next to the data files
+const size_t maxFerryLineBytes = 64 * 1024;       //Longer lines close the connection
+
+const string ferryVerbVehicle = "VEHICLE";
+const string ferryVerbBook = "BOOK";
+const string ferryVerbFare = "FARE";
+const string ferryVerbCheckIn = "CHECKIN";
+const string ferryVerbCancel = "CANCEL";
+const string ferryVerbQuery = "QUERY";
+const string ferryVerbReport = "REPORT";
+const string ferryReplyOk = "OK";
+const string ferryReplyError = "ERR";
+
+//----------------------------------------------------------------------------
+string joinFerryFields(const vector<string>& fields//input
+                       );
+//Job: Builds one protocol line (with its '\n') from fields.
+//Usage: Used by the server and the client for every message.
+//Restrictions: Tabs and line breaks inside a field are sent as spaces.
+
+//----------------------------------------------------------------------------
+vector<string> splitFerryFields(const string& line//input
+                                );
+//Job: Splits a protocol line (without its '\n') into its fields.
+//Usage: Used by the server and the client for every message.
+//Restrictions: A trailing '\r' is dropped.
+
+//----------------------------------------------------------------------------
+bool sendFerryBytes(int fd,              //input
+                    const string& bytes  //input
+                    );
+//Job: Writes all of bytes to a socket.
+//Usage: Used to send requests and replies.
+//Restrictions: Returns false if the peer has gone; never raises SIGPIPE.
+
+//----------------------------------------------------------------------------
+bool takeFerryLine(string& buffer, //input/output
+                   string& line    //output
+                   );
+//Job: Removes the first complete line from buffer.
+//Usage: Called after appending received bytes to a connection's buffer.
+//Restrictions: Returns false if buffer holds no complete line yet.
+
+//----------------------------------------------------------------------------
+bool receiveFerryLine(int fd,         //input
+                      string& buffer, //input/output
+                      string& line    //output
+                      );
+//Job: Blocks until a complete line has arrived and returns it.
+//Usage: Used by the client to read replies.
+//Restrictions: Returns false if the connection closes or the line is too long.
+
+#endif //FERRY_PROTOCOL_H
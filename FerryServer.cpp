@@ -0,0 +1,643 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: FerryServer.cpp
+// Rev.6 - 18/10/2026 - VEHICLE, FARE and the checks before a write run
+//                      outside storeLock with the heap booking engine.
+// Rev.5 - 18/10/2026 - A failed check-in rebuilds the booking index and drops
+//                      the sailing's counters, like BOOK and CANCEL.
+// Rev.4 - 18/10/2026 - A failed step aborts the write transaction instead
+//                      of committing the steps before it.
+// Rev.3 - 17/10/2026 - Sailing lock shards are picked from the packed SailingKey.
+// Rev.2 - 17/10/2026 - Queries and reports read a StoreSnapshot pinned under
+//                      storeLock instead of holding the lock throughout.
+// Rev.1 - 17/10/2026 - Implements the ferryqd daemon: socket loop, worker
+//                      pool and request handlers.
+//
+// ----------------------------------------------------------------------------
+// This module runs the ferryqd server.
+//
+// Implementation Strategy:
+// - One thread polls the listening socket, a wake pipe and every idle
+//   connection. A connection with data is taken off the idle set and queued
+//   for the workers, so each connection is served by one worker at a time
+//   and its replies come back in request order.
+// - A worker reads what has arrived, answers every complete line, and hands
+//   the connection back to the polling thread through a list and one byte
+//   on the wake pipe. A slow terminal therefore never holds a worker while
+//   its operator is typing.
+// - Writes to a sailing hold that sailing's lock (one of
+//   ferrySailingLockShards) from the first check to the last write, so the
+//   checks cannot go stale. The writes run under storeLock as a single
+//   write-ahead log transaction; it is committed only if every step
+//   succeeds and aborted otherwise.
+// - Point reads (VEHICLE, FARE and the checks before a write) take no
+//   store-wide lock: the vehicle cache, the sailing index and the heap
+//   booking index each guard themselves, and record reads take shared
+//   record locks, so they only wait for a write to the record they read.
+//   The hash and LSM booking engines keep unguarded tables in memory, so
+//   with those engines the booking lookups still run under storeLock.
+// - Queries and reports pin a StoreSnapshot under storeLock, between two
+//   write transactions, then release the lock and read the files as they
+//   were at that point. A long report therefore never stalls a booking. The
+//   LSM booking engine keeps its runs in memory outside the snapshot, so
+//   with that engine a report holds storeLock to the end.
+// - The capacity ledger decides whether a booking fits with
+//   compare-and-swap, so a full sailing is refused without waiting for
+//   other sailings.
+// - stopFerryServer only sets a flag and writes to the wake pipe, which is
+//   safe from a signal handler.
+//
+// Used By: Called by main.cpp in server mode.
+// ----------------------------------------------------------------------------
+
+#include "FerryServer.h"
+#include "FerryProtocol.h"
+#include "BookingUserIO.h"
+#include "BookingFileIO.h"
+#include "SailingUserIO.h"
+#include "SailingFileIO.h"
+#include "SailingCapacity.h"
+#include "SailingReport.h"
+#include "SailingKey.h"
+#include "VehicleFileIO.h"
+#include "RecordStore.h"
+#include "WriteAheadLog.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <regex>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <csignal>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+//The data files served, and the lock every write is made under
+struct FerryStore{
+    FerryStore(fstream& vessel, fstream& vehicle, fstream& booking, fstream& sailing)
+        : vesselFile(vessel), vehicleFile(vehicle), bookingFile(booking), sailingFile(sailing){}
+    fstream& vesselFile;
+    fstream& vehicleFile;
+    fstream& bookingFile;
+    fstream& sailingFile;
+    mutex storeLock;
+    mutex sailingLocks[ferrySailingLockShards];
+};
+
+//A client connection and the bytes received from it but not yet answered
+struct FerryConnection{
+    explicit FerryConnection(int socket) : fd(socket){}
+    int fd;
+    string buffer;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+static volatile sig_atomic_t wakeWriteFd = -1;
+
+//----------------------------------------------------------------------------
+void stopFerryServer(){
+//Description: Sets the stop flag and wakes the polling thread.
+    stopRequested = 1;
+#if !defined(_WIN32)
+    int fd = wakeWriteFd;
+    if (fd >= 0){
+        char byte = 0;
+        ssize_t ignored = write(fd, &byte, 1);
+        (void)ignored;
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+static void onStopSignal(int){
+//Description: SIGINT/SIGTERM handler.
+    stopFerryServer();
+}
+
+//----------------------------------------------------------------------------
+static string okReply(const vector<string>& fields){
+//Description: Builds an OK reply line carrying fields.
+    vector<string> line(1, ferryReplyOk);
+    line.insert(line.end(), fields.begin(), fields.end());
+    return joinFerryFields(line);
+}
+
+//----------------------------------------------------------------------------
+static string errorReply(const string& message){
+//Description: Builds an ERR reply line.
+    vector<string> line(1, ferryReplyError);
+    line.push_back(message);
+    return joinFerryFields(line);
+}
+
+//----------------------------------------------------------------------------
+static string rowsReply(const vector<vector<string> >& rows){
+//Description: Builds "OK n" followed by one line per row.
+    string reply = okReply(vector<string>(1, to_string(rows.size())));
+    for (size_t i = 0; i < rows.size(); ++i) reply += joinFerryFields(rows[i]);
+    return reply;
+}
+
+//----------------------------------------------------------------------------
+static string formatNumber(float value){
+//Description: Formats a length or fare for the wire.
+    ostringstream out;
+    out << value;
+    return out.str();
+}
+
+//----------------------------------------------------------------------------
+static bool parseDimension(const string& text, float limit, float& value){
+//Description: Parses a vehicle dimension between 0 and limit.
+    try{
+        size_t used = 0;
+        value = stof(text, &used);
+        return used == text.size() && value >= 0 && value <= limit;
+    } catch (...){
+        return false;
+    }
+}
+
+//----------------------------------------------------------------------------
+static vector<string> sailingRow(const Sailing& s, int vehicles, float deckUsage){
+//Description: Builds the wire row of one sailing.
+    vector<string> row;
+    row.push_back(s.getSailingID());
+    row.push_back(s.getVesselName());
+    row.push_back(formatNumber(s.getCurrentCapacitySmall()));
+    row.push_back(formatNumber(s.getCurrentCapacityBig()));
+    row.push_back(to_string(vehicles));
+    row.push_back(formatNumber(deckUsage));
+    return row;
+}
+
+//----------------------------------------------------------------------------
+static mutex& sailingLockFor(FerryStore& store, const string& sailingID){
+//Description: Returns the lock of the slice a sailing belongs to.
+    return store.sailingLocks[hashSailingKey(packSailingKey(sailingID)) % ferrySailingLockShards];
+}
+
+//----------------------------------------------------------------------------
+static unique_lock<mutex> lockForBookingReads(FerryStore& store){
+//Description: Returns storeLock held if the booking engine's lookups are
+//             not safe beside a write (hash and LSM), and not held otherwise.
+    unique_lock<mutex> guard(store.storeLock, defer_lock);
+    if (getBookingStoreEngine() != heapBookingStore) guard.lock();
+    return guard;
+}
+
+//----------------------------------------------------------------------------
+static bool isRegularSized(float length, float height){
+//Description: Same size classes as createBooking.
+    return !(height > maxHeightForRegularSizedVehicle || length > maxLengthForRegularSizedVehicle);
+}
+
+//----------------------------------------------------------------------------
+static string serveVehicle(FerryStore& store, const vector<string>& request){
+//Description: VEHICLE plate -> stored length and height.
+    if (request.size() != 2) return errorReply("Usage: VEHICLE plate");
+    float length, height;
+    if (!isVehicleExist(store.vehicleFile, request[1]) ||
+        !getVehicleDimensions(store.vehicleFile, request[1], length, height)){
+        return errorReply("Vehicle not found.");
+    }
+    vector<string> fields;
+    fields.push_back(formatNumber(length));
+    fields.push_back(formatNumber(height));
+    return okReply(fields);
+}
+
+//----------------------------------------------------------------------------
+static string serveBook(FerryStore& store, const vector<string>& request){
+//Description: BOOK sid plate phone length height. The dimensions are only
+//             used when the vehicle is new; a known vehicle keeps its own.
+    if (request.size() != 6) return errorReply("Usage: BOOK sid plate phone length height");
+    const string& sid = request[1];
+    const string& plate = request[2];
+    const string& phone = request[3];
+    float length, height;
+    if (!isValidSailingID(sid)) return errorReply("Bad entry! Sailing ID format is ccc-dd-dd.");
+    if (plate.size() < 3 || plate.size() > 10) return errorReply("Bad entry! Plate must be 3-10 characters.");
+    if (!regex_match(phone, regex("^[0-9]{7,15}$"))) return errorReply("Bad entry! Phone must be 7-15 digits.");
+    if (!parseDimension(request[4], maxLength, length) || !parseDimension(request[5], maxHeight, height)){
+        return errorReply("Bad entry! Vehicle dimensions are out of range.");
+    }
+
+    lock_guard<mutex> sailingGuard(sailingLockFor(store, sid));
+    {
+        unique_lock<mutex> guard = lockForBookingReads(store);
+        Booking existing;
+        if (findSailingIndexByID(store.sailingFile, sid) == -1) return errorReply("Sailing not found.");
+        if (loadBookingByKey(sid, plate, existing, store.bookingFile)){
+            return errorReply("Booking already exists for that vehicle on this sailing.");
+        }
+    }
+
+    lock_guard<mutex> guard(store.storeLock);
+    //The vehicle may have been saved by a booking on another sailing meanwhile
+    bool newVehicle = !isVehicleExist(store.vehicleFile, plate);
+    if (!newVehicle && !getVehicleDimensions(store.vehicleFile, plate, length, height)){
+        return errorReply("Failed to read vehicle dimensions.");
+    }
+    bool regular = isRegularSized(length, height);
+
+    string reply;
+    beginWalTransaction();
+    if (!reserveSailingCapacity(store.sailingFile, sid, regular ? length : 0.0f, regular ? 0.0f : length)){
+        reply = errorReply("The vessel does not have enough space to fit this vehicle.");
+    } else if (newVehicle && !writeVehicle(store.vehicleFile, Vehicle(plate, height, length))){
+        reply = errorReply("Unable to append vehicle record.");
+    } else if (!writeBooking(Booking(plate, sid, phone, false), store.bookingFile)){
+        reply = errorReply("Unable to append booking record.");
+    } else{
+        commitWalTransaction();
+        return okReply(vector<string>(1, regular ? "regular" : "special"));
+    }
+    abortWalTransaction();
+    buildBookingIndex(store.bookingFile);
+    forgetSailingCapacity(sid);  //Counters reload from the restored record
+    return reply;
+}
+
+//----------------------------------------------------------------------------
+static string checkBookingForCheckIn(FerryStore& store, const string& sid, const string& plate, float& fare){
+//Description: Returns an error reply, or "" with the fare if the booking
+//             exists and is not yet checked in. Booking reads must be
+//             locked as lockForBookingReads does.
+    Booking found;
+    float length, height;
+    if (!loadBookingByKey(sid, plate, found, store.bookingFile)) return errorReply("Booking not found.");
+    if (found.getCheckedIn()) return errorReply("Already checked in.");
+    if (!getVehicleDimensions(store.vehicleFile, plate, length, height)){
+        return errorReply("Vehicle dimensions not found.");
+    }
+    fare = calculateFare(length, height);
+    return "";
+}
+
+//----------------------------------------------------------------------------
+static string serveFare(FerryStore& store, const vector<string>& request){
+//Description: FARE sid plate -> the fare to collect before checking in.
+    if (request.size() != 3) return errorReply("Usage: FARE sid plate");
+    float fare = 0;
+    unique_lock<mutex> guard = lockForBookingReads(store);
+    string error = checkBookingForCheckIn(store, request[1], request[2], fare);
+    return error.empty() ? okReply(vector<string>(1, formatNumber(fare))) : error;
+}
+
+//----------------------------------------------------------------------------
+static string serveCheckIn(FerryStore& store, const vector<string>& request){
+//Description: CHECKIN sid plate. Flips the flag in place and counts the
+//             vehicle as checked in, as one transaction.
+    if (request.size() != 3) return errorReply("Usage: CHECKIN sid plate");
+    const string& sid = request[1];
+    const string& plate = request[2];
+    float fare = 0;
+
+    lock_guard<mutex> sailingGuard(sailingLockFor(store, sid));
+    {
+        unique_lock<mutex> guard = lockForBookingReads(store);
+        string error = checkBookingForCheckIn(store, sid, plate, fare);
+        if (!error.empty()) return error;
+    }
+
+    lock_guard<mutex> guard(store.storeLock);
+    string reply;
+    beginWalTransaction();
+    if (!markCheckedIn(sid, plate, store.bookingFile)){
+        reply = errorReply("Unable to update the booking record.");
+    } else if (!updateSailingCapacities(store.sailingFile, sid, 0.0f, 0.0f, 0, 1)){
+        reply = errorReply("Unable to update the sailing's checked-in count.");
+    } else{
+        commitWalTransaction();
+        return okReply(vector<string>(1, formatNumber(fare)));
+    }
+    abortWalTransaction();
+    buildBookingIndex(store.bookingFile);  //The LSM engine's memtable holds the checked-in copy
+    forgetSailingCapacity(sid);
+    return reply;
+}
+
+//----------------------------------------------------------------------------
+static string serveCancel(FerryStore& store, const vector<string>& request){
+//Description: CANCEL sid plate. Deletes the booking and gives its deck
+//             length back, as one transaction.
+    if (request.size() != 3) return errorReply("Usage: CANCEL sid plate");
+    const string& sid = request[1];
+    const string& plate = request[2];
+    Booking found;
+    float length, height;
+
+    lock_guard<mutex> sailingGuard(sailingLockFor(store, sid));
+    {
+        unique_lock<mutex> guard = lockForBookingReads(store);
+        if (!loadBookingByKey(sid, plate, found, store.bookingFile)) return errorReply("Booking not found");
+        if (!getVehicleDimensions(store.vehicleFile, plate, length, height)){
+            return errorReply("Could not find vehicle to restore capacity.");
+        }
+    }
+    bool regular = isRegularSized(length, height);
+
+    lock_guard<mutex> guard(store.storeLock);
+    string reply;
+    beginWalTransaction();
+    if (!deleteBookingRecord(sid, plate, store.bookingFile)){
+        reply = errorReply("Error deleting booking.");
+    } else if (!releaseSailingCapacity(store.sailingFile, sid, regular ? length : 0.0f, regular ? 0.0f : length,
+                                       found.getCheckedIn())){
+        reply = errorReply("Failed to restore sailing capacity.");
+    } else{
+        commitWalTransaction();
+        return okReply(vector<string>());
+    }
+    abortWalTransaction();
+    buildBookingIndex(store.bookingFile);
+    forgetSailingCapacity(sid);
+    return reply;
+}
+
+//----------------------------------------------------------------------------
+static string serveQuery(FerryStore& store, const vector<string>& request){
+//Description: QUERY sid, or a terminal (ccc) or terminal and day (ccc-dd).
+    if (request.size() != 2) return errorReply("Usage: QUERY sid|ccc|ccc-dd");
+    const string& key = request[1];
+    bool isPrefix = regex_match(key, regex("^[A-Za-z]{3}(-\\d{2})?$"));
+    if (!isPrefix && !isValidSailingID(key)){
+        return errorReply("Bad Entry! SailingID must have format ccc-dd-hh.");
+    }
+
+    vector<vector<string> > rows;
+    unique_ptr<StoreSnapshot> snapshot;
+    vector<int> matches;
+    {
+        //The index positions and the snapshot describe the same version
+        lock_guard<mutex> guard(store.storeLock);
+        snapshot.reset(new StoreSnapshot);
+        if (isPrefix){
+            matches = findSailingIndexesByPrefix(store.sailingFile, key);
+        } else{
+            int index = findSailingIndexByID(store.sailingFile, key);
+            if (index >= 0) matches.push_back(index);
+        }
+    }
+    for (size_t i = 0; i < matches.size(); ++i){
+        Sailing s;
+        if (loadSailingByIndex(store.sailingFile, matches[i], s)){
+            rows.push_back(sailingRow(s, s.getBookedVehicles(), s.getDeckUsagePercentage()));
+        }
+    }
+    return rowsReply(rows);
+}
+
+//----------------------------------------------------------------------------
+static string serveReport(FerryStore& store, const vector<string>& request){
+//Description: REPORT -> every row of the sailings report.
+    if (request.size() != 1) return errorReply("Usage: REPORT");
+    vector<SailingReportRow> report;
+    bool built;
+    if (getBookingStoreEngine() == lsmBookingStore){
+        lock_guard<mutex> guard(store.storeLock);
+        built = buildSailingReport(store.sailingFile, store.bookingFile, store.vesselFile, report);
+    } else{
+        unique_ptr<StoreSnapshot> snapshot;
+        {
+            lock_guard<mutex> guard(store.storeLock);  //Pinned between transactions
+            snapshot.reset(new StoreSnapshot);
+        }
+        built = buildSailingReport(store.sailingFile, store.bookingFile, store.vesselFile, report);
+    }
+    if (!built) return errorReply("Error reading sailing data.");
+    vector<vector<string> > rows;
+    for (size_t i = 0; i < report.size(); ++i){
+        rows.push_back(sailingRow(report[i].sailing, report[i].vehicles, report[i].deckUsage));
+    }
+    return rowsReply(rows);
+}
+
+//----------------------------------------------------------------------------
+static string serveRequest(FerryStore& store, const string& line){
+//Description: Dispatches one request line to its handler.
+    vector<string> request = splitFerryFields(line);
+    if (request.empty()) return errorReply("Empty request.");
+    const string& verb = request[0];
+    if (verb == ferryVerbVehicle) return serveVehicle(store, request);
+    if (verb == ferryVerbBook) return serveBook(store, request);
+    if (verb == ferryVerbFare) return serveFare(store, request);
+    if (verb == ferryVerbCheckIn) return serveCheckIn(store, request);
+    if (verb == ferryVerbCancel) return serveCancel(store, request);
+    if (verb == ferryVerbQuery) return serveQuery(store, request);
+    if (verb == ferryVerbReport) return serveReport(store, request);
+    return errorReply("Unknown request " + verb + ".");
+}
+
+#if !defined(_WIN32)
+
+//Connections moving between the polling thread and the workers
+struct FerryDispatch{
+    FerryDispatch() : stopping(false){}
+    mutex lock;
+    condition_variable ready;
+    deque<FerryConnection*> queued;     //Readable, waiting for a worker
+    vector<FerryConnection*> returned;  //Served, waiting to be polled again
+    bool stopping;
+};
+
+//----------------------------------------------------------------------------
+static bool serveConnection(FerryStore& store, FerryConnection& connection){
+//Description: Reads what has arrived and answers each complete line.
+//             Returns false if the connection should be closed.
+    char chunk[4096];
+    ssize_t n = recv(connection.fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+    if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    if (n == 0) return false;
+    connection.buffer.append(chunk, static_cast<size_t>(n));
+
+    string line;
+    while (takeFerryLine(connection.buffer, line)){
+        if (!sendFerryBytes(connection.fd, serveRequest(store, line))) return false;
+    }
+    return connection.buffer.size() <= maxFerryLineBytes;
+}
+
+//----------------------------------------------------------------------------
+static void workerLoop(FerryStore& store, FerryDispatch& dispatch, int wakeFd){
+//Description: Serves queued connections until the server stops.
+    for (;;){
+        FerryConnection* connection;
+        {
+            unique_lock<mutex> guard(dispatch.lock);
+            while (dispatch.queued.empty() && !dispatch.stopping) dispatch.ready.wait(guard);
+            if (dispatch.queued.empty()) return;
+            connection = dispatch.queued.front();
+            dispatch.queued.pop_front();
+        }
+
+        if (!serveConnection(store, *connection)){
+            close(connection->fd);
+            delete connection;
+            continue;
+        }
+        {
+            lock_guard<mutex> guard(dispatch.lock);
+            dispatch.returned.push_back(connection);
+        }
+        char byte = 0;
+        ssize_t ignored = write(wakeFd, &byte, 1);
+        (void)ignored;
+    }
+}
+
+//----------------------------------------------------------------------------
+static int openListeningSocket(const string& socketPath){
+//Description: Binds and listens on socketPath, replacing a stale socket
+//             file but not one another server is still answering on.
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)){
+        cerr << "Error: socket path must be 1-" << sizeof(address.sun_path) - 1 << " characters." << endl;
+        return -1;
+    }
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0){
+        bool inUse = connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        close(probe);
+        if (inUse){
+            cerr << "Error: a server is already listening on " << socketPath << "." << endl;
+            return -1;
+        }
+    }
+    unlink(socketPath.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0){
+        cerr << "Error: cannot listen on " << socketPath << ": " << strerror(errno) << endl;
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+//----------------------------------------------------------------------------
+bool runFerryServer(const string& socketPath, int workers, fstream& vesselFile, fstream& vehicleFile,
+                    fstream& bookingFile, fstream& sailingFile){
+//Description: Polls the listening socket, the wake pipe and the idle
+//             connections, queueing readable ones for the worker pool.
+    int listenFd = openListeningSocket(socketPath);
+    if (listenFd < 0) return false;
+    int wakePipe[2];
+    if (pipe(wakePipe) != 0){
+        close(listenFd);
+        return false;
+    }
+    fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+
+    stopRequested = 0;
+    wakeWriteFd = wakePipe[1];
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onStopSignal);
+    signal(SIGTERM, onStopSignal);
+
+    FerryStore store(vesselFile, vehicleFile, bookingFile, sailingFile);
+    FerryDispatch dispatch;
+    vector<thread> pool;
+    for (int i = 0; i < max(1, workers); ++i){
+        pool.push_back(thread(workerLoop, ref(store), ref(dispatch), wakePipe[1]));
+    }
+
+    vector<FerryConnection*> idle;
+    while (!stopRequested){
+        vector<pollfd> polled(2 + idle.size());
+        polled[0].fd = listenFd;
+        polled[1].fd = wakePipe[0];
+        for (size_t i = 0; i < idle.size(); ++i) polled[2 + i].fd = idle[i]->fd;
+        for (size_t i = 0; i < polled.size(); ++i){
+            polled[i].events = POLLIN;
+            polled[i].revents = 0;
+        }
+        if (poll(&polled[0], polled.size(), 1000) < 0 && errno != EINTR) break;
+
+        //Drain the wake pipe before collecting returned connections, so a
+        //connection returned after the collection still wakes the next poll
+        if (polled[1].revents != 0){
+            char drain[64];
+            while (read(wakePipe[0], drain, sizeof(drain)) > 0){}
+        }
+
+        //Hand readable (or hung-up) connections to the workers
+        vector<FerryConnection*> stillIdle;
+        {
+            lock_guard<mutex> guard(dispatch.lock);
+            for (size_t i = 0; i < idle.size(); ++i){
+                if (polled[2 + i].revents != 0) dispatch.queued.push_back(idle[i]);
+                else stillIdle.push_back(idle[i]);
+            }
+            stillIdle.insert(stillIdle.end(), dispatch.returned.begin(), dispatch.returned.end());
+            dispatch.returned.clear();
+        }
+        dispatch.ready.notify_all();
+        idle.swap(stillIdle);
+
+        if (polled[0].revents & POLLIN){
+            int client = accept(listenFd, NULL, NULL);
+            if (client >= 0){
+                fcntl(client, F_SETFD, FD_CLOEXEC);
+                idle.push_back(new FerryConnection(client));
+            }
+        }
+    }
+
+    //Let the workers finish the requests in hand, then close everything
+    {
+        lock_guard<mutex> guard(dispatch.lock);
+        dispatch.stopping = true;
+    }
+    dispatch.ready.notify_all();
+    for (size_t i = 0; i < pool.size(); ++i) pool[i].join();
+    idle.insert(idle.end(), dispatch.returned.begin(), dispatch.returned.end());
+    idle.insert(idle.end(), dispatch.queued.begin(), dispatch.queued.end());
+    for (size_t i = 0; i < idle.size(); ++i){
+        close(idle[i]->fd);
+        delete idle[i];
+    }
+
+    wakeWriteFd = -1;
+    close(wakePipe[0]);
+    close(wakePipe[1]);
+    close(listenFd);
+    unlink(socketPath.c_str());
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    return true;
+}
+
+#else
+
+//----------------------------------------------------------------------------
+bool runFerryServer(const string&, int, fstream&, fstream&, fstream&, fstream&){
+//Description: Unix-domain sockets are not supported on this platform.
+    cerr << "Error: server mode needs Unix-domain sockets." << endl;
+    return false;
+}
+
+#endif
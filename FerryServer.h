@@ -0,0 +1,51 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: FerryServer.h
+// Rev.1 - 17/10/2026 - Interface for the ferryqd multi-terminal booking daemon.
+//
+// ----------------------------------------------------------------------------
+// This header declares ferryqd, the server mode of FerryQ. The server owns
+// the data files and answers booking, check-in, query and report requests
+// from any number of terminals connected to a Unix-domain socket (see
+// FerryProtocol.h). Requests are handled on a pool of worker threads.
+//
+// Writes to one sailing (booking, check-in, cancellation) are serialized
+// with a per-sailing lock, so two terminals can never both pass the checks
+// for the same vehicle; writes to different sailings run side by side.
+// Every call into the File I/O modules is made under one store lock, since
+// the file streams, indexes and write-ahead log are shared by the process.
+//
+// Creating or deleting sailings and vessels stays in the local console.
+// ----------------------------------------------------------------------------
+
+#ifndef FERRY_SERVER_H
+#define FERRY_SERVER_H
+
+#include <fstream>
+#include <string>
+using namespace std;
+
+const int defaultFerryWorkers = 4;     //Worker threads when none are requested
+const int ferrySailingLockShards = 64; //Independently locked slices of the sailings
+
+//----------------------------------------------------------------------------
+bool runFerryServer(const string& socketPath, //input
+                    int workers,              //input
+                    fstream& vesselFile,      //input
+                    fstream& vehicleFile,     //input
+                    fstream& bookingFile,     //input
+                    fstream& sailingFile      //input
+                    );
+//Job: Listens on socketPath and serves requests until stopFerryServer is
+//     called or the process receives SIGINT or SIGTERM.
+//Usage: Called by main() in place of userInterfaceLoop for --serve.
+//Restrictions: The files must be open and indexed. Returns false if the
+//              socket cannot be created or another server is listening on it.
+
+//----------------------------------------------------------------------------
+void stopFerryServer();
+//Job: Asks a running server to finish the requests in hand and return.
+//Usage: Called from another thread or a signal handler.
+//Restrictions: Async-signal-safe. Has no effect if no server is running.
+
+#endif //FERRY_SERVER_H
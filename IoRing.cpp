@@ -0,0 +1,396 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: IoRing.cpp
+// Rev.1 - 17/10/2026 - Implements the io_uring backend, the read-ahead scan
+//                      reader and grouped file syncs.
+//
+// ----------------------------------------------------------------------------
+// This module implements the asynchronous I/O layer declared in IoRing.h.
+//
+// Implementation Strategy:
+// - No library is needed: the ring is created with io_uring_setup, its
+//   three regions are mapped with mmap, and requests are handed over with
+//   io_uring_enter. Only the kernel's <linux/io_uring.h> is required at
+//   build time; without it the module compiles to the fallback.
+// - Each ring has a single owner thread. The owner is the only producer of
+//   submissions and the only consumer of completions, so the shared head and
+//   tail indexes only need acquire/release ordering against the kernel.
+// - AsyncBlockReader cycles through depth block buffers. Block n always
+//   lands in slot n % depth; when the caller has used a block up, the slot
+//   is refilled with the block depth places further on. A block that comes
+//   back short (end of file, or a file that is still growing) or with an
+//   error ends the asynchronous part: the rest is read with pread from the
+//   caller's position, and reads still in flight are only drained.
+// - syncFilesTogether queues one sync per descriptor, submits them with one
+//   call and waits for all of them.
+// - The backend is probed once by creating and closing a small ring.
+//
+// Used By: RecordStore.h (RecordBatchReader) and WriteAheadLog.cpp.
+// ----------------------------------------------------------------------------
+
+#include "IoRing.h"
+#include <cstring>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define FERRYQ_IO_URING 1
+#endif
+#endif
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#if defined(FERRYQ_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+
+static bool asyncIoEnabled = true;
+
+//----------------------------------------------------------------------------
+bool isAsyncIoSupported(){
+//Description: Creates a two-entry ring once and remembers whether it worked.
+    static const bool supported = IoRing(2).isOpen();
+    return supported;
+}
+
+//----------------------------------------------------------------------------
+void setAsyncIoEnabled(bool enabled){
+//Description: Stores the switch checked by isAsyncIoEnabled.
+    asyncIoEnabled = enabled;
+}
+
+//----------------------------------------------------------------------------
+bool isAsyncIoEnabled(){
+//Description: The backend is used only when switched on and supported.
+    return asyncIoEnabled && isAsyncIoSupported();
+}
+
+#if defined(FERRYQ_IO_URING)
+
+//----------------------------------------------------------------------------
+static int ringEnter(int ringFd, unsigned toSubmit, unsigned minComplete){
+//Description: Calls io_uring_enter, retrying when interrupted by a signal.
+    unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    for (;;){
+        long done = syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, NULL, 0);
+        if (done >= 0 || errno != EINTR) return static_cast<int>(done);
+    }
+}
+
+//----------------------------------------------------------------------------
+IoRing::IoRing(unsigned entries)
+    : ringFd(-1), entries(0), queued(0), inFlight(0), sqRing(MAP_FAILED), cqRing(MAP_FAILED),
+      sqEntries(MAP_FAILED), sqRingBytes(0), cqRingBytes(0), sqEntriesBytes(0), sqHead(nullptr),
+      sqTail(nullptr), sqMask(nullptr), sqArray(nullptr), cqHead(nullptr), cqTail(nullptr),
+      cqMask(nullptr), cqEntries(nullptr){
+//Description: Creates the ring and maps its submission ring, completion ring
+//             and submission entries. Leaves the ring closed on any failure.
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) return;
+
+    sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    sqEntriesBytes = params.sq_entries * sizeof(struct io_uring_sqe);
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap){
+        if (cqRingBytes > sqRingBytes) sqRingBytes = cqRingBytes;
+        cqRingBytes = sqRingBytes;
+    }
+
+    sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sqRing != MAP_FAILED){
+        cqRing = singleMap ? sqRing
+                           : mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                  IORING_OFF_CQ_RING);
+    }
+    if (cqRing != MAP_FAILED){
+        sqEntries = mmap(nullptr, sqEntriesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                         IORING_OFF_SQES);
+    }
+    if (sqEntries == MAP_FAILED){
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingBytes);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingBytes);
+        sqRing = cqRing = MAP_FAILED;
+        close(fd);
+        return;
+    }
+
+    char* sq = static_cast<char*>(sqRing);
+    char* cq = static_cast<char*>(cqRing);
+    sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqEntries = cq + params.cq_off.cqes;
+    this->entries = params.sq_entries;
+    ringFd = fd;
+}
+
+//----------------------------------------------------------------------------
+IoRing::~IoRing(){
+//Description: Waits for requests still in flight (the kernel may be writing
+//             into their buffers), then unmaps and closes the ring.
+    if (ringFd < 0) return;
+    unsigned long long tag;
+    int result;
+    while (inFlight > 0 && waitCompletion(tag, result)){}
+    munmap(sqEntries, sqEntriesBytes);
+    if (cqRing != sqRing) munmap(cqRing, cqRingBytes);
+    munmap(sqRing, sqRingBytes);
+    close(ringFd);
+}
+
+//----------------------------------------------------------------------------
+void* IoRing::nextEntry(){
+//Description: Returns a cleared submission entry at the ring tail, or
+//             nullptr if the ring is full. The caller fills it and then
+//             moves the tail past it.
+    if (ringFd < 0) return nullptr;
+    unsigned tail = *sqTail;
+    unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    if (tail - head >= entries || queued + inFlight >= entries) return nullptr;
+    unsigned index = tail & *sqMask;
+    struct io_uring_sqe* entry = static_cast<struct io_uring_sqe*>(sqEntries) + index;
+    memset(entry, 0, sizeof(*entry));
+    sqArray[index] = index;
+    ++queued;
+    return entry;
+}
+
+//----------------------------------------------------------------------------
+bool IoRing::queueRead(int fd, void* buffer, size_t bytes, long long offset, unsigned long long tag){
+//Description: Fills an IORING_OP_READ entry and moves the tail past it.
+    struct io_uring_sqe* entry = static_cast<struct io_uring_sqe*>(nextEntry());
+    if (entry == nullptr) return false;
+    entry->opcode = IORING_OP_READ;
+    entry->fd = fd;
+    entry->addr = reinterpret_cast<unsigned long long>(buffer);
+    entry->len = static_cast<unsigned>(bytes);
+    entry->off = static_cast<unsigned long long>(offset);
+    entry->user_data = tag;
+    __atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool IoRing::queueSync(int fd, bool dataOnly, unsigned long long tag){
+//Description: Fills an IORING_OP_FSYNC entry and moves the tail past it.
+    struct io_uring_sqe* entry = static_cast<struct io_uring_sqe*>(nextEntry());
+    if (entry == nullptr) return false;
+    entry->opcode = IORING_OP_FSYNC;
+    entry->fd = fd;
+    entry->fsync_flags = dataOnly ? IORING_FSYNC_DATASYNC : 0;
+    entry->user_data = tag;
+    __atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool IoRing::submit(){
+//Description: Submits the queued entries; the kernel consumes them in order.
+    while (queued > 0){
+        int done = ringEnter(ringFd, queued, 0);
+        if (done <= 0) return false;
+        queued -= static_cast<unsigned>(done);
+        inFlight += static_cast<unsigned>(done);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool IoRing::waitCompletion(unsigned long long& tag, int& result){
+//Description: Takes the completion at the ring head, entering the kernel to
+//             wait when the ring is empty.
+    if (ringFd < 0 || inFlight == 0) return false;
+    unsigned head = *cqHead;
+    while (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)){
+        if (ringEnter(ringFd, 0, 1) < 0) return false;
+    }
+    const struct io_uring_cqe* entry = static_cast<const struct io_uring_cqe*>(cqEntries) + (head & *cqMask);
+    tag = entry->user_data;
+    result = entry->res;
+    __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+    --inFlight;
+    return true;
+}
+
+#else
+
+//----------------------------------------------------------------------------
+IoRing::IoRing(unsigned)
+    : ringFd(-1), entries(0), queued(0), inFlight(0), sqRing(nullptr), cqRing(nullptr), sqEntries(nullptr),
+      sqRingBytes(0), cqRingBytes(0), sqEntriesBytes(0), sqHead(nullptr), sqTail(nullptr), sqMask(nullptr),
+      sqArray(nullptr), cqHead(nullptr), cqTail(nullptr), cqMask(nullptr), cqEntries(nullptr){
+//Description: io_uring is not available here; the ring stays closed.
+}
+
+//----------------------------------------------------------------------------
+IoRing::~IoRing(){
+//Description: Nothing was created.
+}
+
+//----------------------------------------------------------------------------
+void* IoRing::nextEntry(){
+//Description: There is no submission ring.
+    return nullptr;
+}
+
+//----------------------------------------------------------------------------
+bool IoRing::queueRead(int, void*, size_t, long long, unsigned long long){
+//Description: Always refused; callers read synchronously.
+    return false;
+}
+
+//----------------------------------------------------------------------------
+bool IoRing::queueSync(int, bool, unsigned long long){
+//Description: Always refused; callers sync synchronously.
+    return false;
+}
+
+//----------------------------------------------------------------------------
+bool IoRing::submit(){
+//Description: Nothing can have been queued.
+    return false;
+}
+
+//----------------------------------------------------------------------------
+bool IoRing::waitCompletion(unsigned long long&, int&){
+//Description: Nothing is ever in flight.
+    return false;
+}
+
+#endif
+
+//----------------------------------------------------------------------------
+AsyncBlockReader::AsyncBlockReader(int fd, size_t blockBytes, int depth)
+    : fd(fd), blockBytes(blockBytes), ring(static_cast<unsigned>(depth)), current(0), used(0), nextOffset(0),
+      position(0), synchronous(false){
+//Description: Allocates one buffer per slot and queues the first depth
+//             blocks. Without a ring, or if the first submit fails, the
+//             reader is left closed for the caller to fall back.
+    if (!ring.isOpen() || fd < 0 || depth < 1 || blockBytes == 0) return;
+    buffers.assign(depth, vector<char>(blockBytes));
+    results.assign(depth, 0);
+    ready.assign(depth, false);
+    for (int slot = 0; slot < depth; ++slot){
+        if (!queueBlock(slot)) synchronous = true;
+    }
+    if (!ring.submit()) synchronous = true;
+}
+
+//----------------------------------------------------------------------------
+AsyncBlockReader::~AsyncBlockReader(){
+//Description: Drains reads still in flight before the buffers are released
+//             (members are destroyed before the ring would drain them).
+    unsigned long long tag;
+    int result;
+    while (ring.getInFlight() > 0 && ring.waitCompletion(tag, result)){}
+}
+
+//----------------------------------------------------------------------------
+bool AsyncBlockReader::queueBlock(int slot){
+//Description: Queues the read of the next block into slot.
+    ready[slot] = false;
+    if (!ring.queueRead(fd, &buffers[slot][0], blockBytes, nextOffset, static_cast<unsigned long long>(slot))){
+        return false;
+    }
+    nextOffset += static_cast<long long>(blockBytes);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool AsyncBlockReader::waitForSlot(int slot){
+//Description: Collects completions until the read into slot has finished.
+    while (!ready[slot]){
+        unsigned long long tag;
+        int result;
+        if (!ring.waitCompletion(tag, result)) return false;
+        if (tag < ready.size()){
+            results[tag] = result;
+            ready[tag] = true;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+size_t AsyncBlockReader::read(char* buffer, size_t bytes){
+//Description: Copies from completed blocks in file order. A used-up block
+//             is requeued for the block depth places ahead; a short or
+//             failed block switches the rest of the scan to pread.
+    size_t done = 0;
+    while (done < bytes && !synchronous){
+        if (!waitForSlot(current) || results[current] < 0){
+            synchronous = true;
+            break;
+        }
+        size_t filled = static_cast<size_t>(results[current]);
+        size_t take = filled - used;
+        if (take > bytes - done) take = bytes - done;
+        memcpy(buffer + done, &buffers[current][used], take);
+        done += take;
+        used += take;
+        position += static_cast<long long>(take);
+        if (used < filled) break;
+
+        if (filled < blockBytes){
+            synchronous = true;  //Possibly the end; pread decides
+            break;
+        }
+        used = 0;
+        if (!queueBlock(current) || !ring.submit()) synchronous = true;
+        current = (current + 1) % static_cast<int>(buffers.size());
+    }
+
+#if !defined(_WIN32)
+    while (done < bytes && synchronous){
+        ssize_t got = pread(fd, buffer + done, bytes - done, static_cast<off_t>(position));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        done += static_cast<size_t>(got);
+        position += got;
+    }
+#endif
+    return done;
+}
+
+//----------------------------------------------------------------------------
+bool syncFilesTogether(const vector<int>& fds, bool dataOnly){
+//Description: Queues and submits one sync per descriptor, a ring's worth at
+//             a time, then waits for them. Falls back to sequential syncs.
+    bool ok = true;
+    size_t next = 0;
+    if (isAsyncIoEnabled() && !fds.empty()){
+        IoRing ring(static_cast<unsigned>(fds.size() < 16 ? fds.size() : 16));
+        while (ring.isOpen() && next < fds.size()){
+            size_t first = next;
+            while (next < fds.size() && ring.queueSync(fds[next], dataOnly, next)) ++next;
+            if (next == first || !ring.submit()){
+                next = first;  //Could not hand them over; sync the rest below
+                break;
+            }
+            unsigned long long tag;
+            int result;
+            while (ring.getInFlight() > 0 && ring.waitCompletion(tag, result)){
+                if (result < 0) ok = false;
+            }
+        }
+    }
+#if !defined(_WIN32)
+    for (; next < fds.size(); ++next){
+        if ((dataOnly ? fdatasync(fds[next]) : fsync(fds[next])) != 0) ok = false;
+    }
+#endif
+    return ok;
+}
@@ -0,0 +1,191 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: IoRing.h
+// Rev.1 - 17/10/2026 - Asynchronous I/O backend (Linux io_uring) for scans
+//                      and log syncs, with a synchronous fallback.
+//
+// ----------------------------------------------------------------------------
+// This header declares the asynchronous I/O layer under the record store and
+// the write-ahead log. On Linux it drives an io_uring directly through its
+// system calls: requests are queued in a submission ring shared with the
+// kernel, handed over with one io_uring_enter call, and collected from a
+// completion ring, so several reads or syncs are in progress at once.
+//
+// Two users are built on it:
+// - AsyncBlockReader keeps a window of block reads in flight ahead of a
+//   sequential scan, so the device always has work queued while the caller
+//   is still processing the previous block.
+// - syncFilesTogether issues the fsyncs of several files at once and waits
+//   for all of them, instead of one after another.
+// The write-ahead log also queues its group-commit fdatasync on a ring and
+// only waits for it when the next group is synced.
+//
+// Where io_uring is missing (other platforms, old kernels, or a sandbox that
+// refuses the system call) IoRing::isOpen() is false, and every user falls
+// back to the plain read/fsync path. setAsyncIoEnabled(false) forces that
+// path everywhere.
+// ----------------------------------------------------------------------------
+
+#ifndef IO_RING_H
+#define IO_RING_H
+
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+const size_t asyncReadBlockBytes = 128 * 1024;               //Bytes per read request in a scan
+const int asyncReadDepth = 8;                                //Reads kept in flight by a scan
+const long long asyncScanMinBytes = 2 * asyncReadBlockBytes; //Smaller files are read synchronously
+
+//----------------------------------------------------------------------------
+bool isAsyncIoSupported();
+//Job: Returns whether an io_uring can be created on this system.
+//Usage: Probed once; the answer is cached.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+void setAsyncIoEnabled(bool enabled//input
+                       );
+//Job: Switches the asynchronous backend on or off.
+//Usage: Called at startup; on by default wherever it is supported.
+//Restrictions: Rings already created keep working until they are destroyed.
+
+//----------------------------------------------------------------------------
+bool isAsyncIoEnabled();
+//Job: Returns true when the backend is both enabled and supported.
+//Usage: Checked before creating a ring.
+//Restrictions: None.
+
+//Submission and completion rings of one io_uring instance
+class IoRing{
+public:
+    explicit IoRing(unsigned entries);
+    ~IoRing();
+
+//----------------------------------------------------------------------------
+    bool isOpen() const{ return ringFd >= 0; }
+    //Job: Returns whether the ring was created.
+    //Usage: Checked after construction; callers fall back when false.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    bool queueRead(int fd,                     //input
+                   void* buffer,               //output
+                   size_t bytes,               //input
+                   long long offset,           //input
+                   unsigned long long tag      //input
+                   );
+    //Job: Queues a read of bytes at offset into buffer.
+    //Usage: Followed by submit(); the completion carries tag.
+    //Restrictions: Returns false if the submission ring is full. buffer
+    //              must stay valid until the completion has been collected.
+
+//----------------------------------------------------------------------------
+    bool queueSync(int fd,                  //input
+                   bool dataOnly,           //input
+                   unsigned long long tag   //input
+                   );
+    //Job: Queues an fsync (or fdatasync when dataOnly) of fd.
+    //Usage: Followed by submit(); the completion carries tag.
+    //Restrictions: Returns false if the submission ring is full.
+
+//----------------------------------------------------------------------------
+    bool submit();
+    //Job: Hands every queued request to the kernel without waiting.
+    //Usage: Called once after a group of queue calls.
+    //Restrictions: Returns false if the kernel refused the requests.
+
+//----------------------------------------------------------------------------
+    bool waitCompletion(unsigned long long& tag, //output
+                        int& result              //output
+                        );
+    //Job: Collects one completion, blocking until one is available.
+    //Usage: result is the byte count of a read, 0 for a sync, or -errno.
+    //Restrictions: Returns false if nothing is in flight or the wait failed.
+
+//----------------------------------------------------------------------------
+    unsigned getInFlight() const{ return inFlight; }
+    //Job: Returns the number of requests submitted but not yet collected.
+    //Usage: Lets owners drain the ring before freeing buffers.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+private:
+    IoRing(const IoRing&);
+    IoRing& operator=(const IoRing&);
+    void* nextEntry();
+    int ringFd;             //io_uring descriptor (-1 if unavailable)
+    unsigned entries;       //Submission ring size
+    unsigned queued;        //Requests queued but not yet submitted
+    unsigned inFlight;      //Requests submitted but not yet collected
+    void* sqRing;           //Mapped submission ring
+    void* cqRing;           //Mapped completion ring (may equal sqRing)
+    void* sqEntries;        //Mapped submission entries
+    size_t sqRingBytes;
+    size_t cqRingBytes;
+    size_t sqEntriesBytes;
+    unsigned* sqHead;       //Pointers into the shared rings
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    void* cqEntries;
+};
+
+//Sequential reader of a descriptor that keeps block reads in flight ahead
+class AsyncBlockReader{
+public:
+    AsyncBlockReader(int fd,            //input
+                     size_t blockBytes, //input
+                     int depth          //input
+                     );
+    ~AsyncBlockReader();
+
+//----------------------------------------------------------------------------
+    bool isOpen() const{ return ring.isOpen(); }
+    //Job: Returns whether reads are being issued asynchronously.
+    //Usage: Checked after construction; callers read the descriptor
+    //       themselves when false.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    size_t read(char* buffer, //output
+                size_t bytes  //input
+                );
+    //Job: Copies the next bytes of the file into buffer, queueing the read
+    //     of a new block each time one is used up.
+    //Usage: Call repeatedly, like read(2), until it returns 0.
+    //Restrictions: Returns fewer bytes only at end of file or on error.
+    //              After a short or failed block it continues with pread.
+
+//----------------------------------------------------------------------------
+private:
+    AsyncBlockReader(const AsyncBlockReader&);
+    AsyncBlockReader& operator=(const AsyncBlockReader&);
+    bool queueBlock(int slot);
+    bool waitForSlot(int slot);
+    int fd;                           //Descriptor being scanned
+    size_t blockBytes;                //Bytes per read request
+    IoRing ring;                      //Ring the reads are issued on
+    vector<vector<char> > buffers;    //One block buffer per slot
+    vector<int> results;              //Bytes read into each slot, or -errno
+    vector<bool> ready;               //Whether each slot's read completed
+    int current;                      //Slot holding the next unread byte
+    size_t used;                      //Bytes of the current slot already returned
+    long long nextOffset;             //File offset of the next block to queue
+    long long position;               //File offset of the next unread byte
+    bool synchronous;                 //Set once the rest is read with pread
+};
+
+//----------------------------------------------------------------------------
+bool syncFilesTogether(const vector<int>& fds, //input
+                       bool dataOnly           //input
+                       );
+//Job: Makes every descriptor in fds durable, issuing their syncs at once.
+//Usage: Checkpoints that need several data files on stable storage.
+//Restrictions: Returns false if any sync failed. Falls back to one fsync
+//              (or fdatasync) after another without the backend.
+
+#endif //IO_RING_H
@@ -0,0 +1,935 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: RecordStore.cpp
+// Rev.15 - 18/10/2026 - A remap makes a new shared mapping instead of
+//                       unmapping the one readers may still be using.
+// Rev.14 - 18/10/2026 - Added claimDataFile.
+// Rev.13 - 18/10/2026 - Undo records are kept per file, indexed by version
+//                       and offset; before-images are read outside the
+//                       version lock.
+// Rev.12 - 18/10/2026 - The header check leaves out the generation; added
+//                       readHeader.
+// Rev.11 - 18/10/2026 - A forked child closes the lock descriptors it
+//                       inherited instead of sharing them with its parent.
+// Rev.10 - 18/10/2026 - PositionalFile and RecordLock skip a file header;
+//                       added the header checks.
+// Rev.9 - 18/10/2026 - Added isRangeLockedByThisThread.
+// Rev.8 - 18/10/2026 - Nested RecordLocks track their ranges and modes: a
+//                      covered lock is skipped, a shared one is upgraded.
+// Rev.7 - 17/10/2026 - Implements the scan worker pool and its thread setting.
+// Rev.6 - 17/10/2026 - Implements StoreSnapshot with undo records kept by
+//                      PositionalFile while snapshots are pinned.
+// Rev.5 - 17/10/2026 - Implements RecordLock with open-file-description fcntl
+//                      locks (process-wide locks where those are missing).
+// Rev.4 - 17/10/2026 - Implements PositionalFile with pread/pwrite, fstat and
+//                      ftruncate (fstream fallback where they are missing).
+// Rev.3 - 17/10/2026 - Holds the tombstone compaction threshold.
+// Rev.2 - 17/10/2026 - Added sequential-access hints and block reads for scans.
+// Rev.1 - 17/10/2026 - Implements the memory mappings behind MappedRecordFile.
+//
+// ----------------------------------------------------------------------------
+// This module holds the platform-specific half of the record store.
+//
+// What it does:
+// - Maps a data file read-only with mmap(MAP_SHARED) and keeps the mapping
+//   in step with the file size on every refresh. A mapping is never
+//   changed once made: a remap opens a new one (on a dup of the
+//   descriptor) and hands it out in a shared_ptr whose deleter unmaps it,
+//   so the old one lives until the last reader pinning it is done.
+// - Reserves twice the current file size when it has to remap, so appends
+//   only remap when the file doubles. Pages past the end of the file are
+//   never read; their records are not counted by MappedRecordFile::View::size().
+// - Reopens the file if it was replaced (different device/inode).
+// - Provides the descriptor-level helpers behind RecordBatchReader: a
+//   private descriptor advised with POSIX_FADV_SEQUENTIAL, read in blocks.
+// - Implements PositionalFile: one descriptor per data file, opened on
+//   first use and read/written with pread/pwrite, which take the offset as
+//   an argument and leave no cursor behind. Opening is locked; afterwards
+//   the descriptor is read without a lock. size() notices a replaced file
+//   the same way the mappings do and reopens it. The lowest-level reads,
+//   writes, sizes and truncates add the header size to record offsets (and
+//   take it off the file size), so nothing above them sees the header; the
+//   header itself is read and written at record offset -headerBytes.
+// - Implements RecordLock with F_OFD_SETLKW: the lock belongs to the
+//   descriptor it was taken on, not to the process, so it conflicts with
+//   locks of other threads and processes alike and is not dropped when some
+//   other descriptor of the file is closed. Each lock takes a descriptor
+//   from a small pool kept by the PositionalFile, so threads never share a
+//   lock owner. A thread's nested locks on one file share that descriptor
+//   and are listed per thread with their range and mode. A lock already
+//   covered in the same or a stronger mode is skipped; an exclusive lock
+//   over shared ones upgrades them in place. Releasing a lock sets each of
+//   its bytes back to the strongest mode still listed. Where OFD locks are
+//   missing, classic F_SETLKW locks are used; they only guard against
+//   other processes. A child forked with descriptors in the pool shares
+//   their open file descriptions, and with them the lock owner, with its
+//   parent; so the pool records the process that filled it and a child
+//   closes what it inherited (no lock is held on an idle descriptor, and
+//   the parent's copies stay open) before opening its own.
+// - Snapshots: a global write version counts the changes kept for readers.
+//   A snapshot pins the current version. While any is pinned, each write or
+//   truncate first stores the bytes it replaces and the prior file size as
+//   an undo record with the next version. Each PositionalFile keeps its
+//   own undo records by version, with the writes also indexed by offset
+//   and the truncates listed apart. The before-image is read first, under
+//   the writer's RecordLock only; the global version lock is held just to
+//   number the record and file it, so writers do not queue behind each
+//   other's reads. A read through a snapshot reads the file, then looks up
+//   the writes near its range and the truncates made after the snapshot
+//   and copies their images back newest first, so the oldest image wins;
+//   its file size is the prior size of the file's first change after the
+//   snapshot. Readers take only the file's own lock. The undo record is
+//   stored before the change reaches the file and the reader looks for undo
+//   records after its read, so a change racing the read is always undone.
+//   Releasing the oldest snapshot drops, file by file, the undo records no
+//   snapshot needs.
+// - On platforms without mmap every refresh fails, and callers fall back to
+//   positional reads; without pread/pwrite, PositionalFile serializes
+//   seek-and-transfer on a private fstream.
+// - Runs the workers of parallelScanRecords: the caller is worker 0 and the
+//   others are threads started for the scan, each pinning the caller's
+//   snapshot version (still pinned by the caller, so its undo records stay)
+//   before it reads anything.
+// - claimDataFile opens the file once more and takes a non-blocking
+//   exclusive flock on it. The descriptor stays open (listed by name, so a
+//   second claim from the same process succeeds) and the lock goes away
+//   with the process. flock and the fcntl range locks do not interact.
+// - Keeps the dead-record threshold the FileIO modules use to decide when
+//   a file with tombstones is worth compacting.
+//
+// Used By: Called through RecordStore.h by all four FileIO modules.
+// ----------------------------------------------------------------------------
+
+#include "RecordStore.h"
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <cstring>
+#include <climits>
+
+#if !defined(_WIN32)
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+static RecordStoreMode recordStoreMode = mappedRecordStore;
+static const size_t minMappingBytes = 64 * 1024;   //Smallest mapping reserved
+static float compactionThreshold = defaultCompactionThreshold;
+static bool fileLocking = true;
+static atomic<int> scanThreads(0);  //Threads per parallel scan (0 = one per core)
+
+static mutex versionLock;                           //Guards the version state below
+static unsigned long long writeVersion = 0;         //Version of the latest kept change
+static multiset<unsigned long long> pinnedVersions; //Versions of the live snapshots
+static vector<PositionalFile*> undoFiles;           //Files holding undo records
+static atomic<int> pinnedSnapshots(0);              //Size of pinnedVersions, read without the lock
+static thread_local const StoreSnapshot* activeSnapshot = nullptr;  //Snapshot of the calling thread
+
+//----------------------------------------------------------------------------
+void setRecordStoreMode(RecordStoreMode mode){
+//Description: Selects the read path used by scanRecords/readRecordAt.
+    recordStoreMode = mode;
+}
+
+//----------------------------------------------------------------------------
+RecordStoreMode getRecordStoreMode(){
+//Description: Returns the selected read path.
+    return recordStoreMode;
+}
+
+//----------------------------------------------------------------------------
+RecordFileHeader makeRecordFileHeader(const char* magic, unsigned int version, unsigned int recordBytes){
+//Description: Fills in the header fields, starting at generation zero.
+    RecordFileHeader header;
+    memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = version;
+    header.recordBytes = recordBytes;
+    header.generation = 0;
+    return header;
+}
+
+//----------------------------------------------------------------------------
+RecordFileState PositionalFile::checkHeader(const RecordFileHeader& expected){
+//Description: Reads the bytes before record offset 0; nothing there at all
+//             means an empty file.
+    RecordFileHeader found;
+    size_t got = readCurrent(-headerBytes, &found, sizeof(found));
+    if (got == 0) return recordFileEmpty;
+    if (got == sizeof(found) && memcmp(found.magic, expected.magic, sizeof(found.magic)) == 0 &&
+        found.version == expected.version && found.recordBytes == expected.recordBytes){
+        return recordFileCurrent;
+    }
+    return recordFileOutdated;
+}
+
+//----------------------------------------------------------------------------
+bool PositionalFile::readHeader(RecordFileHeader& header){
+//Description: Reads the bytes before record offset 0.
+    return headerBytes == recordFileHeaderBytes &&
+           readCurrent(-headerBytes, &header, sizeof(header)) == sizeof(header);
+}
+
+//----------------------------------------------------------------------------
+bool PositionalFile::writeHeader(const RecordFileHeader& header){
+//Description: Writes the header before record offset 0.
+    return headerBytes == recordFileHeaderBytes && writeCurrent(-headerBytes, &header, sizeof(header));
+}
+
+//----------------------------------------------------------------------------
+void setCompactionThreshold(float deadFraction){
+//Description: Stores the dead-record fraction, clamped to [0, 1].
+    if (deadFraction < 0.0f) deadFraction = 0.0f;
+    if (deadFraction > 1.0f) deadFraction = 1.0f;
+    compactionThreshold = deadFraction;
+}
+
+//----------------------------------------------------------------------------
+bool isCompactionDue(int deadRecords, int totalRecords){
+//Description: Compares the dead fraction with the threshold. A threshold
+//             of 1 only triggers when every record is dead.
+    if (deadRecords <= 0 || totalRecords <= 0) return false;
+    return static_cast<float>(deadRecords) >= compactionThreshold * static_cast<float>(totalRecords);
+}
+
+//----------------------------------------------------------------------------
+void setFileLocking(bool enabled){
+//Description: Stores the switch checked by RecordLock.
+    fileLocking = enabled;
+}
+
+//----------------------------------------------------------------------------
+bool isFileLockingEnabled(){
+//Description: Returns the switch checked by RecordLock.
+    return fileLocking;
+}
+
+//----------------------------------------------------------------------------
+void setScanThreads(int threads){
+//Description: Stores the thread count; 0 defers to the core count.
+    scanThreads = threads < 0 ? 0 : threads;
+}
+
+//----------------------------------------------------------------------------
+int getScanThreads(){
+//Description: Returns the setting, or the core count if it is 0.
+    int threads = scanThreads.load();
+    if (threads == 0) threads = static_cast<int>(thread::hardware_concurrency());
+    return threads < 1 ? 1 : threads;
+}
+
+//----------------------------------------------------------------------------
+void runScanWorkers(int workers, const function<void(int)>& work){
+//Description: Starts workers-1 threads, runs worker 0 here and joins.
+    const StoreSnapshot* snapshot = activeSnapshot;
+    vector<thread> threads;
+    for (int worker = 1; worker < workers; ++worker){
+        threads.push_back(thread([&work, snapshot, worker](){
+            if (snapshot == nullptr){
+                work(worker);
+                return;
+            }
+            StoreSnapshot shared(snapshot->getVersion());
+            work(worker);
+        }));
+    }
+    work(0);
+    for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+}
+
+//----------------------------------------------------------------------------
+bool isSnapshotActive(){
+//Description: Returns whether the calling thread holds a snapshot.
+    return activeSnapshot != nullptr;
+}
+
+//----------------------------------------------------------------------------
+StoreSnapshot::StoreSnapshot() : version(0), previous(activeSnapshot){
+//Description: Pins the latest write version, or the version of the
+//             snapshot already active on this thread.
+    lock_guard<mutex> guard(versionLock);
+    version = previous != nullptr ? previous->version : writeVersion;
+    pinnedVersions.insert(version);
+    ++pinnedSnapshots;
+    activeSnapshot = this;
+}
+
+//----------------------------------------------------------------------------
+StoreSnapshot::StoreSnapshot(unsigned long long pinned) : version(pinned), previous(activeSnapshot){
+//Description: Pins a version another thread holds, for its scan workers.
+    lock_guard<mutex> guard(versionLock);
+    pinnedVersions.insert(version);
+    ++pinnedSnapshots;
+    activeSnapshot = this;
+}
+
+//----------------------------------------------------------------------------
+StoreSnapshot::~StoreSnapshot(){
+//Description: Unpins the version and drops undo records that no remaining
+//             snapshot is older than.
+    activeSnapshot = previous;
+    lock_guard<mutex> guard(versionLock);
+    pinnedVersions.erase(pinnedVersions.find(version));
+    --pinnedSnapshots;
+    unsigned long long upTo = pinnedVersions.empty() ? ULLONG_MAX : *pinnedVersions.begin();
+    for (size_t i = undoFiles.size(); i-- > 0;){
+        if (!undoFiles[i]->dropUndoRecords(upTo)) continue;
+        undoFiles[i]->undoListed = false;
+        undoFiles.erase(undoFiles.begin() + static_cast<long>(i));
+    }
+}
+
+//----------------------------------------------------------------------------
+bool PositionalFile::dropUndoRecords(unsigned long long upTo){
+//Description: Drops the undo records of version upTo and older, and
+//             returns whether none are left.
+    lock_guard<mutex> guard(undoLock);
+    map<unsigned long long, UndoRecord>::iterator it = undoByVersion.begin();
+    while (it != undoByVersion.end() && it->first <= upTo){
+        if (it->second.truncate){
+            undoTruncates.erase(undoTruncates.begin());  //Ascending, like undoByVersion
+        } else{
+            typedef multimap<long long, unsigned long long>::iterator WriteIt;
+            pair<WriteIt, WriteIt> range = undoWrites.equal_range(it->second.offset);
+            for (WriteIt write = range.first; write != range.second; ++write){
+                if (write->second != it->first) continue;
+                undoWrites.erase(write);
+                break;
+            }
+        }
+        it = undoByVersion.erase(it);
+    }
+    if (undoByVersion.empty()) undoWriteSpan = 0;
+    return undoByVersion.empty();
+}
+
+//----------------------------------------------------------------------------
+void PositionalFile::forgetUndoRecords(){
+//Description: Takes the file off the list of files with undo records.
+    if (!undoListed.load()) return;
+    lock_guard<mutex> guard(versionLock);
+    undoFiles.erase(remove(undoFiles.begin(), undoFiles.end(), this), undoFiles.end());
+    undoListed = false;
+}
+
+//----------------------------------------------------------------------------
+void PositionalFile::keepBeforeImage(long long offset, long long bytes){
+//Description: Stores the bytes about to be replaced (bytes < 0: the tail
+//             about to be cut off at offset) while any snapshot is pinned.
+//             The bytes are read before the version lock is taken (the
+//             caller's RecordLock keeps them still); a snapshot pinned
+//             meanwhile is older than the version given afterwards, so it
+//             still undoes the change.
+    if (pinnedSnapshots.load() == 0) return;
+    UndoRecord undo;
+    undo.offset = offset;
+    undo.priorSize = currentSize();
+    undo.truncate = bytes < 0;
+    long long end = bytes < 0 ? undo.priorSize : min(offset + bytes, undo.priorSize);
+    if (end > offset){
+        undo.before.resize(static_cast<size_t>(end - offset));
+        undo.before.resize(readCurrent(offset, &undo.before[0], undo.before.size()));
+    }
+
+    lock_guard<mutex> guard(versionLock);
+    if (pinnedVersions.empty()) return;  //Released while the bytes were read
+    unsigned long long version = ++writeVersion;
+    {
+        lock_guard<mutex> fileGuard(undoLock);
+        if (undo.truncate){
+            undoTruncates.push_back(version);
+        } else{
+            undoWrites.insert(make_pair(offset, version));
+            undoWriteSpan = max(undoWriteSpan, static_cast<long long>(undo.before.size()));
+        }
+        undoByVersion[version] = move(undo);
+    }
+    if (!undoListed.load()){
+        undoFiles.push_back(this);
+        undoListed = true;
+    }
+}
+
+//----------------------------------------------------------------------------
+size_t PositionalFile::readAt(long long offset, void* data, size_t bytes){
+//Description: Reads the file; through a snapshot, clamps to its size and
+//             copies back the bytes of every later change to the range,
+//             newest first. Writes are found by offset: none starts more
+//             than undoWriteSpan bytes before the range and reaches it.
+    if (activeSnapshot == nullptr) return readCurrent(offset, data, bytes);
+    unsigned long long pinned = activeSnapshot->getVersion();
+    long long limit = size();
+    if (offset < 0 || offset >= limit) return 0;
+    if (static_cast<long long>(bytes) > limit - offset) bytes = static_cast<size_t>(limit - offset);
+    char* out = static_cast<char*>(data);
+    size_t got = readCurrent(offset, out, bytes);
+    if (got < bytes) memset(out + got, 0, bytes - got);  //Cut off since; restored below
+
+    long long end = offset + static_cast<long long>(bytes);
+    lock_guard<mutex> guard(undoLock);
+    if (undoByVersion.upper_bound(pinned) == undoByVersion.end()) return bytes;  //Nothing changed since
+    vector<unsigned long long> later;  //Versions of the changes to undo
+    multimap<long long, unsigned long long>::const_iterator write = undoWrites.lower_bound(offset - undoWriteSpan + 1);
+    for (; write != undoWrites.end() && write->first < end; ++write){
+        if (write->second > pinned) later.push_back(write->second);
+    }
+    for (size_t i = undoTruncates.size(); i-- > 0 && undoTruncates[i] > pinned;) later.push_back(undoTruncates[i]);
+    sort(later.begin(), later.end(), greater<unsigned long long>());
+    for (size_t i = 0; i < later.size(); ++i){
+        const UndoRecord& undo = undoByVersion.find(later[i])->second;
+        long long from = max(offset, undo.offset);
+        long long to = min(end, undo.offset + static_cast<long long>(undo.before.size()));
+        if (from < to) memcpy(out + (from - offset), undo.before.data() + (from - undo.offset), static_cast<size_t>(to - from));
+    }
+    return bytes;
+}
+
+//----------------------------------------------------------------------------
+bool PositionalFile::writeAt(long long offset, const void* data, size_t bytes){
+//Description: Keeps the bytes replaced for pinned snapshots, then writes.
+    keepBeforeImage(offset, static_cast<long long>(bytes));
+    return writeCurrent(offset, data, bytes);
+}
+
+//----------------------------------------------------------------------------
+long long PositionalFile::size(){
+//Description: Returns the current size, or through a snapshot the size
+//             before the first change made after it.
+    long long current = currentSize();
+    if (activeSnapshot == nullptr) return current;
+    lock_guard<mutex> guard(undoLock);
+    map<unsigned long long, UndoRecord>::const_iterator first = undoByVersion.upper_bound(activeSnapshot->getVersion());
+    return first == undoByVersion.end() ? current : first->second.priorSize;
+}
+
+//----------------------------------------------------------------------------
+bool PositionalFile::resize(long long newSize){
+//Description: Keeps the tail cut off for pinned snapshots, then resizes.
+    keepBeforeImage(newSize, -1);
+    return resizeCurrent(newSize);
+}
+
+#if !defined(_WIN32)
+
+#if defined(F_OFD_SETLKW)
+static const int rangeLockCommand = F_OFD_SETLKW;  //Lock owned by the descriptor
+#else
+static const int rangeLockCommand = F_SETLKW;      //Lock owned by the process
+#endif
+//A range of a file locked by a RecordLock of this thread. All of a thread's
+//ranges on one file share one descriptor, so they never conflict with each
+//other, and the descriptor's lock on every byte is the strongest mode of the
+//ranges covering it.
+struct HeldRange{
+    const PositionalFile* file;
+    const RecordLock* owner;
+    int fd;
+    long long start;
+    long long end;    //LLONG_MAX for toEndOfFile
+    bool exclusive;
+};
+static thread_local vector<HeldRange> heldRanges;  //Ranges this thread holds a RecordLock on
+
+//----------------------------------------------------------------------------
+static int heldDescriptor(const PositionalFile& file){
+//Description: Returns the descriptor of this thread's locks on file, or -1.
+    for (size_t i = 0; i < heldRanges.size(); ++i){
+        if (heldRanges[i].file == &file) return heldRanges[i].fd;
+    }
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+static int heldMode(const PositionalFile& file, long long start, long long end){
+//Description: Returns the strongest mode (0 none, 1 shared, 2 exclusive)
+//             held by this thread on every byte of [start, end), which the
+//             held ranges' boundaries do not split.
+    int mode = 0;
+    for (size_t i = 0; i < heldRanges.size(); ++i){
+        const HeldRange& held = heldRanges[i];
+        if (held.file != &file || held.start > start || held.end < end) continue;
+        mode = max(mode, held.exclusive ? 2 : 1);
+    }
+    return mode;
+}
+
+//----------------------------------------------------------------------------
+static vector<long long> heldBoundaries(const PositionalFile& file, long long start, long long end){
+//Description: Returns start, end and every held range boundary between
+//             them, ascending, so each pair of neighbours has one mode.
+    vector<long long> cuts(1, start);
+    cuts.push_back(end);
+    for (size_t i = 0; i < heldRanges.size(); ++i){
+        const HeldRange& held = heldRanges[i];
+        if (held.file != &file) continue;
+        if (held.start > start && held.start < end) cuts.push_back(held.start);
+        if (held.end > start && held.end < end) cuts.push_back(held.end);
+    }
+    sort(cuts.begin(), cuts.end());
+    cuts.erase(unique(cuts.begin(), cuts.end()), cuts.end());
+    return cuts;
+}
+
+//----------------------------------------------------------------------------
+static int setRangeLock(int fd, short type, long long start, long long end){
+//Description: Sets, or waits for, a lock of the given type on [start, end).
+//             Returns 0 or the errno of the failure.
+    struct flock range;
+    memset(&range, 0, sizeof(range));
+    range.l_type = type;
+    range.l_whence = SEEK_SET;
+    range.l_start = static_cast<off_t>(start);
+    range.l_len = end == LLONG_MAX ? 0 : static_cast<off_t>(end - start);
+    while (fcntl(fd, rangeLockCommand, &range) != 0){
+        if (errno != EINTR) return errno;
+    }
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+bool isRangeLockedByThisThread(const string& fileName, long long offset, long long length){
+//Description: Looks for one exclusive range of this thread covering the
+//             whole range on a PositionalFile of that name.
+    long long end = length == toEndOfFile ? LLONG_MAX : offset + length;
+    for (size_t i = 0; i < heldRanges.size(); ++i){
+        const HeldRange& held = heldRanges[i];
+        if (held.exclusive && held.start <= offset && held.end >= end &&
+            held.file->getFileName() == fileName){
+            return true;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------
+RecordLock::RecordLock(PositionalFile& file, long long offset, long long length, bool exclusive)
+    : file(file), fd(-1), offset(file.fileOffset(offset)), length(length), held(true){
+//Description: Takes the lock, waiting for conflicting locks to be released.
+//             A range this thread already holds in the same or a stronger
+//             mode is not locked again. An exclusive lock over held shared
+//             ranges upgrades them; a shared lock only locks the parts not
+//             already held exclusive, so it never downgrades them. A file
+//             system without lock support leaves the range unlocked.
+    long long start = this->offset;
+    if (!fileLocking || start < 0) return;
+    long long end = length == toEndOfFile ? LLONG_MAX : start + length;
+    int wanted = exclusive ? 2 : 1;
+    vector<long long> cuts = heldBoundaries(file, start, end);
+    vector<size_t> missing;  //Segments held in a weaker mode than wanted
+    for (size_t i = 0; i + 1 < cuts.size(); ++i){
+        if (heldMode(file, cuts[i], cuts[i + 1]) < wanted) missing.push_back(i);
+    }
+    if (missing.empty()) return;
+
+    int lockFd = heldDescriptor(file);
+    bool pooled = lockFd < 0;
+    if (pooled) lockFd = file.takeLockDescriptor();
+    if (lockFd < 0) return;  //No file yet; the access itself will fail
+    int error = 0;
+    if (exclusive){
+        error = setRangeLock(lockFd, F_WRLCK, start, end);
+    } else{
+        for (size_t i = 0; i < missing.size() && error == 0; ++i){
+            error = setRangeLock(lockFd, F_RDLCK, cuts[missing[i]], cuts[missing[i] + 1]);
+        }
+    }
+    if (error == 0){
+        HeldRange range = {&file, this, lockFd, start, end, exclusive};
+        heldRanges.push_back(range);
+        fd = lockFd;
+        return;
+    }
+    if (pooled) file.returnLockDescriptor(lockFd);
+    held = (error == ENOLCK || error == EOPNOTSUPP || error == EINVAL);
+}
+
+//----------------------------------------------------------------------------
+RecordLock::~RecordLock(){
+//Description: Gives each byte of the range the strongest mode still held by
+//             this thread's other locks on the file (unlocking it if none),
+//             and returns the descriptor to the pool after the last one.
+    if (fd < 0) return;
+    long long end = length == toEndOfFile ? LLONG_MAX : offset + length;
+    for (size_t i = heldRanges.size(); i-- > 0;){
+        if (heldRanges[i].owner == this){
+            heldRanges.erase(heldRanges.begin() + static_cast<long>(i));
+            break;
+        }
+    }
+    vector<long long> cuts = heldBoundaries(file, offset, end);
+    for (size_t i = 0; i + 1 < cuts.size(); ++i){
+        int mode = heldMode(file, cuts[i], cuts[i + 1]);
+        if (mode == 2) continue;  //Still exclusive, as it was
+        setRangeLock(fd, mode == 1 ? F_RDLCK : F_UNLCK, cuts[i], cuts[i + 1]);
+    }
+    if (heldDescriptor(file) < 0) file.returnLockDescriptor(fd);
+}
+
+//----------------------------------------------------------------------------
+int PositionalFile::takeLockDescriptor(){
+//Description: Returns an idle lock descriptor, opening one if none is idle.
+//             Idle descriptors inherited through fork() are closed first.
+    {
+        lock_guard<mutex> guard(lockPoolLock);
+        if (lockPoolPid != static_cast<long>(getpid())){
+            for (size_t i = 0; i < lockFds.size(); ++i) close(lockFds[i]);
+            lockFds.clear();
+            lockPoolPid = static_cast<long>(getpid());
+        }
+        if (!lockFds.empty()){
+            int lockFd = lockFds.back();
+            lockFds.pop_back();
+            return lockFd;
+        }
+    }
+    int lockFd = open(fileName.c_str(), O_RDWR | O_CLOEXEC);
+    if (lockFd < 0) lockFd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    return lockFd;
+}
+
+//----------------------------------------------------------------------------
+void PositionalFile::returnLockDescriptor(int lockFd){
+//Description: Puts a lock descriptor (holding no lock) back in the pool.
+    lock_guard<mutex> guard(lockPoolLock);
+    lockFds.push_back(lockFd);
+}
+
+//----------------------------------------------------------------------------
+void PositionalFile::closeLockDescriptors(){
+//Description: Closes the idle lock descriptors.
+    lock_guard<mutex> guard(lockPoolLock);
+    for (size_t i = 0; i < lockFds.size(); ++i) close(lockFds[i]);
+    lockFds.clear();
+}
+
+//----------------------------------------------------------------------------
+int PositionalFile::descriptor(){
+//Description: Returns the descriptor, opening the file on first use. The
+//             file is opened read/write, or read-only if that is refused.
+    int current = fd.load();
+    if (current >= 0) return current;
+    lock_guard<mutex> guard(openLock);
+    current = fd.load();
+    if (current >= 0) return current;
+
+    current = open(fileName.c_str(), O_RDWR | O_CLOEXEC);
+    if (current < 0) current = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (current < 0) return -1;
+    struct stat info;
+    if (fstat(current, &info) == 0){
+        device = static_cast<unsigned long long>(info.st_dev);
+        inode = static_cast<unsigned long long>(info.st_ino);
+    }
+    fd.store(current);
+    return current;
+}
+
+//----------------------------------------------------------------------------
+void PositionalFile::closeDescriptor(){
+//Description: Closes the descriptor; the next access reopens the file.
+    int current = fd.exchange(-1);
+    if (current >= 0) close(current);
+}
+
+//----------------------------------------------------------------------------
+size_t PositionalFile::readCurrent(long long offset, void* data, size_t bytes){
+//Description: pread()s until the request is filled, EOF or an error.
+    int current = descriptor();
+    offset += headerBytes;
+    if (current < 0 || offset < 0) return 0;
+    char* out = static_cast<char*>(data);
+    size_t done = 0;
+    while (done < bytes){
+        ssize_t got = pread(current, out + done, bytes - done, static_cast<off_t>(offset + done));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        done += static_cast<size_t>(got);
+    }
+    return done;
+}
+
+//----------------------------------------------------------------------------
+bool PositionalFile::writeCurrent(long long offset, const void* data, size_t bytes){
+//Description: pwrite()s until every byte is written or an error occurs.
+    int current = descriptor();
+    offset += headerBytes;
+    if (current < 0 || offset < 0) return false;
+    const char* in = static_cast<const char*>(data);
+    size_t done = 0;
+    while (done < bytes){
+        ssize_t put = pwrite(current, in + done, bytes - done, static_cast<off_t>(offset + done));
+        if (put < 0 && errno == EINTR) continue;
+        if (put <= 0) return false;
+        done += static_cast<size_t>(put);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+long long PositionalFile::currentSize(){
+//Description: Reopens the file if the path now names a different file,
+//             then returns the size of the open descriptor past the header.
+    struct stat pathInfo;
+    if (fd.load() >= 0 && stat(fileName.c_str(), &pathInfo) == 0){
+        lock_guard<mutex> guard(openLock);
+        if (device != static_cast<unsigned long long>(pathInfo.st_dev) ||
+            inode != static_cast<unsigned long long>(pathInfo.st_ino)){
+            closeDescriptor();
+            closeLockDescriptors();  //Locks must be taken on the new file
+        }
+    }
+    int current = descriptor();
+    struct stat info;
+    if (current < 0 || fstat(current, &info) != 0) return -1;
+    return max(0LL, static_cast<long long>(info.st_size) - headerBytes);
+}
+
+//----------------------------------------------------------------------------
+bool PositionalFile::resizeCurrent(long long newSize){
+//Description: ftruncate()s the open descriptor.
+    int current = descriptor();
+    return current >= 0 && newSize >= 0 && ftruncate(current, static_cast<off_t>(newSize + headerBytes)) == 0;
+}
+
+//----------------------------------------------------------------------------
+void releaseMappedRegion(MappedRegion& region){
+//Description: Unmaps the region and closes its descriptor.
+    if (region.data != nullptr) munmap(const_cast<char*>(region.data), region.mappedBytes);
+    if (region.fd >= 0) close(region.fd);
+    region = MappedRegion();
+}
+
+//----------------------------------------------------------------------------
+static void deleteMappedRegion(MappedRegion* region){
+//Description: shared_ptr deleter: unmaps and frees a mapping nobody reads.
+    releaseMappedRegion(*region);
+    delete region;
+}
+
+//----------------------------------------------------------------------------
+bool refreshMappedRegion(const string& fileName, shared_ptr<const MappedRegion>& region, size_t& fileBytes){
+//Description: Opens and maps the file on first use, starts over if it was
+//             replaced, and maps it afresh when it has grown past the
+//             mapping. The caller serializes refreshes of one region.
+    struct stat pathInfo;
+    if (stat(fileName.c_str(), &pathInfo) != 0){
+        region.reset();
+        return false;
+    }
+    if (region && (region->device != static_cast<unsigned long long>(pathInfo.st_dev) ||
+                   region->inode != static_cast<unsigned long long>(pathInfo.st_ino))){
+        region.reset();  //File was replaced; start over
+    }
+    fileBytes = static_cast<size_t>(pathInfo.st_size);
+    if (region && fileBytes <= region->mappedBytes) return true;
+
+    shared_ptr<MappedRegion> next(new MappedRegion, deleteMappedRegion);
+    next->fd = region ? dup(region->fd) : open(fileName.c_str(), O_RDONLY);
+    if (next->fd < 0) return false;
+    next->device = static_cast<unsigned long long>(pathInfo.st_dev);
+    next->inode = static_cast<unsigned long long>(pathInfo.st_ino);
+    if (fileBytes > 0){
+        size_t wanted = fileBytes * 2 < minMappingBytes ? minMappingBytes : fileBytes * 2;
+        void* data = mmap(nullptr, wanted, PROT_READ, MAP_SHARED, next->fd, 0);
+        if (data == MAP_FAILED) return false;
+        next->data = static_cast<const char*>(data);
+        next->mappedBytes = wanted;
+    }
+    region = next;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+void adviseMappedRegion(const MappedRegion& region, bool sequential){
+//Description: Switches the mapping between sequential and normal readahead.
+    if (region.data == nullptr) return;
+    madvise(const_cast<char*>(region.data), region.mappedBytes, sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+}
+
+//----------------------------------------------------------------------------
+int openSequentialReader(const string& fileName){
+//Description: Opens the file read-only and hints sequential access so the
+//             kernel reads ahead aggressively.
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) return -1;
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return fd;
+}
+
+//----------------------------------------------------------------------------
+size_t readSequentialBlock(int fd, char* buffer, size_t bytes){
+//Description: Fills the buffer with one read() call in the common case,
+//             continuing after short reads until the buffer is full or EOF.
+    size_t done = 0;
+    while (done < bytes){
+        ssize_t got = read(fd, buffer + done, bytes - done);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        done += static_cast<size_t>(got);
+    }
+    return done;
+}
+
+//----------------------------------------------------------------------------
+void closeSequentialReader(int fd){
+//Description: Closes a descriptor from openSequentialReader.
+    if (fd >= 0) close(fd);
+}
+
+//----------------------------------------------------------------------------
+bool claimDataFile(const string& fileName){
+//Description: Takes the flock without waiting and keeps its descriptor
+//             open for the life of the process.
+    static mutex claimLock;
+    static map<string, int> claimed;  //File name -> descriptor holding the flock
+    lock_guard<mutex> guard(claimLock);
+    if (claimed.count(fileName) > 0) return true;
+    int fd = open(fileName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    int result;
+    while ((result = flock(fd, LOCK_EX | LOCK_NB)) != 0 && errno == EINTR){}
+    if (result != 0 && errno == EWOULDBLOCK){
+        close(fd);
+        return false;
+    }
+    claimed[fileName] = fd;  //Also kept where the file system has no flock
+    return true;
+}
+
+#else
+
+//----------------------------------------------------------------------------
+bool isRangeLockedByThisThread(const string&, long long, long long){
+//Description: No locks are taken on this platform.
+    return false;
+}
+
+//----------------------------------------------------------------------------
+bool claimDataFile(const string&){
+//Description: File locks are not implemented on this platform.
+    return true;
+}
+
+//----------------------------------------------------------------------------
+RecordLock::RecordLock(PositionalFile& file, long long offset, long long length, bool)
+    : file(file), fd(-1), offset(file.fileOffset(offset)), length(length), held(true){
+//Description: Byte-range locks are not implemented on this platform.
+}
+
+//----------------------------------------------------------------------------
+RecordLock::~RecordLock(){
+//Description: No lock was taken.
+}
+
+//----------------------------------------------------------------------------
+int PositionalFile::takeLockDescriptor(){
+//Description: Never called on this platform.
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+void PositionalFile::returnLockDescriptor(int){
+//Description: Never called on this platform.
+}
+
+//----------------------------------------------------------------------------
+void PositionalFile::closeLockDescriptors(){
+//Description: No lock descriptors are opened on this platform.
+}
+
+//----------------------------------------------------------------------------
+int PositionalFile::descriptor(){
+//Description: Opens the private fstream on first use; callers hold openLock.
+    if (!fallback.is_open()) fallback.open(fileName.c_str(), ios::in | ios::out | ios::binary);
+    return fallback.is_open() ? 0 : -1;
+}
+
+//----------------------------------------------------------------------------
+void PositionalFile::closeDescriptor(){
+//Description: Closes the private fstream.
+    if (fallback.is_open()) fallback.close();
+}
+
+//----------------------------------------------------------------------------
+size_t PositionalFile::readCurrent(long long offset, void* data, size_t bytes){
+//Description: Seeks and reads under openLock, so callers never share a cursor.
+    lock_guard<mutex> guard(openLock);
+    offset += headerBytes;
+    if (descriptor() < 0 || offset < 0) return 0;
+    fallback.clear();
+    fallback.seekg(static_cast<streampos>(offset), ios::beg);
+    fallback.read(static_cast<char*>(data), static_cast<streamsize>(bytes));
+    return static_cast<size_t>(fallback.gcount());
+}
+
+//----------------------------------------------------------------------------
+bool PositionalFile::writeCurrent(long long offset, const void* data, size_t bytes){
+//Description: Seeks and writes under openLock.
+    lock_guard<mutex> guard(openLock);
+    offset += headerBytes;
+    if (descriptor() < 0 || offset < 0) return false;
+    fallback.clear();
+    fallback.seekp(static_cast<streampos>(offset), ios::beg);
+    fallback.write(static_cast<const char*>(data), static_cast<streamsize>(bytes));
+    fallback.flush();
+    return fallback.good();
+}
+
+//----------------------------------------------------------------------------
+long long PositionalFile::currentSize(){
+//Description: Seeks to the end of the private fstream.
+    lock_guard<mutex> guard(openLock);
+    if (descriptor() < 0) return -1;
+    fallback.clear();
+    fallback.seekg(0, ios::end);
+    return max(0LL, static_cast<long long>(fallback.tellg()) - headerBytes);
+}
+
+//----------------------------------------------------------------------------
+bool PositionalFile::resizeCurrent(long long){
+//Description: Truncation needs ftruncate; not available on this platform.
+    return false;
+}
+
+//----------------------------------------------------------------------------
+void releaseMappedRegion(MappedRegion& region){
+//Description: Nothing is ever mapped on this platform.
+    region = MappedRegion();
+}
+
+//----------------------------------------------------------------------------
+bool refreshMappedRegion(const string&, shared_ptr<const MappedRegion>&, size_t&){
+//Description: Mapping is not supported here; callers use the fstream path.
+    return false;
+}
+
+//----------------------------------------------------------------------------
+void adviseMappedRegion(const MappedRegion&, bool){
+//Description: No mappings to advise on this platform.
+}
+
+//----------------------------------------------------------------------------
+int openSequentialReader(const string&){
+//Description: RecordBatchReader falls back to block reads on the fstream.
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+size_t readSequentialBlock(int, char*, size_t){
+//Description: Never called without a descriptor.
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+void closeSequentialReader(int){
+//Description: Nothing to close on this platform.
+}
+
+#endif
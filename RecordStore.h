@@ -0,0 +1,794 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: RecordStore.h
+// Rev.17 - 18/10/2026 - Mappings are shared and pinned by the readers using
+//                       them (MappedRecordFile::View), so a remap never
+//                       unmaps memory another thread is reading.
+// Rev.16 - 18/10/2026 - Added claimDataFile, which keeps a file to one process.
+// Rev.15 - 18/10/2026 - Each PositionalFile keeps its own undo records,
+//                       indexed by version and by offset.
+// Rev.14 - 18/10/2026 - The header's spare field is a generation counter the
+//                       header check ignores; added readHeader.
+// Rev.13 - 18/10/2026 - The lock descriptor pool notes the process that
+//                       filled it.
+// Rev.12 - 18/10/2026 - Added RecordFileHeader: a data file may start with a
+//                       versioned header that record offsets skip.
+// Rev.11 - 18/10/2026 - Added isRangeLockedByThisThread.
+// Rev.10 - 18/10/2026 - A nested RecordLock is skipped only when the thread
+//                       already holds its range in the same or a stronger mode.
+// Rev.9 - 17/10/2026 - Added parallelScanRecords: chunked scans on a pool of
+//                      worker threads, merged from per-worker partial results.
+// Rev.8 - 17/10/2026 - Added scanRecordBatches, which hands whole blocks of
+//                      records to the visitor; scanRecords is built on it.
+// Rev.7 - 17/10/2026 - Added StoreSnapshot: read-only operations can pin the
+//                      files as they were, while writers keep going.
+// Rev.6 - 17/10/2026 - Added RecordLock (fcntl byte-range locks); scans and
+//                      point reads hold shared locks on what they read.
+// Rev.5 - 17/10/2026 - RecordBatchReader keeps block reads in flight through
+//                      the io_uring backend when it is available.
+// Rev.4 - 17/10/2026 - Added PositionalFile; record reads, writes, sizes and
+//                      truncation use pread/pwrite instead of the fstream cursor.
+// Rev.3 - 17/10/2026 - Added the tombstone compaction threshold.
+// Rev.2 - 17/10/2026 - Added RecordBatchReader for block-buffered sequential scans.
+// Rev.1 - 17/10/2026 - Memory-mapped record store shared by the FileIO modules.
+//
+// ----------------------------------------------------------------------------
+// This header declares the storage layer underneath the four FileIO modules.
+// A data file of fixed-length records can be mapped into memory and used as a
+// read-only typed array (MappedRecordFile<T>), so scans and point reads are
+// plain memory accesses instead of seekg/read calls on the shared fstream.
+//
+// Everything else goes through a PositionalFile: one descriptor per data
+// file, read and written with pread/pwrite at explicit offsets. There is no
+// shared cursor to seek, so threads can read the same file at once and a
+// record access is one system call. Writes reach the page cache directly and
+// are therefore visible through the mapping, which is refreshed before each
+// use so it follows appends (growing and remapping when the file outgrows
+// it) and truncating deletes. Each refresh hands the reader a View that
+// pins the mapping it reads; a remap maps the file afresh and the old
+// mapping is only unmapped once its last View is gone, so threads may read
+// and refresh one MappedRecordFile at once.
+//
+// scanRecords and readRecordAt pick the mapped path when it is enabled and
+// available, and fall back to positional reads otherwise (or on platforms
+// without mmap). Fallback scans use RecordBatchReader, which fills a whole
+// buffer of records per read call and tells the kernel the access is
+// sequential. On large files with the asynchronous backend (IoRing.h) the
+// reader has several blocks in flight ahead of the one being visited, which
+// keeps a fast device busy during long scans. Mapped scans give the
+// sequential hint for the duration of the scan. scanRecordBatches hands the
+// visitor whole blocks instead of single records (the entire mapping on the
+// mapped path), for scans that match keys many records at a time.
+//
+// Filters and aggregates over a whole file can use parallelScanRecords
+// instead. The file is cut into chunks of parallelScanChunkRecords records
+// that a pool of worker threads (one per core by default) takes in turn;
+// each worker folds its records into a partial result of its own, so the
+// workers share nothing but the chunk counter, and the partials are merged
+// on the calling thread at the end. Workers read at the caller's snapshot,
+// if it has one. Files under parallelScanMinRecords records are scanned on
+// the calling thread alone.
+//
+// A data file may start with a RecordFileHeader naming its kind (magic),
+// the layout version of its records and the record size, so a file written
+// by an older FerryQ is refused instead of misread. A PositionalFile or
+// MappedRecordFile constructed with the header size hides it: record
+// offsets, sizes, locks and scans all start after the header. Only the
+// write-ahead log sees offsets in the file on disk (fileOffset()). The
+// header also carries a generation, which a FileIO module may bump when it
+// changes records in place, so other processes know their in-memory
+// indexes of the file are stale; the format check ignores it.
+//
+// Several FerryQ processes may share the data files. RecordLock takes an
+// advisory fcntl lock on a byte range: scanRecords holds a shared lock on the
+// whole file and readRecordAt one on its record, while the FileIO modules
+// hold exclusive locks on a record they overwrite, on the tail of the file
+// when appending, and on the whole file when compacting. A thread's locks on
+// one file nest: a lock on a range the thread already holds in the same or a
+// stronger mode takes nothing, an exclusive lock over a shared one upgrades
+// it, and releasing the inner lock leaves the outer one as it was. A store
+// whose in-memory state cannot follow another process's writes claims its
+// file instead (claimDataFile): an exclusive flock held while the process
+// runs, so a second process is refused rather than let in.
+//
+// A StoreSnapshot pins the current version of every data file for the
+// thread that creates it. While any snapshot is pinned, PositionalFile keeps
+// the bytes each write or truncate replaces (an undo record), and reads made
+// by a thread with a snapshot put those bytes back over what is on disk, so
+// a report sees exactly the files as they were when it started. Writers
+// never wait for readers; undo records are dropped once the oldest snapshot
+// that needs them is released. Snapshots cover writes made through
+// PositionalFile in this process.
+// ----------------------------------------------------------------------------
+
+#ifndef RECORD_STORE_H
+#define RECORD_STORE_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include "IoRing.h"
+using namespace std;
+
+const int scanBatchRecords = 1024;  //Records fetched per read call during scans
+const int parallelScanChunkRecords = 16384;  //Records a scan worker takes at a time
+const int parallelScanMinRecords = 65536;    //Smaller files are scanned by the caller alone
+const float defaultCompactionThreshold = 0.25f;  //Dead fraction that triggers compaction
+const long long toEndOfFile = 0;  //RecordLock length reaching past the end of file, however it grows
+
+//Header at the start of a versioned data file
+struct RecordFileHeader{
+    char magic[4];             //Kind of file
+    unsigned int version;      //Layout version of the records
+    unsigned int recordBytes;  //Size of one record
+    unsigned int generation;   //Changes to existing records (not part of the format)
+};
+const long long recordFileHeaderBytes = static_cast<long long>(sizeof(RecordFileHeader));
+
+//What a data file holds where its RecordFileHeader belongs
+enum RecordFileState{
+    recordFileEmpty,     //nothing yet; the header is written with the first record
+    recordFileCurrent,   //the expected header
+    recordFileOutdated   //anything else: an older layout or another kind of file
+};
+
+//Where record reads are served from
+enum RecordStoreMode{
+    streamRecordStore,  //positional reads on the PositionalFile
+    mappedRecordStore   //memory-mapped typed arrays (default where supported)
+};
+
+//A change to a data file, kept so snapshots older than it can undo it
+//(managed by RecordStore.cpp)
+struct UndoRecord{
+    long long offset;            //First byte changed (new size, for a truncate)
+    long long priorSize;         //File size before the change
+    bool truncate;               //Cut the file at offset instead of writing there
+    string before;               //Bytes from offset before the change, up to priorSize
+};
+
+//Platform mapping of one data file (managed by RecordStore.cpp); never
+//changed once shared, a remap makes a new one
+struct MappedRegion{
+    MappedRegion() : fd(-1), data(nullptr), mappedBytes(0), device(0), inode(0){}
+    int fd;                    //Open read-only descriptor (-1 if none)
+    const char* data;          //Start of mapping (nullptr if nothing mapped)
+    size_t mappedBytes;        //Size of the mapping (may exceed the file)
+    unsigned long long device; //Identity of the mapped file, to notice
+    unsigned long long inode;  //the file being replaced
+};
+
+//----------------------------------------------------------------------------
+void setRecordStoreMode(RecordStoreMode mode//input
+                        );
+//Job: Selects whether record reads use memory mappings or positional reads.
+//Usage: Called at startup; the mapped mode is the default.
+//Restrictions: Mapped mode silently falls back to streams if mapping fails.
+
+//----------------------------------------------------------------------------
+RecordStoreMode getRecordStoreMode();
+//Job: Returns the currently selected record store mode.
+//Usage: Used by scanRecords/readRecordAt to choose a read path.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+void setCompactionThreshold(float deadFraction//input
+                            );
+//Job: Sets the fraction of tombstoned records at which a data file is compacted.
+//Usage: Called at startup; 0 compacts on every delete, 1 only once every
+//       record in the file is dead.
+//Restrictions: Values are clamped to [0, 1].
+
+//----------------------------------------------------------------------------
+bool isCompactionDue(int deadRecords, //input
+                     int totalRecords //input
+                     );
+//Job: Returns true once deadRecords / totalRecords reaches the threshold.
+//Usage: Checked by the FileIO modules after each delete.
+//Restrictions: Returns false when there are no dead records.
+
+//----------------------------------------------------------------------------
+void setFileLocking(bool enabled//input
+                    );
+//Job: Switches the byte-range locks taken by RecordLock on or off.
+//Usage: Called at startup; on by default.
+//Restrictions: Only safe to switch off when no other process uses the files.
+
+//----------------------------------------------------------------------------
+bool isFileLockingEnabled();
+//Job: Returns whether RecordLock takes locks.
+//Usage: Checked by RecordLock.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+bool refreshMappedRegion(const string& fileName,                //input
+                         shared_ptr<const MappedRegion>& region, //input/output
+                         size_t& fileBytes                       //output
+                         );
+//Job: Maps the file, or replaces region with a new mapping once the file
+//     has outgrown it or been replaced; sets fileBytes to the file's size.
+//Usage: Called before each use of a mapping. Grows the mapping geometrically
+//       so a run of appends does not remap on every record.
+//Restrictions: Returns false if the file cannot be mapped on this platform.
+//              A replaced mapping is not touched; it is released with its
+//              last shared_ptr.
+
+//----------------------------------------------------------------------------
+void releaseMappedRegion(MappedRegion& region//input/output
+                         );
+//Job: Unmaps the region and closes its descriptor.
+//Usage: Called when the last holder of a shared mapping lets it go.
+//Restrictions: Safe to call on an unmapped region.
+
+//----------------------------------------------------------------------------
+void adviseMappedRegion(const MappedRegion& region, //input
+                        bool sequential              //input
+                        );
+//Job: Tells the kernel whether the mapping is about to be read front to back.
+//Usage: Set before a full scan and cleared afterwards so point reads keep
+//       normal readahead.
+//Restrictions: Advisory only; ignored where unsupported.
+
+//----------------------------------------------------------------------------
+int openSequentialReader(const string& fileName//input
+                         );
+//Job: Opens a private read-only descriptor positioned at the start of the
+//     file, advised for sequential access.
+//Usage: Used by RecordBatchReader. Returns -1 where unsupported.
+//Restrictions: Close with closeSequentialReader.
+
+//----------------------------------------------------------------------------
+size_t readSequentialBlock(int fd,        //input
+                           char* buffer,  //output
+                           size_t bytes   //input
+                           );
+//Job: Reads up to bytes from the descriptor, retrying short reads.
+//Usage: Used by RecordBatchReader to fill its caller's buffer.
+//Restrictions: Returns fewer bytes only at end of file or on error.
+
+//----------------------------------------------------------------------------
+void closeSequentialReader(int fd//input
+                           );
+//Job: Closes a descriptor from openSequentialReader.
+//Usage: Called by RecordBatchReader on destruction.
+//Restrictions: Safe to call with -1.
+
+//----------------------------------------------------------------------------
+void setScanThreads(int threads//input
+                    );
+//Job: Sets how many threads parallelScanRecords may use.
+//Usage: Called at startup; 0 (the default) means one per core.
+//Restrictions: Negative values count as 0; 1 keeps every scan on the caller.
+
+//----------------------------------------------------------------------------
+int getScanThreads();
+//Job: Returns the number of threads parallelScanRecords may use.
+//Usage: Used by parallelScanRecords to size its worker pool.
+//Restrictions: Always at least 1.
+
+//----------------------------------------------------------------------------
+void runScanWorkers(int workers,                        //input
+                    const function<void(int)>& work     //input
+                    );
+//Job: Calls work(worker) for worker = 0..workers-1 at the same time, on the
+//     calling thread and workers-1 new threads, and waits for all of them.
+//Usage: Worker pool of parallelScanRecords.
+//Restrictions: Each new thread reads at the caller's snapshot, if it has one.
+
+//----------------------------------------------------------------------------
+bool isSnapshotActive();
+//Job: Returns whether the calling thread reads through a StoreSnapshot.
+//Usage: Read paths that keep their own caches bypass them while it does.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+RecordFileHeader makeRecordFileHeader(const char* magic,        //input
+                                      unsigned int version,     //input
+                                      unsigned int recordBytes  //input
+                                      );
+//Job: Builds the header a data file of the given kind and layout starts with.
+//Usage: Each FileIO module with a versioned file keeps one as a constant.
+//Restrictions: magic supplies the first 4 characters.
+
+//Positional (pread/pwrite) access to one data file, with no shared cursor
+class PositionalFile{
+public:
+    explicit PositionalFile(const string& fileName, long long headerBytes = 0)
+        : fileName(fileName), headerBytes(headerBytes), fd(-1), device(0), inode(0), lockPoolPid(0),
+          undoWriteSpan(0), undoListed(false){}
+    ~PositionalFile(){
+        forgetUndoRecords();
+        closeLockDescriptors();
+        closeDescriptor();
+    }
+
+//----------------------------------------------------------------------------
+    size_t readAt(long long offset, //input
+                  void* data,       //output
+                  size_t bytes      //input
+                  );
+    //Job: Reads up to bytes starting at offset; with a snapshot active on
+    //     this thread, as they were when it was taken.
+    //Usage: Point reads and block reads of the FileIO modules.
+    //Restrictions: Returns fewer bytes only at end of file or on error.
+    //              Safe to call from several threads at once.
+
+//----------------------------------------------------------------------------
+    bool writeAt(long long offset,   //input
+                 const void* data,   //input
+                 size_t bytes        //input
+                 );
+    //Job: Writes bytes at offset, extending the file if needed. Keeps the
+    //     bytes replaced while a snapshot is pinned.
+    //Usage: Called after the write has been reported to the write-ahead log.
+    //Restrictions: Returns false unless every byte was written. Writers
+    //              that must not interleave are serialized by the caller.
+
+//----------------------------------------------------------------------------
+    long long size();
+    //Job: Returns the current size of the file in bytes, or -1 on error;
+    //     with a snapshot active on this thread, the size it had then.
+    //Usage: Record counts, and the offset of the next append.
+    //Restrictions: Reopens the file first if it was replaced on disk.
+
+//----------------------------------------------------------------------------
+    bool resize(long long newSize//input
+                );
+    //Job: Truncates (or extends with zeros) the file to newSize bytes.
+    //Usage: Called by compaction after the truncation has been logged.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    RecordFileState checkHeader(const RecordFileHeader& expected//input
+                                );
+    //Job: Compares the magic, version and record size before the first
+    //     record with the expected header; the generation is not compared.
+    //Usage: Called by the FileIO modules under an exclusive RecordLock on
+    //       the header (offset -recordFileHeaderBytes) before using a file.
+    //Restrictions: A file too short to hold a header but not empty is
+    //              outdated.
+
+//----------------------------------------------------------------------------
+    bool writeHeader(const RecordFileHeader& header//input
+                     );
+    //Job: Writes the header at the start of the file.
+    //Usage: Gives an empty file its header, after logging the write.
+    //Restrictions: Only for a file constructed with the header size.
+
+//----------------------------------------------------------------------------
+    bool readHeader(RecordFileHeader& header//output
+                    );
+    //Job: Reads the header at the start of the file.
+    //Usage: Reads the generation a FileIO module's in-memory index was
+    //       built from, or bumps it under the header lock.
+    //Restrictions: Returns false if the file has no whole header. Takes no
+    //              lock; the 16-byte header is written with one pwrite.
+
+//----------------------------------------------------------------------------
+    long long fileOffset(long long offset) const{ return offset + headerBytes; }
+    //Job: Returns where a record offset lies in the file on disk.
+    //Usage: Offsets and sizes reported to the write-ahead log.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    const string& getFileName() const{ return fileName; }
+    //Job: Returns the data file this object reads and writes.
+    //Usage: Lets other readers of the same file open it by name.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+private:
+    friend class RecordLock;
+    friend class StoreSnapshot;
+    PositionalFile(const PositionalFile&);
+    PositionalFile& operator=(const PositionalFile&);
+    int descriptor();
+    void closeDescriptor();
+    size_t readCurrent(long long offset, void* data, size_t bytes);
+    bool writeCurrent(long long offset, const void* data, size_t bytes);
+    long long currentSize();
+    bool resizeCurrent(long long newSize);
+    void keepBeforeImage(long long offset, long long bytes);
+    bool dropUndoRecords(unsigned long long upTo);
+    void forgetUndoRecords();
+    int takeLockDescriptor();
+    void returnLockDescriptor(int lockFd);
+    void closeLockDescriptors();
+    string fileName;              //Data file behind the descriptor
+    long long headerBytes;        //Bytes before the first record, hidden from offsets
+    atomic<int> fd;               //Open read/write descriptor (-1 until first use)
+    mutex openLock;               //Serializes opening and reopening
+    unsigned long long device;    //Identity of the open file, to notice
+    unsigned long long inode;     //the file being replaced
+    fstream fallback;             //Used where pread/pwrite are unavailable
+    vector<int> lockFds;          //Idle descriptors for RecordLock
+    mutex lockPoolLock;           //Guards lockFds and lockPoolPid
+    long lockPoolPid;             //Process the idle descriptors belong to
+    mutex undoLock;               //Guards the undo records below
+    map<unsigned long long, UndoRecord> undoByVersion;      //Kept changes by write version
+    multimap<long long, unsigned long long> undoWrites;     //Offset -> version, writes only
+    vector<unsigned long long> undoTruncates;               //Versions of the truncates, ascending
+    long long undoWriteSpan;      //Longest before-image in undoWrites
+    atomic<bool> undoListed;      //On the list of files with undo records
+};
+
+//Version of the data files pinned for reading by the creating thread. It is
+//declared on the stack around a read-only operation (report, export, query)
+//and every read the thread makes meanwhile sees the same version; one taken
+//while another is active shares its version. Take it when no write-ahead log
+//transaction is half applied (the daemon takes it under its store lock), and
+//do not write from the thread while holding it.
+class StoreSnapshot{
+public:
+    StoreSnapshot();
+    ~StoreSnapshot();
+
+//----------------------------------------------------------------------------
+    unsigned long long getVersion() const{ return version; }
+    //Job: Returns the write version the snapshot reads at.
+    //Usage: Diagnostics and tests.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+private:
+    friend void runScanWorkers(int workers, const function<void(int)>& work);
+    explicit StoreSnapshot(unsigned long long pinned);
+    StoreSnapshot(const StoreSnapshot&);
+    StoreSnapshot& operator=(const StoreSnapshot&);
+    unsigned long long version;     //Writes after this version are undone
+    const StoreSnapshot* previous;  //Snapshot active on the thread before this one
+};
+
+//Advisory byte-range lock on a data file, held for the object's lifetime
+class RecordLock{
+public:
+    RecordLock(PositionalFile& file,  //input
+               long long offset,      //input
+               long long length,      //input
+               bool exclusive         //input
+               );
+    //Offsets are record offsets; the file header, if any, lies at
+    //-recordFileHeaderBytes.
+    ~RecordLock();
+
+//----------------------------------------------------------------------------
+    bool isHeld() const{ return held; }
+    //Job: Returns whether the range may now be read (shared) or written
+    //     (exclusive).
+    //Usage: Writers give up when false; readers may go ahead regardless.
+    //Restrictions: True without a lock when locking is switched off, not
+    //              supported by the file system, or already covered by
+    //              locks this thread holds on the file in the same or a
+    //              stronger mode. An upgrade waits for other holders.
+
+//----------------------------------------------------------------------------
+private:
+    RecordLock(const RecordLock&);
+    RecordLock& operator=(const RecordLock&);
+    PositionalFile& file;  //File the range belongs to
+    int fd;                //Descriptor owning the lock (-1 if none taken),
+                           //shared by the thread's locks on the file
+    long long offset;      //Locked range in the file on disk; length
+                           //toEndOfFile reaches past EOF
+    long long length;
+    bool held;             //See isHeld()
+};
+
+//----------------------------------------------------------------------------
+bool isRangeLockedByThisThread(const string& fileName, //input
+                               long long offset,       //input
+                               long long length        //input
+                               );
+//Job: Returns whether the calling thread holds an exclusive RecordLock
+//     covering the range of the named data file.
+//Usage: Lets the write-ahead log restore bytes under the caller's lock
+//       instead of taking a conflicting one of its own.
+//Restrictions: offset is in the file on disk, header included. length
+//              toEndOfFile reaches past the end of file.
+
+//----------------------------------------------------------------------------
+bool claimDataFile(const string& fileName //input
+                   );
+//Job: Takes an exclusive flock on the named file (created if missing) and
+//     keeps it until the process exits.
+//Usage: Called when a store that only one process may use is opened.
+//Restrictions: Returns false if another process holds the claim; true if
+//              this process already does, or where flock is unavailable.
+
+
+//Read-only typed-array view of a data file of T records
+template <class T>
+class MappedRecordFile{
+public:
+    //The mapping as of one refresh, kept mapped while the View is held
+    class View{
+    public:
+        View() : fileBytes(0), headerBytes(0){}
+
+//----------------------------------------------------------------------------
+        void adviseSequential(bool sequential) const{ adviseMappedRegion(*region, sequential); }
+        //Job: Sets or clears the sequential-access hint on the mapping.
+        //Usage: Wrapped around full scans by scanRecords.
+        //Restrictions: Valid after a successful refresh().
+
+//----------------------------------------------------------------------------
+        int size() const{
+            return fileBytes > headerBytes ? static_cast<int>((fileBytes - headerBytes) / sizeof(T)) : 0;
+        }
+        //Job: Returns the number of whole records in the file at the refresh.
+        //Usage: Bound for loops over the array.
+        //Restrictions: Valid after a successful refresh().
+
+//----------------------------------------------------------------------------
+        const T& operator[](int index) const{ return reinterpret_cast<const T*>(region->data + headerBytes)[index]; }
+        //Job: Returns the record at the given zero-based index.
+        //Usage: Plain memory access into the mapping.
+        //Restrictions: 0 <= index < size().
+
+//----------------------------------------------------------------------------
+    private:
+        friend class MappedRecordFile;
+        shared_ptr<const MappedRegion> region;  //Pinned mapping
+        size_t fileBytes;                        //File size at the refresh
+        size_t headerBytes;                      //Bytes before the first record
+    };
+
+    explicit MappedRecordFile(const string& fileName, long long headerBytes = 0)
+        : fileName(fileName), headerBytes(static_cast<size_t>(headerBytes)){}
+
+//----------------------------------------------------------------------------
+    bool refresh(View& view){
+        lock_guard<mutex> guard(regionLock);
+        if (!refreshMappedRegion(fileName, region, view.fileBytes)) return false;
+        view.region = region;
+        view.headerBytes = headerBytes;
+        return true;
+    }
+    //Job: Brings the mapping up to date with the file's current size and
+    //     pins it in view.
+    //Usage: Called before reading; required after appends or truncation.
+    //       Threads may refresh and read at once; each reads its own View.
+    //Restrictions: Returns false if the file cannot be mapped.
+
+//----------------------------------------------------------------------------
+    const string& getFileName() const{ return fileName; }
+    //Job: Returns the data file this view maps.
+    //Usage: Lets other readers of the same file open it by name.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+private:
+    MappedRecordFile(const MappedRecordFile&);
+    MappedRecordFile& operator=(const MappedRecordFile&);
+    string fileName;                        //Data file backing the mapping
+    size_t headerBytes;                     //Bytes before the first record
+    mutex regionLock;                       //Guards region across refreshes
+    shared_ptr<const MappedRegion> region;  //Current mapping, shared with the Views reading it
+};
+
+//Sequential reader that returns a caller-sized batch of records per call
+template <class T>
+class RecordBatchReader{
+public:
+    explicit RecordBatchReader(PositionalFile& file)
+        : file(file), fd(openSequentialReader(file.getFileName())), offset(0){
+        if (fd >= 0 && isAsyncIoEnabled() && file.size() >= asyncScanMinBytes){
+            async.reset(new AsyncBlockReader(fd, asyncReadBlockBytes, asyncReadDepth));
+            if (!async->isOpen()) async.reset();
+        }
+        size_t headerBytes = static_cast<size_t>(file.fileOffset(0));
+        if (headerBytes > 0){
+            //Step over the header; a short one leaves nothing to read
+            vector<char> header(headerBytes);
+            if (async){
+                async->read(&header[0], headerBytes);
+            } else if (fd >= 0){
+                readSequentialBlock(fd, &header[0], headerBytes);
+            }
+        }
+    }
+    ~RecordBatchReader(){
+        async.reset();  //Drain reads in flight before closing their descriptor
+        closeSequentialReader(fd);
+    }
+
+//----------------------------------------------------------------------------
+    int readBatch(T* records,     //output
+                  int maxRecords  //input
+                  ){
+    //Job: Fills records with up to maxRecords of the next records in the file.
+    //Usage: Call repeatedly until it returns 0.
+    //Restrictions: Returns the number of whole records read.
+        size_t bytes = static_cast<size_t>(maxRecords) * sizeof(T);
+        size_t got;
+        if (async){
+            got = async->read(reinterpret_cast<char*>(records), bytes);
+        } else if (fd >= 0){
+            got = readSequentialBlock(fd, reinterpret_cast<char*>(records), bytes);
+        } else{
+            got = file.readAt(offset, records, bytes);
+            offset += static_cast<long long>(got);
+        }
+        return static_cast<int>(got / sizeof(T));
+    }
+
+//----------------------------------------------------------------------------
+private:
+    RecordBatchReader(const RecordBatchReader&);
+    RecordBatchReader& operator=(const RecordBatchReader&);
+    PositionalFile& file;  //Fallback source when no descriptor could be opened
+    int fd;                //Private sequential descriptor (-1 if unavailable)
+    long long offset;      //Next byte to read from file on the fallback path
+    unique_ptr<AsyncBlockReader> async;  //Read-ahead on fd (null if unused)
+};
+
+//----------------------------------------------------------------------------
+template <class T, class Visitor>
+int scanRecordBatches(PositionalFile& file,         //input
+                      MappedRecordFile<T>& mapped,  //input
+                      Visitor visit                 //input
+                      ){
+//Job: Calls visit(records, count, firstIndex) for consecutive blocks of
+//     records in file order until it returns a position in the block.
+//Usage: Scans that test many records at once (ScanKernel.h); visit returns
+//       the position of the record to stop at, or -1 to go on.
+//Restrictions: Returns the index of the record visit stopped at, or -1 if it
+//              saw every record. The block is only valid during the call.
+    if (isSnapshotActive()){
+        //Blocks read through the snapshot, each under its own short lock,
+        //so writers are never held up for the length of the scan
+        vector<T> batch(scanBatchRecords);
+        size_t batchBytes = batch.size() * sizeof(T);
+        int index = 0;
+        for (;;){
+            long long offset = static_cast<long long>(index) * static_cast<long long>(sizeof(T));
+            size_t got;
+            {
+                RecordLock lock(file, offset, static_cast<long long>(batchBytes), false);
+                got = file.readAt(offset, &batch[0], batchBytes);
+            }
+            int records = static_cast<int>(got / sizeof(T));
+            if (records == 0) return -1;
+            int stop = visit(static_cast<const T*>(&batch[0]), records, index);
+            if (stop >= 0) return index + stop;
+            index += records;
+        }
+    }
+
+    RecordLock lock(file, 0, toEndOfFile, false);
+    typename MappedRecordFile<T>::View view;
+    if (getRecordStoreMode() == mappedRecordStore && mapped.refresh(view)){
+        //The mapping is already one array: a single block
+        int total = view.size();
+        if (total == 0) return -1;
+        view.adviseSequential(true);
+        int stop = visit(&view[0], total, 0);
+        view.adviseSequential(false);
+        return stop;
+    }
+
+    RecordBatchReader<T> reader(file);
+    vector<T> batch(scanBatchRecords);
+    int index = 0;
+    int got;
+    while ((got = reader.readBatch(&batch[0], scanBatchRecords)) > 0){
+        int stop = visit(static_cast<const T*>(&batch[0]), got, index);
+        if (stop >= 0) return index + stop;
+        index += got;
+    }
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+template <class T, class Visitor>
+int scanRecords(PositionalFile& file,         //input
+                MappedRecordFile<T>& mapped,  //input
+                Visitor visit                 //input
+                ){
+//Job: Calls visit(record, index) for each record in file order until it
+//     returns false.
+//Usage: Shared loop for every linear scan in the FileIO modules.
+//Restrictions: Returns the index visit stopped at, or -1 if it saw every record.
+    return scanRecordBatches(file, mapped, [&](const T* records, int count, int firstIndex){
+        for (int i = 0; i < count; ++i){
+            if (!visit(records[i], firstIndex + i)) return i;
+        }
+        return -1;
+    });
+}
+
+//----------------------------------------------------------------------------
+template <class T, class Partial, class Visitor, class Merger>
+int parallelScanRecords(PositionalFile& file,         //input
+                        MappedRecordFile<T>& mapped,  //input
+                        Partial& result,              //input/output
+                        Visitor visit,                //input
+                        Merger merge                  //input
+                        ){
+//Job: Calls visit(partial, record, index) for every record of the file, with
+//     the chunks spread over a pool of worker threads that each fold into a
+//     default-constructed Partial, then merge(result, partial) for each.
+//Usage: Full-file filters and aggregates (counts, totals, dead records).
+//Restrictions: Chunks are visited in no particular order, so visit and merge
+//              must not rely on it. visit runs on several threads at once and
+//              may only touch its partial. Returns the number of records.
+    bool snapshot = isSnapshotActive();
+    unique_ptr<RecordLock> lock;  //Held for the scan, except through a snapshot
+    if (!snapshot) lock.reset(new RecordLock(file, 0, toEndOfFile, false));
+    typename MappedRecordFile<T>::View view;
+    bool useMapping = !snapshot && getRecordStoreMode() == mappedRecordStore && mapped.refresh(view);
+    int total = useMapping ? view.size()
+                           : static_cast<int>(file.size() / static_cast<long long>(sizeof(T)));
+    int chunks = (total + parallelScanChunkRecords - 1) / parallelScanChunkRecords;
+    int workers = total < parallelScanMinRecords ? 1 : min(getScanThreads(), chunks);
+    if (workers < 1) workers = 1;
+
+    vector<Partial> partials(static_cast<size_t>(workers));
+    atomic<int> nextChunk(0);
+    if (useMapping) view.adviseSequential(true);
+    runScanWorkers(workers, [&](int worker){
+        Partial& partial = partials[static_cast<size_t>(worker)];
+        vector<T> block;
+        int chunk;
+        while ((chunk = nextChunk++) < chunks){
+            int first = chunk * parallelScanChunkRecords;
+            int last = min(total, first + parallelScanChunkRecords);
+            if (useMapping){
+                for (int i = first; i < last; ++i) visit(partial, view[i], i);
+                continue;
+            }
+            if (block.empty()) block.resize(scanBatchRecords);
+            for (int at = first; at < last;){
+                long long offset = static_cast<long long>(at) * static_cast<long long>(sizeof(T));
+                size_t bytes = static_cast<size_t>(min(scanBatchRecords, last - at)) * sizeof(T);
+                size_t got;
+                if (snapshot){
+                    RecordLock blockLock(file, offset, static_cast<long long>(bytes), false);
+                    got = file.readAt(offset, &block[0], bytes);
+                } else{
+                    got = file.readAt(offset, &block[0], bytes);
+                }
+                int records = static_cast<int>(got / sizeof(T));
+                if (records == 0) break;
+                for (int i = 0; i < records; ++i) visit(partial, static_cast<const T&>(block[i]), at + i);
+                at += records;
+            }
+        }
+    });
+    if (useMapping) view.adviseSequential(false);
+
+    for (size_t i = 0; i < partials.size(); ++i) merge(result, partials[i]);
+    return total;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+bool readRecordAt(PositionalFile& file,         //input
+                  MappedRecordFile<T>& mapped,  //input
+                  int index,                    //input
+                  T& result                     //output
+                  ){
+//Job: Loads the record at a zero-based index.
+//Usage: Shared point read for the FileIO modules.
+//Restrictions: Returns false if the index is past the end of the file.
+    if (index < 0) return false;
+    long long offset = static_cast<long long>(index) * static_cast<long long>(sizeof(T));
+    RecordLock lock(file, offset, static_cast<long long>(sizeof(T)), false);
+    typename MappedRecordFile<T>::View view;
+    if (!isSnapshotActive() && getRecordStoreMode() == mappedRecordStore && mapped.refresh(view)){
+        if (index >= view.size()) return false;
+        result = view[index];
+        return true;
+    }
+
+    return file.readAt(offset, &result, sizeof(T)) == sizeof(T);
+}
+
+#endif //RECORD_STORE_H
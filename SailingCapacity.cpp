@@ -0,0 +1,200 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: SailingCapacity.cpp
+// Rev.3 - 18/10/2026 - Dropped the global sailing stream lock: the record lock
+//                      taken by updateSailingCapacities decides, and the
+//                      counters are refreshed from the record under it.
+// Rev.2 - 17/10/2026 - The ledger is keyed on packed SailingKeys.
+// Rev.1 - 17/10/2026 - Implements the atomic per-sailing capacity ledger.
+//
+// ----------------------------------------------------------------------------
+// This module keeps the remaining lane lengths of each sailing in atomic
+// counters and applies every change to the sailing file.
+//
+// Implementation Strategy:
+// - Lengths are counted in whole centimetres (long long), so repeated
+//   reservations and releases add up exactly, unlike the floats in the record.
+// - A reservation is a compare-and-swap loop per lane: read what is left,
+//   give up at once if it is less than the request, otherwise try to store
+//   the difference. Releases are a single fetch_add. Neither takes a lock,
+//   so booking threads only contend when they book the same sailing.
+// - The SailingKey -> counters table is split into capacityLedgerShards
+//   slices with a lock each; a lock is held only to find or add an entry.
+//   The SailingID is packed once per call, so picking the slice and finding
+//   the entry hash and compare a single integer.
+// - Once a reservation has succeeded its delta is applied to the record
+//   with updateSailingCapacities, which holds an exclusive lock on that one
+//   record from its read to its write and refuses to overdraw a lane. The
+//   record is therefore what decides, across threads and processes alike;
+//   the counters only turn away requests early.
+// - While the record is still locked, updateSailingCapacities hands the
+//   new lengths to noteSailingCapacity, which stores them in the counters.
+//   Other processes change the record too, so when the counters refuse a
+//   request or the record refuses one the counters allowed, they are
+//   reloaded from the record and the request is tried once more.
+// - Releases change the counters only through that note, i.e. after the
+//   record update has succeeded.
+//
+// Used By: Called by BookingUserIO.cpp; SailingFileIO.cpp drops entries.
+// ----------------------------------------------------------------------------
+
+#include "SailingCapacity.h"
+#include "SailingFileIO.h"
+#include "SailingKey.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+//Remaining length of one sailing's lanes, in centimetres
+struct SailingLanes{
+    SailingLanes(long long regularLeft, long long specialLeft) : regular(regularLeft), special(specialLeft){}
+    atomic<long long> regular;  //Regular (LHR) lane
+    atomic<long long> special;  //Special (HHR) lane
+};
+typedef shared_ptr<SailingLanes> SailingLanesPtr;
+
+//One slice of the SailingKey -> counters table
+struct LedgerShard{
+    mutex lock;  //Guards lanes (the map), not the counters
+    unordered_map<SailingKey, SailingLanesPtr> lanes;
+};
+
+static LedgerShard ledgerShards[capacityLedgerShards];
+
+//----------------------------------------------------------------------------
+static LedgerShard& shardFor(SailingKey key){
+//Description: Returns the slice of the table that holds a sailing.
+    return ledgerShards[hashSailingKey(key) % capacityLedgerShards];
+}
+
+//----------------------------------------------------------------------------
+static long long toCentimetres(float metres){
+//Description: Converts a length in metres to whole centimetres.
+    return static_cast<long long>(llround(static_cast<double>(metres) * 100.0));
+}
+
+//----------------------------------------------------------------------------
+static SailingLanesPtr lanesFor(fstream& sailingFile, const string& sailingID){
+//Description: Returns the sailing's counters, loading them from its record
+//             on first use. If two threads load the same sailing at once,
+//             both end up with the entry added first.
+    SailingKey key = packSailingKey(sailingID);
+    if (key == noSailingKey) return SailingLanesPtr();
+    LedgerShard& shard = shardFor(key);
+    {
+        lock_guard<mutex> guard(shard.lock);
+        unordered_map<SailingKey, SailingLanesPtr>::const_iterator it = shard.lanes.find(key);
+        if (it != shard.lanes.end()) return it->second;
+    }
+
+    Sailing record;
+    int index = findSailingIndexByID(sailingFile, sailingID);
+    if (index < 0 || !loadSailingByIndex(sailingFile, index, record)) return SailingLanesPtr();
+    SailingLanesPtr loaded(new SailingLanes(max(0LL, toCentimetres(record.getCurrentCapacitySmall())),
+                                            max(0LL, toCentimetres(record.getCurrentCapacityBig()))));
+    lock_guard<mutex> guard(shard.lock);
+    return shard.lanes.insert(make_pair(key, loaded)).first->second;
+}
+
+//----------------------------------------------------------------------------
+static bool takeLength(atomic<long long>& lane, long long wanted){
+//Description: Subtracts wanted from a lane with compare-and-swap, failing
+//             without a change as soon as less than wanted is left.
+    if (wanted <= 0) return true;
+    long long left = lane.load();
+    do{
+        if (left < wanted) return false;
+    } while (!lane.compare_exchange_weak(left, left - wanted));
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool reloadLanes(fstream& sailingFile, const string& sailingID, SailingLanes& lanes){
+//Description: Sets the counters to the lengths in the sailing's record, read
+//             under a shared lock on it. Returns false if it is gone.
+    Sailing record;
+    int index = findSailingIndexByID(sailingFile, sailingID);
+    if (index < 0 || !loadSailingByIndex(sailingFile, index, record)) return false;
+    lanes.regular = max(0LL, toCentimetres(record.getCurrentCapacitySmall()));
+    lanes.special = max(0LL, toCentimetres(record.getCurrentCapacityBig()));
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool reserveSailingCapacity(fstream& sailingFile, const string& sailingID, float regularLength, float specialLength){
+//Description: Takes both lengths from the counters (putting the first back
+//             if the second lane is full), then applies the delta to the
+//             record. If either refuses, the counters are reloaded from the
+//             record, which another process may have changed, and the
+//             reservation is tried once more.
+    SailingLanesPtr lanes = lanesFor(sailingFile, sailingID);
+    if (!lanes) return false;
+
+    long long regular = max(0LL, toCentimetres(regularLength));
+    long long special = max(0LL, toCentimetres(specialLength));
+    for (int attempt = 0; attempt < 2; ++attempt){
+        if (attempt > 0 && !reloadLanes(sailingFile, sailingID, *lanes)) return false;
+        if (!takeLength(lanes->regular, regular)) continue;
+        if (!takeLength(lanes->special, special)){
+            lanes->regular += regular;
+            continue;
+        }
+        if (updateSailingCapacities(sailingFile, sailingID, regularLength, specialLength, 1, 0)) return true;
+        lanes->regular += regular;
+        lanes->special += special;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------
+bool releaseSailingCapacity(fstream& sailingFile, const string& sailingID, float regularLength, float specialLength,
+                            bool wasCheckedIn){
+//Description: Adds both lengths back to the record; the counters are given
+//             the new lengths by updateSailingCapacities once it succeeds.
+    return updateSailingCapacities(sailingFile, sailingID, -regularLength, -specialLength, -1, wasCheckedIn ? -1 : 0);
+}
+
+//----------------------------------------------------------------------------
+bool getReservedCapacity(fstream& sailingFile, const string& sailingID, float& regularLeft, float& specialLeft){
+//Description: Reloads both counters from the record and converts them back
+//             to metres.
+    SailingLanesPtr lanes = lanesFor(sailingFile, sailingID);
+    if (!lanes || !reloadLanes(sailingFile, sailingID, *lanes)) return false;
+    regularLeft = static_cast<float>(lanes->regular.load() / 100.0);
+    specialLeft = static_cast<float>(lanes->special.load() / 100.0);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+void noteSailingCapacity(SailingKey key, float regularLeft, float specialLeft){
+//Description: Stores the lengths in the sailing's counters, if it has any.
+    LedgerShard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+    unordered_map<SailingKey, SailingLanesPtr>::const_iterator it = shard.lanes.find(key);
+    if (it == shard.lanes.end()) return;
+    it->second->regular = max(0LL, toCentimetres(regularLeft));
+    it->second->special = max(0LL, toCentimetres(specialLeft));
+}
+
+//----------------------------------------------------------------------------
+void forgetSailingCapacity(const string& sailingID){
+//Description: Removes the sailing's entry from its slice.
+    SailingKey key = packSailingKey(sailingID);
+    LedgerShard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+    shard.lanes.erase(key);
+}
+
+//----------------------------------------------------------------------------
+void resetSailingCapacities(){
+//Description: Empties every slice.
+    for (int i = 0; i < capacityLedgerShards; ++i){
+        lock_guard<mutex> guard(ledgerShards[i].lock);
+        ledgerShards[i].lanes.clear();
+    }
+}
@@ -0,0 +1,94 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: SailingCapacity.h
+// Rev.2 - 18/10/2026 - The Sailing record decides; the counters follow it
+//                      through noteSailingCapacity.
+// Rev.1 - 17/10/2026 - Interface for atomic per-sailing capacity reservation.
+//
+// ----------------------------------------------------------------------------
+// This header declares the capacity ledger: the remaining deck length of
+// every sailing, split into its regular and special lanes, held in memory
+// as atomic counters.
+//
+// A booking reserves its length before it is written; the reservation
+// first takes the length from the counters in one compare-and-swap, which
+// turns a full sailing away without touching the file, then applies it to
+// the Sailing record through updateSailingCapacities. That update holds an
+// exclusive lock on the record and refuses to overdraw a lane, so two
+// agents, in one process or in several, can never both take the last space.
+//
+// Counters are loaded from the record the first time a sailing is used,
+// set to the record's lengths after every update of it, reloaded when they
+// disagree with it (another process changed it), and dropped when the
+// sailing is deleted or the sailing index is rebuilt.
+// ----------------------------------------------------------------------------
+
+#ifndef SAILING_CAPACITY_H
+#define SAILING_CAPACITY_H
+
+#include "SailingKey.h"
+#include <fstream>
+#include <string>
+using namespace std;
+
+const int capacityLedgerShards = 64;  //Independently locked slices of the sailing table
+
+//----------------------------------------------------------------------------
+bool reserveSailingCapacity(fstream& sailingFile,     //input
+                            const string& sailingID,  //input
+                            float regularLength,      //input
+                            float specialLength       //input
+                            );
+//Job: Takes deck length from the sailing's lanes and counts one more booked
+//     vehicle, in memory and then in the Sailing record.
+//Usage: Called by createBooking before the booking is written.
+//Restrictions: Returns false, changing nothing, if either lane has less
+//              length left than requested or the sailing does not exist.
+
+//----------------------------------------------------------------------------
+bool releaseSailingCapacity(fstream& sailingFile,     //input
+                            const string& sailingID,  //input
+                            float regularLength,      //input
+                            float specialLength,      //input
+                            bool wasCheckedIn         //input
+                            );
+//Job: Gives deck length back to the sailing's lanes and counts one booked
+//     (and, if wasCheckedIn, one checked-in) vehicle less.
+//Usage: Called when a booking is deleted.
+//Restrictions: Returns false, changing nothing, if the sailing does not
+//              exist or its record cannot be updated.
+
+//----------------------------------------------------------------------------
+bool getReservedCapacity(fstream& sailingFile,     //input
+                         const string& sailingID,  //input
+                         float& regularLeft,       //output
+                         float& specialLeft        //output
+                         );
+//Job: Returns the length left in each lane, reloading the counters from
+//     the Sailing record.
+//Usage: Used by reports and tests.
+//Restrictions: Returns false if the sailing does not exist.
+
+//----------------------------------------------------------------------------
+void noteSailingCapacity(SailingKey key,    //input
+                         float regularLeft, //input
+                         float specialLeft  //input
+                         );
+//Job: Sets the sailing's counters to the lengths just written to its record.
+//Usage: Called by updateSailingCapacities while it holds the record lock.
+//Restrictions: No effect if the sailing's counters are not loaded.
+
+//----------------------------------------------------------------------------
+void forgetSailingCapacity(const string& sailingID//input
+                           );
+//Job: Drops the sailing's counters; they are reloaded from the record on next use.
+//Usage: Called by deleteSailingByID.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+void resetSailingCapacities();
+//Job: Drops every sailing's counters.
+//Usage: Called by buildSailingIndex, since the file may have been replaced.
+//Restrictions: Reservations in progress finish against the old counters.
+
+#endif //SAILING_CAPACITY_H
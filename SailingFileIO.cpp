@@ -1,6 +1,37 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: SailingFileIO.cpp
+// Rev.19 - 18/10/2026 - findSailingIndexByID reads and checks the record after
+//                       releasing the index lock.
+// Rev.18 - 18/10/2026 - compactSailingFile takes the index and tombstone count
+//                       from its scan under the whole-file lock.
+// Rev.17 - 18/10/2026 - buildSailingIndex refuses a file without the current
+//                       format header instead of indexing misread records.
+// Rev.16 - 18/10/2026 - sailing.txt starts with a versioned header; files
+//                       without it are refused.
+// Rev.15 - 18/10/2026 - The index has its own lock, so capacity updates on
+//                       different sailings run in parallel; they refresh the
+//                       capacity ledger under the record lock.
+// Rev.14 - 18/10/2026 - Capacity updates and deletes hold one exclusive lock
+//                       on the record from the read to the write.
+// Rev.13 - 18/10/2026 - compactSailingFile rolls back its moves if one fails.
+// Rev.12 - 17/10/2026 - The compaction tombstone scan runs as a parallel chunked scan.
+// Rev.11 - 17/10/2026 - The index is keyed on packed SailingKeys; prefix
+//                       scans are integer key ranges.
+// Rev.10 - 17/10/2026 - Appends, in-place writes and compaction hold exclusive
+//                       byte-range locks for other FerryQ processes.
+// Rev.9 - 17/10/2026 - Reads, writes, sizes and truncation go through a
+//                      PositionalFile (pread/pwrite) instead of the fstream.
+// Rev.8 - 17/10/2026 - updateSailingCapacities refuses to overdraw a lane;
+//                      the capacity ledger is dropped on delete and rebuild.
+// Rev.7 - 17/10/2026 - Added loadAllSailings (one batched pass over the file).
+// Rev.6 - 17/10/2026 - updateSailingCapacities also maintains the vehicle counts.
+// Rev.5 - 17/10/2026 - Deletes mark a tombstone in place; the file is compacted
+//                      once the dead fraction reaches the RecordStore threshold.
+// Rev.4 - 17/10/2026 - Writes and truncates are recorded in the write-ahead log.
+// Rev.3 - 17/10/2026 - Scans and point reads go through the mapped record store.
+// Rev.2 - 17/10/2026 - Added a sorted SailingID index for O(log n) lookups
+//                      and terminal/day prefix range scans.
 // Rev.1 – 24/07/2025 – Implements low-level file I/O for Sailing records.
 //
 // ----------------------------------------------------------------------------
@@ -11,62 +42,218 @@
 //   from the "sailing.txt" binary file.
 //
 // Implementation Strategy:
-// - Data is stored as fixed-length binary records (using sizeof(Sailing)).
-// - All lookups are performed using a linear search of the file.
-// - Deletion is handled with a "swap-and-truncate" method.
+// - Data is stored as fixed-length binary records (using sizeof(Sailing)),
+//   after a RecordFileHeader ("FQSL", sailingFileVersion). The first append
+//   to an empty file writes the header; a file with any other header (or
+//   none, as before version 1) is refused by checkSailingFileFormat.
+// - Reads use the RecordStore module: the file is mapped as a Sailing array
+//   when possible, with positional reads as fallback. Writes, the record
+//   count and truncation use the module's PositionalFile, so the caller's
+//   fstream cursor is never moved.
+// - Lookups go through an ordered in-memory index (SailingKey -> record
+//   index). A SailingID is packed once per call; the index compares and
+//   orders plain integers. Keys sort like the ccc-dd-hh IDs, so all sailings
+//   from one terminal, or one terminal on one day, are a contiguous key range.
+// - The index is built with one scan and kept up to date on append, delete
+//   and compaction. It is rebuilt if the file's record count no longer
+//   matches it. A recursive mutex guards it so threads may call in at once;
+//   it is never held while waiting for a record or tail lock, only for the
+//   shared lock of a rebuild scan, so the index is updated after an append,
+//   delete or compaction releases its file lock.
+// - Every write and truncate is reported to the write-ahead log first.
+// - Appends lock the tail of the file, in-place writes their record and
+//   compaction the whole file, so FerryQ processes sharing the file never
+//   interleave writes.
+// - Deletion sets the record's tombstone flag in place; loadSailingByIndex
+//   and the index skip tombstones. Once the dead fraction reaches the
+//   RecordStore compaction threshold, compactSailingFile fills the holes
+//   from the end of the file and truncates once. Its tombstones are found
+//   with RecordStore's parallelScanRecords, chunks of the file per thread.
 //
 // Used By: Called by the SailingUserIO.cpp and BookingUserIO.cpp modules.
 // ----------------------------------------------------------------------------
 
 #include "SailingFileIO.h"
-#include <cstdio>    //for truncate()
+#include "SailingCapacity.h"
+#include "RecordStore.h"
+#include "WriteAheadLog.h"
+#include <algorithm>
 #include <fstream>
-
-extern "C" int truncate(const char* path, long long length);  //Needed on some systems for file truncation
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 using namespace std;
 
+static const RecordFileHeader sailingFileHeader =
+    makeRecordFileHeader(sailingFileMagic, sailingFileVersion, sizeof(Sailing));  //Start of the file
+static MappedRecordFile<Sailing> sailingRecords(fileNameSailing, recordFileHeaderBytes);  //Mapped view of the file
+static PositionalFile sailingData(fileNameSailing, recordFileHeaderBytes);                //pread/pwrite access to the file
+static map<SailingKey, int> sailingIndex;  //SailingKey -> record index, kept in ID order
+static int indexedSailingCount = -1;    //Record count the index matches (-1 = not built)
+static int deadSailingCount = 0;        //Tombstones among indexedSailingCount records
+static recursive_mutex sailingIndexLock;  //Guards the three above; never held while
+                                          //waiting for a RecordLock other than a scan's
+
+//----------------------------------------------------------------------------
+bool checkSailingFileFormat(){
+//Description: Under an exclusive lock on the header, gives an empty sailing
+//             file its header (logged like a record write) or checks the
+//             one it has.
+    RecordLock lock(sailingData, -recordFileHeaderBytes, recordFileHeaderBytes, true);
+    if (!lock.isHeld()) return false;
+    RecordFileState state = sailingData.checkHeader(sailingFileHeader);
+    if (state != recordFileEmpty) return state == recordFileCurrent;
+    logRecordWrite(fileNameSailing, 0, &sailingFileHeader, sizeof(sailingFileHeader));
+    return sailingData.writeHeader(sailingFileHeader);
+}
+
+//----------------------------------------------------------------------------
+static bool ensureSailingIndex(fstream& inFile){
+//Description: Rebuilds the index if it was never built or if the file's
+//             record count no longer matches it.
+    lock_guard<recursive_mutex> guard(sailingIndexLock);
+    if (indexedSailingCount >= 0 && indexedSailingCount == countSailingRecords(inFile)) return true;
+    return buildSailingIndex(inFile);
+}
+
+//----------------------------------------------------------------------------
+bool buildSailingIndex(fstream& inFile){
+//Description: Rebuilds the SailingID index with one sequential pass,
+//             counting the tombstones it skips. Cached capacity counters
+//             may no longer match the file, so they are dropped too.
+    lock_guard<recursive_mutex> guard(sailingIndexLock);
+    sailingIndex.clear();
+    resetSailingCapacities();
+    indexedSailingCount = -1;
+    deadSailingCount = 0;
+    if (!inFile.is_open() || !checkSailingFileFormat()) return false;
+
+    int count = 0;
+    scanRecords(sailingData, sailingRecords, [&](const Sailing& temp, int index){
+        if (temp.isDeleted()){
+            ++deadSailingCount;
+        } else{
+            sailingIndex[temp.getSailingKey()] = index;
+        }
+        count = index + 1;
+        return true;
+    });
+    indexedSailingCount = count;
+    return true;
+}
+
 //----------------------------------------------------------------------------
 bool appendSailingRecord(fstream& outFile, const Sailing& record){
-//Description: Appends a new Sailing record to the end of an open file.
+//Description: Appends a new Sailing record to the end of an open file
+//             and adds it to the index.
     if (!outFile.is_open()) return false;
+    if (sailingData.size() == 0 && !checkSailingFileFormat()) return false;  //The first record brings the header
+
+    long long end;
+    {
+        RecordLock tail(sailingData, sailingData.size(), toEndOfFile, true);  //Appends take turns at the tail
+        if (!tail.isHeld()) return false;
+        end = sailingData.size();  //Append at the end of file
+        if (end >= 0) logRecordWrite(fileNameSailing, sailingData.fileOffset(end), &record, sizeof(Sailing));
+        if (end >= 0 && !sailingData.writeAt(end, &record, sizeof(Sailing))) end = -1;
+    }
 
-    outFile.clear();
-    outFile.seekp(0, ios::end);  //Go to end of file
-    outFile.write(reinterpret_cast<const char*>(&record), sizeof(Sailing));
-    outFile.flush();
-    return outFile.good();
+    //The index is updated after the tail lock is released
+    lock_guard<recursive_mutex> guard(sailingIndexLock);
+    int position = static_cast<int>(end / static_cast<long long>(sizeof(Sailing)));
+    if (end >= 0 && indexedSailingCount == position){
+        sailingIndex[record.getSailingKey()] = position;
+        ++indexedSailingCount;
+    } else{
+        indexedSailingCount = -1;  //Rebuilt lazily on next lookup
+    }
+    return end >= 0;
 }
 
 //----------------------------------------------------------------------------
 int findSailingIndexByID(fstream& inFile, const string& id){
-//Description: Searches for a Sailing record by ID and returns its index, 
-//             or -1 if not found.
-    if (!inFile.is_open()) return -1;
-
-    inFile.clear();
-    inFile.seekg(0, ios::beg);  //Start from beginning
-
-    Sailing temp;
-    int index = 0;
-    //Read and compare each record
-    while (inFile.read(reinterpret_cast<char*>(&temp), sizeof(Sailing))){
-        if (temp.getSailingID() == id) return index;
-        ++index;
+//Description: Looks up a Sailing record by ID in the index and returns its
+//             record index, or -1 if not found. The record is re-read to
+//             confirm the match so a stale index gets rebuilt, not trusted.
+//             The read waits for the record's shared lock, so it is made
+//             after the index lock is released.
+    SailingKey key = packSailingKey(id);
+    if (!inFile.is_open() || key == noSailingKey) return -1;
+
+    for (int attempt = 0; attempt < 2; ++attempt){
+        int index;
+        {
+            lock_guard<recursive_mutex> guard(sailingIndexLock);
+            if (!ensureSailingIndex(inFile)) return -1;
+            map<SailingKey, int>::const_iterator it = sailingIndex.find(key);
+            if (it == sailingIndex.end()) return -1;  //Not found
+            index = it->second;
+        }
+        Sailing temp;
+        if (loadSailingByIndex(inFile, index, temp) && temp.getSailingKey() == key) return index;
+
+        //Out of step with the file; rebuild (unless another thread has) and retry once
+        lock_guard<recursive_mutex> guard(sailingIndexLock);
+        map<SailingKey, int>::const_iterator it = sailingIndex.find(key);
+        if (it != sailingIndex.end() && it->second == index) indexedSailingCount = -1;
     }
-    return -1;  //Not found
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+vector<int> findSailingIndexesByPrefix(fstream& inFile, const string& prefix){
+//Description: Returns the record indexes of all sailings whose ID starts
+//             with prefix, in SailingID order (e.g. "TSA-12" gives every
+//             sailing from terminal TSA on day 12, earliest hour first).
+//             The prefix becomes a key range; a full ID is a range of one.
+    vector<int> result;
+    SailingKey first, last;
+    if (!getSailingKeyRange(prefix, first, last)){
+        first = last = packSailingKey(prefix);
+        if (first == noSailingKey) return result;
+    }
+    lock_guard<recursive_mutex> guard(sailingIndexLock);
+    if (!inFile.is_open() || !ensureSailingIndex(inFile)) return result;
+
+    for (map<SailingKey, int>::const_iterator it = sailingIndex.lower_bound(first);
+         it != sailingIndex.end() && it->first <= last; ++it){
+        result.push_back(it->second);
+    }
+    return result;
 }
 
 //----------------------------------------------------------------------------
 bool loadSailingByIndex(fstream& inFile, int index, Sailing& result){
 //Description: Loads the Sailing record at a given index (zero-based).
-//             Returns true if read succeeded.
+//             Returns true if read succeeded and the slot is not a tombstone.
+    if (!inFile.is_open()) return false;
+    return readRecordAt(sailingData, sailingRecords, index, result) && !result.isDeleted();
+}
+
+//----------------------------------------------------------------------------
+bool loadAllSailings(fstream& inFile, vector<Sailing>& result){
+//Description: Collects every live record with one scan, skipping tombstones.
+    result.clear();
     if (!inFile.is_open()) return false;
 
-    inFile.clear();
-    inFile.seekg(static_cast<streampos>(index) * sizeof(Sailing), ios::beg);
-    inFile.read(reinterpret_cast<char*>(&result), sizeof(Sailing));
-    return inFile.gcount() == sizeof(Sailing);
+    scanRecords(sailingData, sailingRecords, [&](const Sailing& temp, int){
+        if (!temp.isDeleted()) result.push_back(temp);
+        return true;
+    });
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool writeSailingAt(int index, const Sailing& data){
+//Description: Writes a record at the given index (logged first) without
+//             touching the index.
+    long long offset = static_cast<long long>(index) * static_cast<long long>(sizeof(Sailing));
+    RecordLock lock(sailingData, offset, static_cast<long long>(sizeof(Sailing)), true);
+    if (!lock.isHeld()) return false;
+    logRecordWrite(fileNameSailing, sailingData.fileOffset(offset), &data, sizeof(Sailing));
+    return sailingData.writeAt(offset, &data, sizeof(Sailing));
 }
 
 //----------------------------------------------------------------------------
@@ -75,70 +262,196 @@ bool writeSailingByIndex(fstream& ioFile, int index, const Sailing& data){
 //             Returns true if the write was successful.
     if (!ioFile.is_open()) return false;
 
-    ioFile.clear();
-    ioFile.seekp(static_cast<streampos>(index) * sizeof(Sailing), ios::beg);
-    ioFile.write(reinterpret_cast<const char*>(&data), sizeof(Sailing));
-    ioFile.flush();
-    return ioFile.good();
+    bool written = writeSailingAt(index, data);
+
+    //Index entries are keyed on SailingKey; rebuild if this write changed one
+    lock_guard<recursive_mutex> guard(sailingIndexLock);
+    map<SailingKey, int>::const_iterator it = sailingIndex.find(data.getSailingKey());
+    if (it == sailingIndex.end() || it->second != index) indexedSailingCount = -1;
+    return written;
 }
 
 //----------------------------------------------------------------------------
 int countSailingRecords(fstream& inFile){
-//Description: Returns the number of Sailing records in the file.
-//             Assumes file is binary and uses fixed-length records.
+//Description: Returns the number of Sailing record slots in the file,
+//             tombstones included. Assumes fixed-length binary records.
     if (!inFile.is_open()) return 0;
 
-    inFile.clear();
-    inFile.seekg(0, ios::end);
-    streampos size = inFile.tellg();
-    return static_cast<int>(size / sizeof(Sailing));
+    long long bytes = sailingData.size();
+    return bytes < 0 ? 0 : static_cast<int>(bytes / static_cast<long long>(sizeof(Sailing)));
 }
 
 //----------------------------------------------------------------------------
-bool deleteSailingByID(fstream& ioFile, const string& sailingID){
-//Description: Deletes a Sailing record by its ID by swapping with the last record
-//             and truncating the file by one record size. Reopens the file
-//             after truncation to restore original state.
-    int target = findSailingIndexByID(ioFile, sailingID);
-    if (target < 0) return false;
+struct SailingSlots{
+    vector<int> dead;                        //Tombstone indexes
+    vector<pair<SailingKey, int> > live;     //Live keys and their indexes
+};
+
+//----------------------------------------------------------------------------
+static int moveLiveSailings(fstream& ioFile, map<SailingKey, int>& index){
+//Description: Under an exclusive lock on the whole file, finds the live
+//             records and tombstones, fills each tombstone below the new
+//             end of file with a live record from the tail and truncates
+//             once, as one transaction. Returns the new record count with
+//             index holding every live key at its final position, both
+//             taken from the file under the lock, or -1 after rolling back.
+    RecordLock lock(sailingData, 0, toEndOfFile, true);  //Covers the scan, the moves and the truncate
+    if (!lock.isHeld()) return -1;
 
-    int total = countSailingRecords(ioFile);
-    int lastIndex = total - 1;
+    SailingSlots slots;
+    int total = parallelScanRecords(sailingData, sailingRecords, slots,
+        [](SailingSlots& partial, const Sailing& temp, int at){
+            if (temp.isDeleted()){
+                partial.dead.push_back(at);
+            } else{
+                partial.live.push_back(make_pair(temp.getSailingKey(), at));
+            }
+        },
+        [](SailingSlots& all, const SailingSlots& partial){
+            all.dead.insert(all.dead.end(), partial.dead.begin(), partial.dead.end());
+            all.live.insert(all.live.end(), partial.live.begin(), partial.live.end());
+        });
+    sort(slots.dead.begin(), slots.dead.end());  //Workers finish their chunks in any order
+    const vector<int>& dead = slots.dead;
+    index.clear();
+    index.insert(slots.live.begin(), slots.live.end());
+    if (dead.empty()) return total;
+    int newTotal = total - static_cast<int>(dead.size());
+    beginWalTransaction();
 
-    //If not last record, overwrite target with the last
-    if (target != lastIndex){
-        Sailing lastRec;
-        if (!loadSailingByIndex(ioFile, lastIndex, lastRec)) return false;
+    //Fill holes below newTotal with live records taken from the end
+    size_t hole = 0;
+    size_t tailDead = dead.size();  //Tombstones at or after source are skipped
+    int source = total - 1;
+    while (hole < dead.size() && dead[hole] < newTotal){
+        while (tailDead > 0 && dead[tailDead - 1] == source){
+            --tailDead;
+            --source;
+        }
+        Sailing moved;
+        if (!loadSailingByIndex(ioFile, source, moved) || !writeSailingAt(dead[hole], moved)){
+            abortWalTransaction();  //Puts back the records moved so far
+            return -1;
+        }
+        index[moved.getSailingKey()] = dead[hole];
+        --source;
+        ++hole;
+    }
 
-        ioFile.clear();
-        ioFile.seekp(static_cast<streampos>(target) * sizeof(Sailing), ios::beg);
-        ioFile.write(reinterpret_cast<const char*>(&lastRec), sizeof(Sailing));
-        ioFile.flush();
+    //Truncate the file to drop the tail
+    long long newSize = static_cast<long long>(newTotal) * static_cast<long long>(sizeof(Sailing));
+    logFileTruncate(fileNameSailing, sailingData.fileOffset(newSize));
+    if (!sailingData.resize(newSize)){
+        abortWalTransaction();
+        return -1;
     }
+    commitWalTransaction();
+    return newTotal;
+}
 
-    //Truncate the file to remove the last record
-    ioFile.close();
-    long newSize = static_cast<long>(lastIndex) * static_cast<long>(sizeof(Sailing));
-    if (truncate(fileNameSailing.c_str(), newSize) != 0){
+//----------------------------------------------------------------------------
+bool compactSailingFile(fstream& ioFile){
+//Description: Reclaims the space held by tombstones. Each tombstone below
+//             the new end of file is filled with a live record from the
+//             tail, then the file is truncated once. If a step fails, the
+//             moves are rolled back and the file is left as it was. The
+//             tombstones are counted and the index rebuilt from the scan
+//             made under the file lock; the index is replaced once the
+//             lock is released.
+    if (!ioFile.is_open()) return false;
+    map<SailingKey, int> index;
+    int newTotal = moveLiveSailings(ioFile, index);
+
+    lock_guard<recursive_mutex> guard(sailingIndexLock);
+    if (newTotal < 0){
+        indexedSailingCount = -1;
         return false;
     }
+    sailingIndex.swap(index);
+    indexedSailingCount = newTotal;
+    deadSailingCount = 0;
+    return true;
+}
 
-    //Reopen file for further operations
-    ioFile.open(fileNameSailing, ios::in | ios::out | ios::binary);
-    return ioFile.is_open();
+//----------------------------------------------------------------------------
+static int lockSailingRecord(fstream& ioFile, const string& sailingID, unique_ptr<RecordLock>& lock,
+                             Sailing& record){
+//Description: Finds the sailing and takes an exclusive lock on its record,
+//             then re-reads it under the lock, so another process cannot
+//             change or move it between this read and the caller's write.
+//             Returns the record index, or -1 if not found or not locked.
+    SailingKey key = packSailingKey(sailingID);
+    for (int attempt = 0; attempt < 2; ++attempt){
+        int index = findSailingIndexByID(ioFile, sailingID);
+        if (index < 0) return -1;
+        long long offset = static_cast<long long>(index) * static_cast<long long>(sizeof(Sailing));
+        lock.reset(new RecordLock(sailingData, offset, static_cast<long long>(sizeof(Sailing)), true));
+        if (!lock->isHeld()) return -1;
+        if (loadSailingByIndex(ioFile, index, record) && record.getSailingKey() == key) return index;
+        lock.reset();
+        lock_guard<recursive_mutex> guard(sailingIndexLock);
+        indexedSailingCount = -1;  //Moved by another process meanwhile; look it up again
+    }
+    return -1;
 }
 
 //----------------------------------------------------------------------------
-bool updateSailingCapacities(fstream& sailingFile, const string& sailingID, float regularLengthUsed, float specialLengthUsed) {
-//Description: Updates the capacities of a sailing.
-    int index = findSailingIndexByID(sailingFile, sailingID);
-    if (index < 0) return false;
+bool deleteSailingByID(fstream& ioFile, const string& sailingID){
+//Description: Deletes a Sailing record by its ID by marking it as a
+//             tombstone in place, under one lock from read to write. The
+//             file is compacted if that pushes the dead fraction over the
+//             threshold.
+    unique_ptr<RecordLock> lock;
+    Sailing record;
+    int target = lockSailingRecord(ioFile, sailingID, lock, record);
+    if (target < 0) return false;
 
+    record.setDeleted(true);
+    bool written = writeSailingAt(target, record);
+    lock.reset();
+    bool compact = false;
+    {
+        lock_guard<recursive_mutex> guard(sailingIndexLock);
+        if (!written){
+            indexedSailingCount = -1;
+            return false;
+        }
+        sailingIndex.erase(record.getSailingKey());
+        ++deadSailingCount;
+        compact = isCompactionDue(deadSailingCount, indexedSailingCount);
+    }
+    forgetSailingCapacity(sailingID);
+    if (compact) compactSailingFile(ioFile);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool updateSailingCapacities(fstream& sailingFile, const string& sailingID, float regularLengthUsed, float specialLengthUsed,
+                             int bookedChange, int checkedInChange) {
+//Description: Updates the capacities and vehicle counts of a sailing with
+//             one read and one write of its record, holding an exclusive
+//             lock on it throughout so concurrent processes cannot lose an
+//             update. Nothing is written if a lane would go below zero
+//             (allowing for float rounding). The capacity ledger is given
+//             the new lengths while the record is still locked.
+    const float tolerance = 0.005f;  //Half a centimetre
+    unique_ptr<RecordLock> lock;
     Sailing s;
-    if (!loadSailingByIndex(sailingFile, index, s)) return false;
+    int index = lockSailingRecord(sailingFile, sailingID, lock, s);
+    if (index < 0) return false;
 
-    s.setCurrentCapacitySmall(s.getCurrentCapacitySmall() - regularLengthUsed);
-    s.setCurrentCapacityBig(s.getCurrentCapacityBig() - specialLengthUsed);
+    float regularLeft = s.getCurrentCapacitySmall() - regularLengthUsed;
+    float specialLeft = s.getCurrentCapacityBig() - specialLengthUsed;
+    if ((regularLengthUsed > 0 && regularLeft < -tolerance) || (specialLengthUsed > 0 && specialLeft < -tolerance)){
+        return false;
+    }
+    s.setCurrentCapacitySmall(max(0.0f, regularLeft));
+    s.setCurrentCapacityBig(max(0.0f, specialLeft));
+    s.setBookedVehicles(max(0, s.getBookedVehicles() + bookedChange));
+    s.setCheckedInVehicles(max(0, s.getCheckedInVehicles() + checkedInChange));
 
-    return writeSailingByIndex(sailingFile, index, s);
-}
\ No newline at end of file
+    //The key is unchanged, so the index needs no update
+    if (!writeSailingAt(index, s)) return false;
+    noteSailingCapacity(s.getSailingKey(), s.getCurrentCapacitySmall(), s.getCurrentCapacityBig());
+    return true;
+}
@@ -1,6 +1,17 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: SailingFileIO.h - Low-level file I/O for Sailings
+// Rev.11 - 18/10/2026 - buildSailingIndex refuses files of an older layout.
+// Rev.10 - 18/10/2026 - Added the sailing.txt format header and
+//                       checkSailingFileFormat.
+// Rev.9 - 18/10/2026 - Capacity updates and deletes are atomic across processes.
+// Rev.8 - 18/10/2026 - A failed compaction leaves the file unchanged.
+// Rev.7 - 17/10/2026 - Prefix scans take ccc, ccc-dd or a full SailingID.
+// Rev.6 - 17/10/2026 - updateSailingCapacities refuses to overdraw a lane.
+// Rev.5 - 17/10/2026 - Added loadAllSailings for the report engine.
+// Rev.4 - 17/10/2026 - updateSailingCapacities also maintains the vehicle counts.
+// Rev.3 - 17/10/2026 - Deletes leave tombstones; added compactSailingFile.
+// Rev.2 - 17/10/2026 - Added the sorted SailingID index and prefix range scans
 // Rev.1 - 24/07/2025 - Created for modular design separation
 //
 // ----------------------------------------------------------------------------
@@ -18,15 +29,47 @@
 #include "SailingUserIO.h"
 #include <fstream>
 #include <string>
+#include <vector>
 using namespace std;
 
 //Fixed record size (sailingID = 12, vesselName = 25, 2 floats)
 const int RECORD_SIZE = 12 + 25 + sizeof(float) * 2;
 
+const char sailingFileMagic[] = "FQSL";     //First bytes of sailing.txt
+const unsigned int sailingFileVersion = 1;  //Layout of its records: the 56-byte Sailing
+                                            //(files before version 1 have no header)
+
+//----------------------------------------------------------------------------
+bool checkSailingFileFormat();
+//Job: Writes the format header into an empty sailing.txt, or checks that
+//     the file has the header of this version.
+//Usage: Called by main before the file is used; the first append also
+//       calls it.
+//Restrictions: Returns false for a file written by an older FerryQ (or
+//              not a sailing file), which must not be read or written.
+
+//----------------------------------------------------------------------------
+bool buildSailingIndex(fstream& inFile);
+//Job: Builds the sorted SailingID -> record index map from the sailing file.
+//Usage: Called once at startup. Lookups rebuild it automatically if the file
+//       was changed without going through this module.
+//Restrictions: File must be open in binary read mode. Returns false,
+//              indexing nothing, for a file of an older record layout.
+
 //----------------------------------------------------------------------------
 int findSailingIndexByID(fstream& inFile, const string& id);
-//Job: Scans the sailing file for a record matching the given SailingID.
+//Job: Finds the record index of the sailing with the given SailingID.
 //Usage: Used by delete/query/update operations to locate target.
+//Restrictions: O(log n) through the sorted index. Returns -1 if not found.
+
+//----------------------------------------------------------------------------
+vector<int> findSailingIndexesByPrefix(fstream& inFile, const string& prefix);
+//Job: Returns record indexes of every sailing whose ID starts with prefix,
+//     in SailingID order.
+//Usage: Range scans such as all sailings from terminal "TSA", or from
+//       terminal TSA on day 12 ("TSA-12").
+//Restrictions: File must be open. prefix must be ccc, ccc-dd or a full
+//              ccc-dd-hh ID. Returns an empty list if nothing matches.
 
 //----------------------------------------------------------------------------
 bool appendSailingRecord(fstream& outFile, const Sailing& record);
@@ -38,7 +81,8 @@ bool appendSailingRecord(fstream& outFile, const Sailing& record);
 bool loadSailingByIndex(fstream& inFile, int index, Sailing& result);
 //Job: Loads a Sailing record from a specific index.
 //Usage: Used for displaying or modifying an existing record.
-//Restrictions: File must be open and index must be valid.
+//Restrictions: File must be open and index must be valid. Returns false
+//              for a deleted (tombstoned) slot.
 
 //----------------------------------------------------------------------------
 bool writeSailingByIndex(fstream& ioFile, int index, const Sailing& data);
@@ -46,22 +90,46 @@ bool writeSailingByIndex(fstream& ioFile, int index, const Sailing& data);
 //Usage: Used to update sailing capacity or vessel assignment.
 //Restrictions: File must be open and index must be valid.
 
+//----------------------------------------------------------------------------
+bool loadAllSailings(fstream& inFile, vector<Sailing>& result);
+//Job: Loads every live Sailing record, in file order, with one sequential pass.
+//Usage: Used by the sailings report engine.
+//Restrictions: File must be open. result is cleared first.
+
 //----------------------------------------------------------------------------
 int countSailingRecords(fstream& inFile);
-//Job: Counts the number of valid Sailing records in the file.
-//Usage: Used for pagination, validation, and iteration.
+//Job: Counts the number of Sailing record slots in the file, including
+//     deleted slots not yet compacted away.
+//Usage: Used as the bound when iterating with loadSailingByIndex.
 //Restrictions: File must be open in binary read mode.
 
 //----------------------------------------------------------------------------
 bool deleteSailingByID(fstream& ioFile, const string& sailingID);
-//Job: Deletes a Sailing by replacing it with the last record and truncating.
+//Job: Deletes a Sailing by marking it as a tombstone in place.
 //Usage: Called by the interactive deleteSailing() workflow.
 //Restrictions: File must be opened in binary read/write mode.
 
 //----------------------------------------------------------------------------
-bool updateSailingCapacities(fstream& sailingFile, const string& sailingID, float regularLengthUsed, float specialLengthUsed);
-//Job: Updates the capacities of a sailing.
-//Usage: Called when a booking is created or deleted.
-//Restrictions: File must be open.
+bool compactSailingFile(fstream& ioFile);
+//Job: Removes all tombstones by moving live records from the end of the
+//     file into their slots and truncating once.
+//Usage: Called automatically when the dead fraction reaches the RecordStore
+//       compaction threshold; may also be called directly.
+//Restrictions: File must be opened in binary read/write mode. The stream
+//              is reopened; record positions change. On failure the file
+//              is left as it was.
+
+//----------------------------------------------------------------------------
+bool updateSailingCapacities(fstream& sailingFile, const string& sailingID, float regularLengthUsed, float specialLengthUsed,
+                             int bookedChange, int checkedInChange);
+//Job: Updates the remaining capacities and the booked/checked-in vehicle
+//     counts of a sailing in one record write.
+//Usage: Called through SailingCapacity when a booking is created (+1
+//       booked) or deleted (-1 booked, -1 checked in if it was), and
+//       directly on check-in (+1 checked in).
+//Restrictions: File must be open. Counts never go below zero. Returns false,
+//              writing nothing, if a positive length exceeds what is left.
+//              The record stays locked from the read to the write, so
+//              updates from several processes are never lost.
 
 #endif //SAILING_IO_H
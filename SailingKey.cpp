@@ -0,0 +1,102 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: SailingKey.cpp
+// Rev.1 - 17/10/2026 - Implements packing and unpacking of sailing IDs.
+//
+// ----------------------------------------------------------------------------
+// This module converts sailing IDs to and from SailingKey.
+//
+// Implementation Strategy:
+// - The ID is checked character by character while it is packed, so no
+//   regex runs on the hot path; a malformed ID packs to noSailingKey.
+// - Letters take codes 1..52 in ASCII order (upper case first), so the key
+//   order is the string order and 0 is never a valid key.
+// - A prefix range fills the missing day and hour fields with their lowest
+//   and highest values.
+//
+// Used By: Booking and Sailing records, the FileIO modules, SailingCapacity
+//          and FerryServer.
+// ----------------------------------------------------------------------------
+
+#include "SailingKey.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+static unsigned int letterCode(char c){
+//Description: Returns 1..52 for A-Z and a-z, 0 for anything else.
+    if (c >= 'A' && c <= 'Z') return static_cast<unsigned int>(c - 'A') + 1;
+    if (c >= 'a' && c <= 'z') return static_cast<unsigned int>(c - 'a') + 27;
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+static char codeLetter(unsigned int code){
+//Description: Inverse of letterCode.
+    return code <= 26 ? static_cast<char>('A' + code - 1) : static_cast<char>('a' + code - 27);
+}
+
+//----------------------------------------------------------------------------
+static bool parseTwoDigits(const string& text, size_t at, unsigned int& value){
+//Description: Reads the two decimal digits at text[at].
+    if (text[at] < '0' || text[at] > '9' || text[at + 1] < '0' || text[at + 1] > '9') return false;
+    value = static_cast<unsigned int>(text[at] - '0') * 10 + static_cast<unsigned int>(text[at + 1] - '0');
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool packTerminal(const string& text, SailingKey& key){
+//Description: Packs the three letters at the start of text into bits 31..14.
+    key = 0;
+    for (size_t i = 0; i < 3; ++i){
+        unsigned int code = letterCode(text[i]);
+        if (code == 0) return false;
+        key = (key << 6) | code;
+    }
+    key <<= 14;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+SailingKey packSailingKey(const string& sailingID){
+//Description: Validates and packs ccc-dd-hh in one pass.
+    SailingKey key;
+    unsigned int day, hour;
+    if (sailingID.size() != 9 || sailingID[3] != '-' || sailingID[6] != '-' ||
+        !packTerminal(sailingID, key) || !parseTwoDigits(sailingID, 4, day) || !parseTwoDigits(sailingID, 7, hour)){
+        return noSailingKey;
+    }
+    return key | (day << 7) | hour;
+}
+
+//----------------------------------------------------------------------------
+string unpackSailingKey(SailingKey key){
+//Description: Rebuilds the letters and the zero-padded day and hour.
+    if (key == noSailingKey) return string();
+    unsigned int day = (key >> 7) & 0x7f;
+    unsigned int hour = key & 0x7f;
+    char text[10] = {
+        codeLetter((key >> 26) & 0x3f), codeLetter((key >> 20) & 0x3f), codeLetter((key >> 14) & 0x3f), '-',
+        static_cast<char>('0' + day / 10), static_cast<char>('0' + day % 10), '-',
+        static_cast<char>('0' + hour / 10), static_cast<char>('0' + hour % 10), '\0'
+    };
+    return string(text);
+}
+
+//----------------------------------------------------------------------------
+bool getSailingKeyRange(const string& prefix, SailingKey& first, SailingKey& last){
+//Description: ccc spans every day and hour; ccc-dd spans every hour.
+    SailingKey terminal;
+    unsigned int day;
+    if (prefix.size() == 3 && packTerminal(prefix, terminal)){
+        first = terminal;
+        last = terminal | (99u << 7) | 99u;
+        return true;
+    }
+    if (prefix.size() == 6 && prefix[3] == '-' && packTerminal(prefix, terminal) && parseTwoDigits(prefix, 4, day)){
+        first = terminal | (day << 7);
+        last = first | 99u;
+        return true;
+    }
+    return false;
+}
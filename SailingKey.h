@@ -0,0 +1,71 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: SailingKey.h
+// Rev.1 - 17/10/2026 - Packed 32-bit encoding of sailing IDs.
+//
+// ----------------------------------------------------------------------------
+// This header declares SailingKey, a sailing ID packed into one unsigned
+// 32-bit integer. A valid ID has the form ccc-dd-hh: three letters, a two-digit
+// day and a two-digit hour, which fit in
+//
+//     bits 31..26  first letter   (A-Z = 1..26, a-z = 27..52)
+//     bits 25..20  second letter
+//     bits 19..14  third letter
+//     bits 13..7   day            (00..99)
+//     bits  6..0   hour           (00..99)
+//
+// Keys compare in the same order as the ID strings, so sorted indexes and
+// terminal or terminal-and-day prefix ranges work on the integers directly.
+// A valid ID never packs to 0, which is kept as noSailingKey: the value of
+// an empty (all-zero) record.
+//
+// Booking and Sailing records store the key in place of the ID text, and
+// the indexes, ledgers and lock tables key on it, so comparing, hashing and
+// sorting sailings are single integer operations. The text form is only
+// built for display and at the user interface.
+// ----------------------------------------------------------------------------
+
+#ifndef SAILING_KEY_H
+#define SAILING_KEY_H
+
+#include <string>
+using namespace std;
+
+typedef unsigned int SailingKey;       //Packed ccc-dd-hh sailing ID
+const SailingKey noSailingKey = 0;     //Empty record or ID that does not parse
+
+//----------------------------------------------------------------------------
+SailingKey packSailingKey(const string& sailingID//input
+                          );
+//Job: Packs a ccc-dd-hh sailing ID into its key.
+//Usage: Called once where an ID enters from the user or the protocol.
+//Restrictions: Returns noSailingKey if the ID does not have that format.
+
+//----------------------------------------------------------------------------
+string unpackSailingKey(SailingKey key//input
+                        );
+//Job: Rebuilds the ccc-dd-hh text of a key.
+//Usage: Display, reports and the ferryqd protocol.
+//Restrictions: Returns an empty string for noSailingKey.
+
+//----------------------------------------------------------------------------
+bool getSailingKeyRange(const string& prefix, //input
+                        SailingKey& first,    //output
+                        SailingKey& last      //output
+                        );
+//Job: Returns the inclusive key range of every sailing from a terminal
+//     (ccc) or a terminal on one day (ccc-dd).
+//Usage: Prefix queries on the sorted sailing index.
+//Restrictions: Returns false if prefix has neither form.
+
+//----------------------------------------------------------------------------
+inline size_t hashSailingKey(SailingKey key//input
+                             ){
+//Job: Spreads the bits of a key for picking a shard.
+//Usage: Lock and ledger shard selection (key % shards alone would only
+//       look at the hour).
+//Restrictions: None.
+    return static_cast<size_t>((key * 2654435761u) >> 7);
+}
+
+#endif //SAILING_KEY_H
@@ -0,0 +1,76 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: SailingReport.cpp
+// Rev.3 - 17/10/2026 - Booking totals are joined on the packed SailingKey.
+// Rev.2 - 17/10/2026 - The report reads one StoreSnapshot of the files and
+//                      loads its own vessel catalog.
+// Rev.1 - 17/10/2026 - Implements the single-pass sailings report engine.
+//
+// ----------------------------------------------------------------------------
+// This module builds the rows of the Sailings Report.
+//
+// What it does:
+// - Aggregates the booking file into a SailingKey -> (vehicles, checked in)
+//   hash table with one sequential pass; the join probes it with integers.
+// - Loads a VesselCatalog (one pass over the vessel file) for capacities of
+//   sailings that predate the initial capacities stored in the Sailing
+//   record. It is a private copy, not the shared catalog, which writers on
+//   other threads may be updating.
+// - Reads the sailing file once and joins each sailing with both tables.
+// - All three passes run inside one StoreSnapshot, so the totals, sailings
+//   and capacities agree with each other even while bookings are written.
+//
+// The cost is O(S + B + V) for S sailings, B bookings and V vessels,
+// against O(S x (B + V)) when every row rescans the other files.
+//
+// Used By: Called by printReport in SailingUserIO.cpp.
+// ----------------------------------------------------------------------------
+
+#include "SailingReport.h"
+#include "SailingFileIO.h"
+#include "BookingFileIO.h"
+#include "VesselFileIO.h"
+#include "RecordStore.h"
+#include <unordered_map>
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+bool buildSailingReport(fstream& sailingFile, fstream& bookingFile, fstream& vesselFile,
+                        vector<SailingReportRow>& rows){
+//Description: Runs the booking pass, then the sailing pass, probing the
+//             booking totals and the vessel catalog for every sailing.
+    rows.clear();
+    StoreSnapshot snapshot;
+    unordered_map<SailingKey, SailingBookingTotals> totals;
+    if (!aggregateBookingsBySailing(bookingFile, totals)) return false;
+
+    vector<Sailing> sailings;
+    if (!loadAllSailings(sailingFile, sailings)) return false;
+    VesselCatalog catalog;
+    if (!catalog.load(vesselFile)) return false;
+
+    rows.resize(sailings.size());
+    for (size_t i = 0; i < sailings.size(); ++i){
+        SailingReportRow& row = rows[i];
+        row.sailing = sailings[i];
+
+        unordered_map<SailingKey, SailingBookingTotals>::const_iterator it = totals.find(row.sailing.getSailingKey());
+        if (it != totals.end()){
+            row.vehicles = it->second.vehicles;
+            row.checkedIn = it->second.checkedIn;
+        }
+
+        float initialSmall = row.sailing.getInitialCapacitySmall();
+        float initialBig = row.sailing.getInitialCapacityBig();
+        if (initialSmall + initialBig <= 0){
+            catalog.find(row.sailing.getVesselName(), initialSmall, initialBig);
+        }
+        float totalInitial = initialSmall + initialBig;
+        float totalRemaining = row.sailing.getCurrentCapacitySmall() + row.sailing.getCurrentCapacityBig();
+        if (totalInitial > 0){
+            row.deckUsage = ((totalInitial - totalRemaining) / totalInitial) * 100;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,46 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: SailingReport.h
+// Rev.2 - 17/10/2026 - The report reads through a StoreSnapshot.
+// Rev.1 - 17/10/2026 - Interface for the single-pass sailings report engine.
+//
+// ----------------------------------------------------------------------------
+// This header declares the engine behind the Sailings Report. The engine
+// reads each data file once: one pass over the bookings builds per-sailing
+// totals in a hash table, the vessel catalog supplies capacities, and one
+// pass over the sailings joins both and produces every row of the report.
+//
+// Called by the SailingUserIO module, which only formats and paginates.
+// ----------------------------------------------------------------------------
+
+#ifndef SAILING_REPORT_H
+#define SAILING_REPORT_H
+
+#include "SailingUserIO.h"
+#include <fstream>
+#include <vector>
+using namespace std;
+
+//One row of the sailings report
+struct SailingReportRow{
+    SailingReportRow() : vehicles(0), checkedIn(0), deckUsage(0.0f){}
+    Sailing sailing;    //The sailing record (ID, vessel, remaining capacities)
+    int vehicles;       //Bookings on the sailing, from the booking pass
+    int checkedIn;      //Of those, how many have checked in
+    float deckUsage;    //Percentage of the initial deck length in use
+};
+
+//----------------------------------------------------------------------------
+bool buildSailingReport(fstream& sailingFile, //input
+                        fstream& bookingFile, //input
+                        fstream& vesselFile,  //input
+                        vector<SailingReportRow>& rows//output
+                        );
+//Job: Produces every report row with one pass over the bookings, one over
+//     the vessels and one over the sailings, joined through hash tables.
+//Usage: Called by printReport before it starts printing.
+//Restrictions: All three files must be open. Rows are in sailing file order.
+//              Reads through a StoreSnapshot, so writers on other threads
+//              may run meanwhile, except with the LSM booking engine.
+
+#endif //SAILING_REPORT_H
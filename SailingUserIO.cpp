@@ -1,6 +1,25 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: SailingUserIO.cpp
+// Rev.12 - 17/10/2026 - Added Sailing::hasSailingID and hasVesselName; report
+//                       rows print the vessel name without copying it.
+// Rev.11 - 17/10/2026 - Sailing IDs are stored as packed SailingKeys;
+//                       isValidSailingID checks the format by packing.
+// Rev.10 - 17/10/2026 - printSailingRow is exported and printReport's paging
+//                       moved to pageSailingReport, both shared with the
+//                       ferryqd client.
+// Rev.9 - 17/10/2026 - printReport prints rows built by the SailingReport engine
+//                      (one pass over each data file, hash join).
+// Rev.8 - 17/10/2026 - Vehicle count and deck usage come from the counters in
+//                      the Sailing record, so report and query rows cost O(1).
+// Rev.7 - 17/10/2026 - Added the Sailing tombstone flag accessors; printReport
+//                      numbers rows itself since deleted slots are skipped.
+// Rev.6 - 17/10/2026 - deleteSailing removes the sailing and its bookings in
+//                      one write-ahead log transaction and reports the count.
+// Rev.5 - 17/10/2026 - createSailing and printReport read both vessel
+//                      capacities from one VesselCatalog lookup.
+// Rev.4 - 17/10/2026 - querySailing accepts a terminal (ccc) or terminal and
+//                      day (ccc-dd) and lists matching sailings in ID order.
 // Rev.3 - 05/08/2025 - Updated user input logic to correctly check for blank inputs
 //                    - Functions now clear the terminal before outputting their result.
 //                    - Fixed Sailing Report, now correctly formatted according to User Manual
@@ -27,6 +46,8 @@
 #include "BookingFileIO.h"
 #include "VehicleFileIO.h"
 #include "UserInterface.h"
+#include "WriteAheadLog.h"
+#include "SailingReport.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -79,11 +100,7 @@ void createSailing(fstream& vesselFile, fstream& sailingFile){
             }
 
             //Check that vessel exists and retrieve capacities
-            vesselFile.clear(); vesselFile.seekg(0, ios::beg);
-            capSmall = getMaxRegularLength(vesselName, vesselFile);
-            vesselFile.clear(); vesselFile.seekg(0, ios::beg);
-            capBig = getMaxSpecialLength(vesselName, vesselFile);
-            if (capSmall < 0 || capBig < 0){
+            if (!getVesselCatalog(vesselFile).find(vesselName, capSmall, capBig)){
                 cout << "Error: Vessel not found. Please re-enter.\n" << endl;
                 continue;
             }
@@ -149,6 +166,7 @@ void createSailing(fstream& vesselFile, fstream& sailingFile){
             s.setVesselName(vesselName);
             s.setCurrentCapacitySmall(capSmall);
             s.setCurrentCapacityBig(capBig);
+            s.setInitialCapacities(capSmall, capBig);
             if (appendSailingRecord(sailingFile, s)){
                 cout << "Sailing successfully created. The SailingID is " << sailingID << ". Would you like to create another sailing? (Y/N) ";
             } else{
@@ -181,11 +199,14 @@ bool deleteSailing(fstream& sailingFile, fstream& bookingFile){
         cout << "Bad Entry! SailingID must have format ccc-dd-hh. Try again" << endl;
         return false;
     }
+    beginWalTransaction();
     bool ok = deleteSailingByID(sailingFile, sailingID);
+    int bookingsRemoved = ok ? deleteBookingsBySailingID(bookingFile, sailingID) : 0;
+    commitWalTransaction();
     system("cls");
     if (ok){
-        deleteBookingsBySailingID(bookingFile, sailingID);
-        cout << "Sailing with SailingID " << sailingID << " deleted successfully." << endl;
+        cout << "Sailing with SailingID " << sailingID << " deleted successfully. "
+             << bookingsRemoved << " booking(s) removed." << endl;
     }else{
         system("cls");
         cout << "No sailing with SailingID " << sailingID << " was found." << endl;
@@ -195,9 +216,9 @@ bool deleteSailing(fstream& sailingFile, fstream& bookingFile){
 
 //----------------------------------------------------------------------------
 bool isValidSailingID(const string& id){
-//Description: Checks if a string matches the expected "ccc-dd-dd" sailing format.
-    regex pattern("^[A-Za-z]{3}-\\d{2}-\\d{2}$");
-    return regex_match(id, pattern);
+//Description: Checks if a string matches the expected "ccc-dd-dd" sailing
+//             format, i.e. whether it packs into a SailingKey.
+    return packSailingKey(id) != noSailingKey;
 }
 
 //----------------------------------------------------------------------------
@@ -220,49 +241,42 @@ void printSailingReportHeader(){
          << string(13, '-') << "\n";
 }
 
+//----------------------------------------------------------------------------
+void printSailingRow(int row, const Sailing& s, int vehicles, float deckUsage){
+//Description: Prints one sailing under printSailingReportHeader.
+    cout << right << setw(4) << row << ") "
+         << left << setw(12) << s.getSailingID() << " "
+         << setw(24) << s.getVesselNameChars() << " "
+         << setw(6)  << fixed << setprecision(1) << s.getCurrentCapacitySmall() << " "
+         << setw(6)  << s.getCurrentCapacityBig() << " "
+         << setw(14) << vehicles << " "
+         << setw(6) << fixed << setprecision(2) << deckUsage << "%" << endl;
+}
+
 //----------------------------------------------------------------------------
 void printReport(fstream& sailingFile, fstream& bookingFile, fstream& vehicleFile, fstream& vesselFile){
-//Description: Displays all sailings from file, 5 per screen.
+//Description: Displays all sailings from file, 5 per screen. All rows are
+//             built up front by buildSailingReport, which reads each file once.
     system("cls");
     cout << endl << "== Sailings Report ==" << endl;
     printSailingReportHeader();
 
-    int count = countSailingRecords(sailingFile);
+    vector<SailingReportRow> rows;
+    if (!buildSailingReport(sailingFile, bookingFile, vesselFile, rows)){
+        cout << "Error reading sailing data." << endl;
+        return;
+    }
+    pageSailingReport(rows);
+}
+
+//----------------------------------------------------------------------------
+void pageSailingReport(const vector<SailingReportRow>& rows){
+//Description: Prints the rows 5 per screen, repeating the header on each page.
+    int count = static_cast<int>(rows.size());
     int shownOnPage = 0;
 
     for (int i = 0; i < count; ++i){
-        Sailing s;
-        if (!loadSailingByIndex(sailingFile, i, s)) continue;
-        
-        string sailingID = s.getSailingID();
-        string vesselName = s.getVesselName();
-
-        bookingFile.clear();
-        bookingFile.seekg(0, ios::beg);
-        int vehicleCount = countBookingsForSailing(sailingID, bookingFile);
-
-        vesselFile.clear();
-        vesselFile.seekg(0, ios::beg);
-        float initialCapSmall = getMaxRegularLength(vesselName, vesselFile);
-
-        vesselFile.clear();
-        vesselFile.seekg(0, ios::beg);
-        float initialCapBig = getMaxSpecialLength(vesselName, vesselFile);
-
-        float totalInitialCapacity = initialCapSmall + initialCapBig;
-        float totalRemainingCapacity = s.getCurrentCapacitySmall() + s.getCurrentCapacityBig();
-        float deckUsagePercentage = 0.0f;
-        if (totalInitialCapacity > 0) {
-            deckUsagePercentage = ((totalInitialCapacity - totalRemainingCapacity) / totalInitialCapacity) * 100;
-        }
-
-        cout << right << setw(4) << (i+1) << ") "
-             << left << setw(12) << sailingID << " "
-             << setw(24) << vesselName << " "
-             << setw(6)  << fixed << setprecision(1) << s.getCurrentCapacitySmall() << " "
-             << setw(6)  << s.getCurrentCapacityBig() << " "
-             << setw(14) << vehicleCount << " "
-             << setw(6) << fixed << setprecision(2) << deckUsagePercentage << "%" << endl;
+        printSailingRow(i + 1, rows[i].sailing, rows[i].vehicles, rows[i].deckUsage);
 
         shownOnPage++;
 
@@ -309,9 +323,10 @@ void printReport(fstream& sailingFile, fstream& bookingFile, fstream& vehicleFil
 
 //----------------------------------------------------------------------------
 void querySailing(fstream& sailingFile){
-//Description: Asks for one SailingID and shows its detailed info.
+//Description: Asks for one SailingID and shows its detailed info. A terminal
+//             (ccc) or terminal and day (ccc-dd) lists every matching sailing.
     while (true){
-        cout << endl << "Enter SailingID (ccc-dd-dd) or blank to return: ";
+        cout << endl << "Enter SailingID (ccc-dd-dd), terminal (ccc or ccc-dd) or blank to return: ";
         string sid; 
         getline(cin, sid);
         sid = trim(sid);
@@ -321,30 +336,42 @@ void querySailing(fstream& sailingFile){
             return;
         }
 
-        if(!isValidSailingID(sid)){
+        bool isPrefix = regex_match(sid, regex("^[A-Za-z]{3}(-\\d{2})?$"));
+        if(!isPrefix && !isValidSailingID(sid)){
             cout << "Bad Entry! SailingID must have format ccc-dd-hh. Try again" << endl;
             continue;
         }
 
         system("cls");
-        int idx = findSailingIndexByID(sailingFile, sid);
-        if (idx >= 0){
-            Sailing s;
-            if (!loadSailingByIndex(sailingFile, idx, s)){
-                cout << "Error reading sailing data.\n";
-                return;
+        if (isPrefix){
+            //Ordered range scan over the sailing index
+            vector<int> matches = findSailingIndexesByPrefix(sailingFile, sid);
+            if (matches.empty()){
+                cout << "No sailings found for " << sid << ".\n";
+            } else{
+                cout << "== Sailings for " << sid << " ==\n";
+                printSailingReportHeader();
+                for (size_t i = 0; i < matches.size(); ++i){
+                    Sailing s;
+                    if (loadSailingByIndex(sailingFile, matches[i], s)){
+                        printSailingRow(static_cast<int>(i) + 1, s, s.getBookedVehicles(), s.getDeckUsagePercentage());
+                    }
+                }
             }
-            cout << "== Sailing Details ==\n";
-            printSailingReportHeader();
-            cout << setw(4) << "1)   "
-                 << left << setw(12) << s.getSailingID() << " "
-                 << setw(24) << s.getVesselName() << " "
-                 << setw(6)  << fixed << setprecision(1) << s.getCurrentCapacitySmall() << " "
-                 << setw(6)  << s.getCurrentCapacityBig() << " "
-                 << setw(14) << 0 << " "
-                 << setw(13) << "0%" << "\n";
         } else{
-            cout << "No sailing  with SailingID" << sid << " found.\n";
+            int idx = findSailingIndexByID(sailingFile, sid);
+            if (idx >= 0){
+                Sailing s;
+                if (!loadSailingByIndex(sailingFile, idx, s)){
+                    cout << "Error reading sailing data.\n";
+                    return;
+                }
+                cout << "== Sailing Details ==\n";
+                printSailingReportHeader();
+                printSailingRow(1, s, s.getBookedVehicles(), s.getDeckUsagePercentage());
+            } else{
+                cout << "No sailing  with SailingID" << sid << " found.\n";
+            }
         }
 
         cout << "\nQuery another? (Y/N): ";
@@ -357,9 +384,8 @@ void querySailing(fstream& sailingFile){
 
 //----------------------------------------------------------------------------
 void Sailing::setSailingID(const string& id){
-//Description: Sets the sailingID in the Sailing object
-    strncpy(sailingID, id.c_str(), sizeof(sailingID) - 1);
-    sailingID[sizeof(sailingID) - 1] = '\0';
+//Description: Packs the sailingID into the Sailing object
+    sailingKey = packSailingKey(id);
 }
 
 //----------------------------------------------------------------------------
@@ -383,8 +409,8 @@ void Sailing::setCurrentCapacityBig(float cap){
 
 //----------------------------------------------------------------------------
 string Sailing::getSailingID() const{
-//Description: Gets the sailingID from the Sailing object  
-    return string(sailingID);
+//Description: Unpacks the sailingID from the Sailing object
+    return unpackSailingKey(sailingKey);
 }
 
 //----------------------------------------------------------------------------
@@ -393,6 +419,19 @@ string Sailing::getVesselName() const{
     return string(vesselName);
 }
 
+//----------------------------------------------------------------------------
+bool Sailing::hasSailingID(const string& id) const{
+//Description: Packs id (no allocation) and compares the keys.
+    SailingKey key = packSailingKey(id);
+    return key != noSailingKey && key == sailingKey;
+}
+
+//----------------------------------------------------------------------------
+bool Sailing::hasVesselName(const string& name) const{
+//Description: Compares the stored characters with name, no copy made.
+    return name.compare(vesselName) == 0;
+}
+
 //----------------------------------------------------------------------------
 float Sailing::getCurrentCapacitySmall() const{
 //Description: Gets the currentCapacitySmall from the Sailing object   
@@ -404,3 +443,67 @@ float Sailing::getCurrentCapacityBig() const{
 //Description: Gets the currentCapacityBig from the Sailing object 
     return currentCapacityBig;
 }
+
+//----------------------------------------------------------------------------
+void Sailing::setInitialCapacities(float capSmall, float capBig){
+//Description: Sets the capacities the sailing was created with
+    initialCapacitySmall = capSmall;
+    initialCapacityBig = capBig;
+}
+
+//----------------------------------------------------------------------------
+float Sailing::getInitialCapacitySmall() const{
+//Description: Gets the initialCapacitySmall from the Sailing object
+    return initialCapacitySmall;
+}
+
+//----------------------------------------------------------------------------
+float Sailing::getInitialCapacityBig() const{
+//Description: Gets the initialCapacityBig from the Sailing object
+    return initialCapacityBig;
+}
+
+//----------------------------------------------------------------------------
+void Sailing::setBookedVehicles(int count){
+//Description: Sets the bookedVehicles in the Sailing object
+    bookedVehicles = count;
+}
+
+//----------------------------------------------------------------------------
+int Sailing::getBookedVehicles() const{
+//Description: Gets the bookedVehicles from the Sailing object
+    return bookedVehicles;
+}
+
+//----------------------------------------------------------------------------
+void Sailing::setCheckedInVehicles(int count){
+//Description: Sets the checkedInVehicles in the Sailing object
+    checkedInVehicles = count;
+}
+
+//----------------------------------------------------------------------------
+int Sailing::getCheckedInVehicles() const{
+//Description: Gets the checkedInVehicles from the Sailing object
+    return checkedInVehicles;
+}
+
+//----------------------------------------------------------------------------
+float Sailing::getDeckUsagePercentage() const{
+//Description: Computes the share of the initial deck length in use
+    float totalInitial = initialCapacitySmall + initialCapacityBig;
+    if (totalInitial <= 0) return 0.0f;
+    float totalRemaining = currentCapacitySmall + currentCapacityBig;
+    return ((totalInitial - totalRemaining) / totalInitial) * 100;
+}
+
+//----------------------------------------------------------------------------
+void Sailing::setDeleted(bool status){
+//Description: Sets or clears the tombstone flag.
+    deleted = status;
+}
+
+//----------------------------------------------------------------------------
+bool Sailing::isDeleted() const{
+//Description: Returns whether this record is a tombstone.
+    return deleted;
+}
@@ -1,6 +1,13 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: SailingUserIO.h
+// Rev.7 - 17/10/2026 - Added non-allocating accessors and equality helpers.
+// Rev.6 - 17/10/2026 - Sailing records store the SailingID as a packed SailingKey.
+// Rev.5 - 17/10/2026 - Exported printSailingRow and pageSailingReport for the
+//                      ferryqd client.
+// Rev.4 - 17/10/2026 - Sailing records carry booked and checked-in vehicle counts
+//                      and the capacities they were created with.
+// Rev.3 - 17/10/2026 - Sailing records carry a tombstone flag for in-place deletes.
 // Rev.2 - 24/07/2025 - Multiple function declarations altered to match implementation
 //                    - Changed this module's name from "Sailing.h" to current
 // Rev.1 - 09/07/2025 - SailingUserIO module header created
@@ -21,8 +28,12 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <vector>
+#include "SailingKey.h"
 using namespace std;
 
+struct SailingReportRow;
+
 //Constants used for sailing validation and file name
 const int maxSailingDay = 31;              //Max valid day (1–31)
 const int maxSailingHour = 24;             //Max valid hour (1–24)
@@ -31,7 +42,8 @@ const string fileNameSailing = "sailing.txt"; //Path to sailing file
 //Fixed-length binary record representing a sailing
 class Sailing{
 public:
-    Sailing() : sailingID{0}, vesselName{0}, currentCapacitySmall(0), currentCapacityBig(0){}
+    Sailing() : sailingKey(noSailingKey), vesselName{0}, deleted(false), currentCapacitySmall(0), currentCapacityBig(0),
+                initialCapacitySmall(0), initialCapacityBig(0), bookedVehicles(0), checkedInVehicles(0){}
 
 
 //----------------------------------------------------------------------------
@@ -64,12 +76,38 @@ public:
     //Usage: Used in reports, lookups, or file operations.
     //Restrictions: None.
 
+//----------------------------------------------------------------------------
+    SailingKey getSailingKey() const{ return sailingKey; }
+    //Job: Retrieves the packed Sailing ID.
+    //Usage: Used by the sailing index, the capacity ledger and report joins.
+    //Restrictions: None.
+
 //----------------------------------------------------------------------------
     string getVesselName() const;
     //Job: Retrieves the name of the vessel assigned to this sailing.
     //Usage: Used for display, reporting, or file matching.
     //Restrictions: None.
 
+//----------------------------------------------------------------------------
+    const char* getVesselNameChars() const{ return vesselName; }
+    //Job: Returns the vessel name as it is stored in the record.
+    //Usage: Scan and print loops that must not build a string per record.
+    //Restrictions: Null-terminated; valid as long as the record is.
+
+//----------------------------------------------------------------------------
+    bool hasSailingID(const string& id//input
+                      ) const;
+    //Job: Returns true if this is the sailing with the given ID.
+    //Usage: Compares packed keys; no string is built.
+    //Restrictions: A malformed ID matches no sailing.
+
+//----------------------------------------------------------------------------
+    bool hasVesselName(const string& name//input
+                       ) const;
+    //Job: Returns true if the sailing is assigned to this vessel.
+    //Usage: Compares in place, without copying the name out.
+    //Restrictions: None.
+
 //----------------------------------------------------------------------------
     float getCurrentCapacitySmall() const;
     //Job: Retrieves the current deck usage for regular vehicles.
@@ -82,11 +120,76 @@ public:
     //Usage: Used for validation, capacity checks, or reporting.
     //Restrictions: None.
 
+//----------------------------------------------------------------------------
+    void setInitialCapacities(float capSmall, float capBig);
+    //Job: Records the vessel's deck capacities at the time the sailing is created.
+    //Usage: Called once by createSailing.
+    //Restrictions: Values should match the starting current capacities.
+
+//----------------------------------------------------------------------------
+    float getInitialCapacitySmall() const;
+    //Job: Retrieves the regular deck length the sailing started with.
+    //Usage: Used for deck usage in reports.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    float getInitialCapacityBig() const;
+    //Job: Retrieves the oversize deck length the sailing started with.
+    //Usage: Used for deck usage in reports.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    void setBookedVehicles(int count);
+    //Job: Sets the number of vehicles booked on the sailing.
+    //Usage: Maintained by updateSailingCapacities.
+    //Restrictions: Count must not be negative.
+
+//----------------------------------------------------------------------------
+    int getBookedVehicles() const;
+    //Job: Retrieves the number of vehicles booked on the sailing.
+    //Usage: Used for the Total Vehicles column in reports and queries.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    void setCheckedInVehicles(int count);
+    //Job: Sets the number of booked vehicles that have checked in.
+    //Usage: Maintained by updateSailingCapacities.
+    //Restrictions: Count must not be negative or exceed the booked count.
+
+//----------------------------------------------------------------------------
+    int getCheckedInVehicles() const;
+    //Job: Retrieves the number of booked vehicles that have checked in.
+    //Usage: Used in reports and boarding checks.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    float getDeckUsagePercentage() const;
+    //Job: Returns the percentage of the initial deck length now in use.
+    //Usage: Used for the Deck Usage column in reports and queries.
+    //Restrictions: Returns 0 if the initial capacities are zero.
+
+//----------------------------------------------------------------------------
+    void setDeleted(bool status);
+    //Job: Marks the record as a tombstone (deleted in place).
+    //Usage: Called by SailingFileIO when a sailing is deleted.
+    //Restrictions: Tombstoned records are skipped by every scan and lookup.
+
+//----------------------------------------------------------------------------
+    bool isDeleted() const;
+    //Job: Returns whether the record is a tombstone.
+    //Usage: Used by SailingFileIO scans and compaction.
+    //Restrictions: None.
+
 private:
-    char sailingID[16];         //Format: ccc-dd-hh (15 + null)
+    SailingKey sailingKey;      //Packed ccc-dd-hh (noSailingKey if unset)
     char vesselName[26];        //Vessel name (25 + null)
+    bool deleted;               //Tombstone flag (fits in the padding before the floats)
     float currentCapacitySmall; //Remaining regular deck length (LHR)
     float currentCapacityBig;   //Remaining oversize deck length (HHR)
+    float initialCapacitySmall; //Regular deck length at creation
+    float initialCapacityBig;   //Oversize deck length at creation
+    int bookedVehicles;         //Vehicles currently booked
+    int checkedInVehicles;      //Booked vehicles that have checked in
 };
 
 //----------------------------------------------------------------------------
@@ -112,6 +215,23 @@ void printSailingReportHeader();
 //Job: Prints column headers for use with sailing listings.
 //Usage: Called from printReport and querySailing for consistent formatting.
 
+//----------------------------------------------------------------------------
+void printSailingRow(int row,            //input
+                     const Sailing& s,   //input
+                     int vehicles,       //input
+                     float deckUsage     //input
+                     );
+//Job: Prints one sailing as a numbered row under printSailingReportHeader.
+//Usage: Called by the report and query screens, local and ferryqd client.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+void pageSailingReport(const vector<SailingReportRow>& rows//input
+                       );
+//Job: Prints report rows 5 per screen, asking before each further page.
+//Usage: Called by printReport and the ferryqd client after the header.
+//Restrictions: Returns early if the user enters blank or 0.
+
 //----------------------------------------------------------------------------
 void printReport(fstream& sailingFile, fstream& bookingFile, fstream& vehicleFile, fstream& vesselFile);
 //Job: Displays all sailing records in a paginated list (5 per page).
@@ -120,7 +240,8 @@ void printReport(fstream& sailingFile, fstream& bookingFile, fstream& vehicleFil
 
 //----------------------------------------------------------------------------
 void querySailing(fstream& sailingFile);
-//Job: Prompts for a SailingID and displays full details if found.
+//Job: Prompts for a SailingID and displays full details if found. A terminal
+//     code (ccc) or terminal and day (ccc-dd) lists all matching sailings.
 //Usage: Called from Sailings menu (option [5]).
 //Requirements: SailingID must be valid; record must exist in file.
 
@@ -0,0 +1,186 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: ScanKernel.cpp
+// Rev.1 - 17/10/2026 - Implements the scalar, SSE2 and AVX2 key-matching kernels.
+//
+// ----------------------------------------------------------------------------
+// This module finds the first record whose key field equals a given key.
+//
+// Implementation Strategy:
+// - The key is copied into a zeroed 32-byte buffer once per call, and a
+//   bit mask selects the bytes of the compare result that belong to it, so
+//   any field width up to 32 bytes uses the same loops.
+// - A vector variant loads a full 16 (or 32) bytes starting at the field.
+//   It is only used when that window ends inside the record, so the loads
+//   never leave the block; otherwise the scalar loop runs.
+// - SSE2 tests four records per iteration and only looks at which one
+//   matched after one combined test. AVX2 puts the fields of two records in
+//   the halves of one register, or compares a 32-byte field at once.
+// - The vector functions are compiled for their instruction set with the
+//   target attribute, so the rest of the program keeps the default flags;
+//   which one runs is decided once with __builtin_cpu_supports.
+//
+// Used By: VehicleFileIO.cpp, BookingFileIO.cpp, BookingHashStore.cpp and
+//          BookingLsmStore.cpp.
+// ----------------------------------------------------------------------------
+
+#include "ScanKernel.h"
+#include <atomic>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SCAN_KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define SCAN_KERNEL_X86 0
+#endif
+
+using namespace std;
+
+static atomic<int> selectedKernel(-1);  //ScanKernelKind in use (-1 = best)
+
+//----------------------------------------------------------------------------
+static unsigned int fieldMask(size_t bytes){
+//Description: Returns a mask with one bit per key byte, up to 32.
+    return bytes >= 32 ? 0xffffffffu : (1u << bytes) - 1;
+}
+
+//----------------------------------------------------------------------------
+static int scalarFind(const char* field, size_t stride, int count, const char* key, size_t keyBytes){
+//Description: memcmp of the field of each record in turn.
+    for (int i = 0; i < count; ++i, field += stride){
+        if (memcmp(field, key, keyBytes) == 0) return i;
+    }
+    return -1;
+}
+
+#if SCAN_KERNEL_X86
+
+//----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+static int sse2Find(const char* field, size_t stride, int count, const char* key, size_t keyBytes){
+//Description: One or two 16-byte compares per record, four records per loop.
+    char padded[maxScanKeyBytes] = {0};
+    memcpy(padded, key, keyBytes);
+    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded));
+    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(padded + 16));
+    const unsigned int lowMask = fieldMask(keyBytes < 16 ? keyBytes : 16);
+    const unsigned int highMask = keyBytes > 16 ? fieldMask(keyBytes - 16) : 0;
+    int i = 0;
+
+    if (highMask == 0){
+        for (; i + 4 <= count; i += 4){
+            const char* p = field + static_cast<size_t>(i) * stride;
+            unsigned int m0 = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), low)));
+            unsigned int m1 = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + stride)), low)));
+            unsigned int m2 = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2 * stride)), low)));
+            unsigned int m3 = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 3 * stride)), low)));
+            unsigned int hits = static_cast<unsigned int>((m0 & lowMask) == lowMask) |
+                                static_cast<unsigned int>((m1 & lowMask) == lowMask) << 1 |
+                                static_cast<unsigned int>((m2 & lowMask) == lowMask) << 2 |
+                                static_cast<unsigned int>((m3 & lowMask) == lowMask) << 3;
+            if (hits != 0) return i + __builtin_ctz(hits);
+        }
+    }
+    for (; i < count; ++i){
+        const char* p = field + static_cast<size_t>(i) * stride;
+        unsigned int m = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), low)));
+        if ((m & lowMask) != lowMask) continue;
+        if (highMask == 0) return i;
+        m = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), high)));
+        if ((m & highMask) == highMask) return i;
+    }
+    return -1;
+}
+
+//----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static int avx2Find(const char* field, size_t stride, int count, const char* key, size_t keyBytes){
+//Description: Two records per 256-bit compare for fields up to 16 bytes,
+//             one record per compare for wider fields.
+    char padded[maxScanKeyBytes] = {0};
+    memcpy(padded, key, keyBytes);
+    const unsigned int mask = fieldMask(keyBytes);
+    int i = 0;
+
+    if (keyBytes <= 16){
+        const __m256i pair = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(padded)));
+        const unsigned int pairMask = mask | (mask << 16);
+        for (; i + 2 <= count; i += 2){
+            const char* p = field + static_cast<size_t>(i) * stride;
+            __m256i fields = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + stride)), 1);
+            unsigned int m = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(fields, pair))) & pairMask;
+            if ((m & mask) == mask) return i;
+            if ((m >> 16) == mask) return i + 1;
+        }
+        if (i < count){
+            const char* p = field + static_cast<size_t>(i) * stride;
+            unsigned int m = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm256_castsi256_si128(pair))));
+            if ((m & mask) == mask) return i;
+        }
+        return -1;
+    }
+
+    const __m256i needle = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded));
+    for (; i < count; ++i){
+        const char* p = field + static_cast<size_t>(i) * stride;
+        unsigned int m = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), needle)));
+        if ((m & mask) == mask) return i;
+    }
+    return -1;
+}
+
+#endif //SCAN_KERNEL_X86
+
+//----------------------------------------------------------------------------
+static ScanKernelKind probeBestScanKernel(){
+//Description: Asks the processor which instruction sets it has.
+#if SCAN_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return avx2ScanKernel;
+    if (__builtin_cpu_supports("sse2")) return sse2ScanKernel;
+#endif
+    return scalarScanKernel;
+}
+
+//----------------------------------------------------------------------------
+ScanKernelKind getBestScanKernel(){
+//Description: Probes once (thread-safe static initialisation).
+    static const ScanKernelKind best = probeBestScanKernel();
+    return best;
+}
+
+//----------------------------------------------------------------------------
+void setScanKernel(ScanKernelKind kind){
+//Description: Stores the variant, limited to what the processor supports.
+    selectedKernel = kind > getBestScanKernel() ? getBestScanKernel() : kind;
+}
+
+//----------------------------------------------------------------------------
+ScanKernelKind getScanKernel(){
+//Description: Returns the stored variant, or the best one if none was set.
+    int kind = selectedKernel.load();
+    return kind < 0 ? getBestScanKernel() : static_cast<ScanKernelKind>(kind);
+}
+
+//----------------------------------------------------------------------------
+int findRecordKey(const void* records, size_t stride, int count, size_t keyOffset, const void* key, size_t keyBytes){
+//Description: Checks that the vector window fits in a record, then runs
+//             the selected variant.
+    if (count <= 0 || keyBytes == 0 || keyOffset + keyBytes > stride) return -1;
+    const char* field = static_cast<const char*>(records) + keyOffset;
+    const char* wanted = static_cast<const char*>(key);
+#if SCAN_KERNEL_X86
+    size_t window = keyBytes <= 16 ? 16 : 32;
+    if (keyBytes <= maxScanKeyBytes && keyOffset + window <= stride){
+        ScanKernelKind kind = getScanKernel();
+        if (kind == avx2ScanKernel) return avx2Find(field, stride, count, wanted, keyBytes);
+        if (kind == sse2ScanKernel) return sse2Find(field, stride, count, wanted, keyBytes);
+    }
+#endif
+    return scalarFind(field, stride, count, wanted, keyBytes);
+}
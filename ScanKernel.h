@@ -0,0 +1,75 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: ScanKernel.h
+// Rev.1 - 17/10/2026 - Vectorized key matching over blocks of records, with
+//                      SSE2/AVX2 variants picked at run time.
+//
+// ----------------------------------------------------------------------------
+// This header declares the key-matching kernel used by the scans that look
+// for one key among many fixed-length records: a vehicle's plate in the
+// vehicle file, a sailing's bookings in the hash table, a booking in a block
+// of an LSM run.
+//
+// The records are laid out one after another in memory (a mapped file or a
+// block read into a buffer), and the key is a fixed-width byte field inside
+// each record: the packed SailingKey, the zero-padded license plate, or both
+// together. The kernel compares that field of several records per iteration:
+// - SSE2 compares the field (up to 16 bytes, or 32 in two halves) of a
+//   record in one instruction and tests four records per loop;
+// - AVX2 packs the fields of two records into one register, or compares a
+//   32-byte field in one instruction.
+// The variant is chosen once from what the processor supports; a scalar
+// memcmp loop covers other processors and fields the vector loads cannot
+// reach without running past the end of a record.
+// ----------------------------------------------------------------------------
+
+#ifndef SCAN_KERNEL_H
+#define SCAN_KERNEL_H
+
+#include <cstddef>
+using namespace std;
+
+const size_t maxScanKeyBytes = 32;  //Widest field the vector variants compare
+
+//Implementations of the kernel
+enum ScanKernelKind{
+    scalarScanKernel,  //memcmp per record
+    sse2ScanKernel,    //16-byte compares, four records per loop
+    avx2ScanKernel     //32-byte compares, two records per register
+};
+
+//----------------------------------------------------------------------------
+ScanKernelKind getBestScanKernel();
+//Job: Returns the fastest variant this processor supports.
+//Usage: Probed once; the answer is cached.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+void setScanKernel(ScanKernelKind kind//input
+                   );
+//Job: Selects the variant used by findRecordKey.
+//Usage: Tests and benchmarks; the best variant is used by default.
+//Restrictions: A variant the processor lacks falls back to the best one it has.
+
+//----------------------------------------------------------------------------
+ScanKernelKind getScanKernel();
+//Job: Returns the variant in use.
+//Usage: Diagnostics and tests.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+int findRecordKey(const void* records, //input
+                  size_t stride,       //input
+                  int count,           //input
+                  size_t keyOffset,    //input
+                  const void* key,     //input
+                  size_t keyBytes      //input
+                  );
+//Job: Returns the index of the first of count records, stride bytes apart,
+//     whose keyBytes bytes at keyOffset equal key, or -1.
+//Usage: Call again from the index after a match to find the next one.
+//Restrictions: Fields are compared byte for byte, so keys must be stored
+//              zero-padded. Never reads outside [records, records + count * stride).
+//              Safe to call from several threads at once.
+
+#endif //SCAN_KERNEL_H
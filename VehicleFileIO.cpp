@@ -1,6 +1,18 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: VehicleFileIO.cpp
+// Rev.9 - 18/10/2026 - The cache has its own lock, so threads may look
+//                      vehicles up at once.
+// Rev.8 - 17/10/2026 - Added Vehicle::hasLicensePlate.
+// Rev.7 - 17/10/2026 - The disk search matches plates with the scan kernel,
+//                      a block of records at a time.
+// Rev.6 - 17/10/2026 - Appends lock the tail of the file against other processes.
+// Rev.5 - 17/10/2026 - Appends and record counts use a PositionalFile
+//                      (pread/pwrite) instead of seeking the fstream.
+// Rev.4 - 17/10/2026 - Appends are recorded in the write-ahead log.
+// Rev.3 - 17/10/2026 - Scans go through the mapped record store.
+// Rev.2 - 17/10/2026 - Added a resident plate -> dimensions cache in front
+//                      of the vehicle file.
 // Rev.1 - 24/07/2025 - Vehicle class implementation.
 //
 // ----------------------------------------------------------------------------
@@ -12,7 +24,20 @@
 //
 // Implementation Strategy:
 // - Data is stored as fixed-length binary records (using sizeof(Vehicle)).
-// - All lookups are performed using a linear search of the file.
+// - Reads use the RecordStore module: the file is mapped as a Vehicle array
+//   when possible, with positional reads as fallback. Appends and the
+//   record count use the module's PositionalFile, so the caller's fstream
+//   cursor is never moved.
+// - Lookups are served from an in-memory cache (plate -> length, height)
+//   loaded once at startup and kept write-through by writeVehicle. When the
+//   file holds more vehicles than the cache limit, misses fall back to a
+//   linear search of the file and the result is cached if there is room.
+//   The search compares the zero-padded plate field of a whole block of
+//   records at once (ScanKernel.h) instead of building a string per record.
+// - The cache and its counters are guarded by a lock held only while they
+//   are read or changed. Loads scan into a new map and swap it in, and
+//   disk searches run with the lock released, so lookups from several
+//   threads at once only wait on each other for a map probe.
 // - String data (license plate) is stored in a fixed-size char array to
 //   ensure a consistent record size for binary I/O.
 //
@@ -20,13 +45,133 @@
 // ----------------------------------------------------------------------------
 
 #include "VehicleFileIO.h"
+#include "RecordStore.h"
+#include "WriteAheadLog.h"
+#include "ScanKernel.h"
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <cstring>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 using namespace std;
 
+static MappedRecordFile<Vehicle> vehicleRecords(fileNameVehicle);  //Mapped view of the file
+static PositionalFile vehicleData(fileNameVehicle);  //pread/pwrite access to the file
+static unordered_map<string, pair<float, float> > vehicleCache;  //plate -> (length, height)
+static int cachedVehicleFileCount = -1;   //Record count the cache matches (-1 = not loaded)
+static bool vehicleCacheComplete = false; //True if every record in the file is cached
+static int vehicleCacheLimit = defaultVehicleCacheLimit;
+static mutex vehicleCacheLock;            //Guards the four above; never held across file I/O
+
+//----------------------------------------------------------------------------
+static int countVehicleRecords(fstream& vehicleFile){
+//Description: Returns the number of Vehicle records in the file.
+    long long bytes = vehicleFile.is_open() ? vehicleData.size() : -1;
+    return bytes < 0 ? 0 : static_cast<int>(bytes / static_cast<long long>(sizeof(Vehicle)));
+}
+
+//----------------------------------------------------------------------------
+static bool findVehicleOnDisk(const string& licensePlate, Vehicle& result){
+//Description: Linear search of the file, used only on cache misses when the
+//             cache does not hold every vehicle.
+    Vehicle probe;
+    probe.setLicensePlate(licensePlate);
+    if (!probe.hasLicensePlate(licensePlate)) return false;  //Cannot be stored
+    const char* plate = reinterpret_cast<const char*>(&probe) + Vehicle::licensePlateOffset();
+    return scanRecordBatches(vehicleData, vehicleRecords, [&](const Vehicle* records, int count, int){
+        int hit = findRecordKey(records, sizeof(Vehicle), count, Vehicle::licensePlateOffset(),
+                                plate, Vehicle::licensePlateBytes());
+        if (hit >= 0) result = records[hit];
+        return hit;
+    }) >= 0;
+}
+
+//----------------------------------------------------------------------------
+static bool lookupVehicle(fstream& vehicleFile, const string& licensePlate, float& length, float& height){
+//Description: Looks the plate up in the cache, going to disk only if the
+//             cache is partial. Returns true if the vehicle exists.
+    int records = countVehicleRecords(vehicleFile);
+    bool loaded;
+    {
+        lock_guard<mutex> guard(vehicleCacheLock);
+        loaded = cachedVehicleFileCount >= 0 && cachedVehicleFileCount == records;
+    }
+    if (!loaded) loadVehicleCache(vehicleFile);
+
+    {
+        lock_guard<mutex> guard(vehicleCacheLock);
+        unordered_map<string, pair<float, float> >::const_iterator it = vehicleCache.find(licensePlate);
+        if (it != vehicleCache.end()){
+            length = it->second.first;
+            height = it->second.second;
+            return true;
+        }
+        if (vehicleCacheComplete) return false;
+    }
+
+    Vehicle temp;
+    if (!findVehicleOnDisk(licensePlate, temp)) return false;
+    length = temp.getLength();
+    height = temp.getHeight();
+    lock_guard<mutex> guard(vehicleCacheLock);
+    if (static_cast<int>(vehicleCache.size()) < vehicleCacheLimit){
+        vehicleCache[licensePlate] = make_pair(length, height);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool loadVehicleCache(fstream& vehicleFile){
+//Description: Reads the vehicle file once and caches up to the configured
+//             limit of vehicles. The scan fills a new map, which is
+//             swapped in once complete.
+    int limit;
+    {
+        lock_guard<mutex> guard(vehicleCacheLock);
+        vehicleCache.clear();
+        cachedVehicleFileCount = -1;
+        vehicleCacheComplete = false;
+        limit = vehicleCacheLimit;
+    }
+
+    if (!vehicleFile.is_open()) return false;
+
+    unordered_map<string, pair<float, float> > cache;
+    int count = 0;
+    bool complete = true;
+    scanRecords(vehicleData, vehicleRecords, [&](const Vehicle& temp, int){
+        if (static_cast<int>(cache.size()) < limit){
+            cache[temp.getLicensePlate()] = make_pair(temp.getLength(), temp.getHeight());
+        } else{
+            complete = false;
+        }
+        ++count;
+        return true;
+    });
+    lock_guard<mutex> guard(vehicleCacheLock);
+    vehicleCache.swap(cache);
+    cachedVehicleFileCount = count;
+    vehicleCacheComplete = complete;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+void setVehicleCacheLimit(int maxVehicles){
+//Description: Sets how many vehicles the cache may hold. Shrinking the
+//             limit drops the cache; it is reloaded on the next lookup.
+    lock_guard<mutex> guard(vehicleCacheLock);
+    vehicleCacheLimit = maxVehicles < 0 ? 0 : maxVehicles;
+    if (static_cast<int>(vehicleCache.size()) > vehicleCacheLimit){
+        vehicleCache.clear();
+        cachedVehicleFileCount = -1;
+        vehicleCacheComplete = false;
+    }
+}
+
 //----------------------------------------------------------------------------
 Vehicle::Vehicle(const string& licensePlate, const float& height, const float& length){
 //Description: This is a constructor that initializes a Vehicle object with license, height, and length.
@@ -38,58 +183,52 @@ Vehicle::Vehicle(const string& licensePlate, const float& height, const float& l
 
 //----------------------------------------------------------------------------
 bool writeVehicle(fstream& vehicleFile, const Vehicle& vehicle){
-//Description: Appends a vehicle record to the end of the vehicle file.
-//             Returns true if successful.
-    vehicleFile.clear();                       //Clear EOF or fail flags
-    vehicleFile.seekp(0, ios::end);            //Move to end to append
-
-    if (!vehicleFile){
+//Description: Appends a vehicle record to the end of the vehicle file and
+//             writes it through to the cache. Returns true if successful.
+    RecordLock tail(vehicleData, vehicleData.size(), toEndOfFile, true);  //Appends take turns at the tail
+    if (!tail.isHeld()) return false;
+    long long end = vehicleFile.is_open() ? vehicleData.size() : -1;  //Append at the end of file
+    if (end < 0){
         cerr << "Error: Vehicle file stream not available for writing.\n";
         return false;
     }
 
-    vehicleFile.write(reinterpret_cast<const char*>(&vehicle), sizeof(Vehicle));
-    vehicleFile.flush();                       //Ensure it's written to disk
+    logRecordWrite(fileNameVehicle, end, &vehicle, sizeof(Vehicle));
+    if (!vehicleData.writeAt(end, &vehicle, sizeof(Vehicle))){
+        lock_guard<mutex> guard(vehicleCacheLock);
+        cachedVehicleFileCount = -1;
+        return false;
+    }
+
+    lock_guard<mutex> guard(vehicleCacheLock);
+    if (cachedVehicleFileCount != static_cast<int>(end / static_cast<long long>(sizeof(Vehicle)))){
+        cachedVehicleFileCount = -1;           //Reloaded on next lookup
+    } else{
+        if (static_cast<int>(vehicleCache.size()) < vehicleCacheLimit){
+            vehicleCache[vehicle.getLicensePlate()] = make_pair(vehicle.getLength(), vehicle.getHeight());
+        } else{
+            vehicleCacheComplete = false;
+        }
+        ++cachedVehicleFileCount;
+    }
     return true;
 }
 
 //----------------------------------------------------------------------------
 bool isVehicleExist(fstream& vehicleFile, const string& licensePlate){
 //Description: Checks if a vehicle with the given license plate exists in the file.
-//             Returns true if found.
-    vehicleFile.clear();
-    vehicleFile.seekg(0, ios::beg);
-    Vehicle temp;
-
-    //Linear search through all records
-    while (vehicleFile.read(reinterpret_cast<char*>(&temp), sizeof(Vehicle))){
-        if (temp.getLicensePlate() == licensePlate){
-            return true;
-        }
-    }
-    return false;
+//             Returns true if found. Answered from the cache when possible.
+    float length, height;
+    return lookupVehicle(vehicleFile, licensePlate, length, height);
 }
 
 //----------------------------------------------------------------------------
 bool getVehicleDimensions(fstream& vehicleFile, const string& licensePlate, float& length, float& height){
 //Description: Retrieves the dimensions of a vehicle by license plate.
 //             Stores the length and height in output parameters and returns true if found.
-    vehicleFile.clear();
-    vehicleFile.seekg(0, ios::beg);
-    Vehicle temp;
-
-    //Search each record for a match
-    while (vehicleFile.read(reinterpret_cast<char*>(&temp), sizeof(Vehicle))){
-        if (temp.getLicensePlate() == licensePlate){
-            length = temp.getLength();
-            height = temp.getHeight();
-            return true;
-        }
-    }
-    return false;
+    return lookupVehicle(vehicleFile, licensePlate, length, height);
 }
 
-
 //----------------------------------------------------------------------------
 void Vehicle::setLicensePlate(const string& licensePlate){
 //Description: Sets the license plate string (fixed-size char array).
@@ -115,6 +254,12 @@ string Vehicle::getLicensePlate() const{
     return string(this->licensePlate);
 }
 
+//----------------------------------------------------------------------------
+bool Vehicle::hasLicensePlate(const string& plate) const{
+//Description: Compares the stored characters with plate, no copy made.
+    return plate.compare(this->licensePlate) == 0;
+}
+
 //----------------------------------------------------------------------------
 float Vehicle::getHeight() const{
 //Description: Returns the height of the vehicle.
@@ -128,3 +273,15 @@ float Vehicle::getLength() const{
 }
 
 //----------------------------------------------------------------------------
+size_t Vehicle::licensePlateOffset(){
+//Description: Returns offsetof(Vehicle, licensePlate).
+    return offsetof(Vehicle, licensePlate);
+}
+
+//----------------------------------------------------------------------------
+size_t Vehicle::licensePlateBytes(){
+//Description: Returns sizeof the plate array, terminator included.
+    return sizeof(licensePlate);
+}
+
+//----------------------------------------------------------------------------
@@ -1,6 +1,10 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: VehicleFileIO.h
+// Rev.6 - 17/10/2026 - Added Vehicle::getLicensePlateChars and hasLicensePlate.
+// Rev.5 - 17/10/2026 - Added Vehicle::licensePlateOffset and licensePlateBytes
+//                      for the scan kernel.
+// Rev.4 - 17/10/2026 - Added the vehicle dimension cache and its size limit
 // Rev.3 - 05/08/2025 - Updated constant values to correctly display in prints
 // Rev.2 - 24/07/2025 - Minor changes to comments
 //                    - Changed this module's name from "Vehicle.h" to current
@@ -19,12 +23,14 @@
 #define VEHICLE_H
 
 #include <iostream>
+#include <fstream>
 #include <string>
 using namespace std;
 
 const float maxLength = 99.9f;  //maximum allowed vehicle length (meters)
 const float maxHeight = 9.9f;   //maximum allowed vehicle height (meters)
 const string fileNameVehicle = "vehicle.txt";
+const int defaultVehicleCacheLimit = 200000;  //Max vehicles held in memory (~60 bytes each)
 
 class Vehicle{
     public:
@@ -68,6 +74,19 @@ class Vehicle{
         //Usage: Used in display, search, or when writing to file.
         //Restrictions: None.
 
+//----------------------------------------------------------------------------
+        const char* getLicensePlateChars() const{ return licensePlate; }
+        //Job: Returns the license plate as it is stored in the record.
+        //Usage: Scan loops that must not build a string per record.
+        //Restrictions: Null-terminated; valid as long as the record is.
+
+//----------------------------------------------------------------------------
+        bool hasLicensePlate(const string& plate//input
+                             ) const;
+        //Job: Returns true if this is the vehicle with the given plate.
+        //Usage: Compares in place, without copying the plate out.
+        //Restrictions: None.
+
 //----------------------------------------------------------------------------
         float getHeight() const;
         //Job: Retrieves the height of the vehicle.
@@ -79,6 +98,18 @@ class Vehicle{
         //Job: Retrieves the length of the vehicle.
         //Usage: Used for file I/O, calculations, or reports.
         //Restrictions: None.
+
+//----------------------------------------------------------------------------
+        static size_t licensePlateOffset();
+        //Job: Returns the byte offset of the license plate within a record.
+        //Usage: Key field passed to findRecordKey (ScanKernel.h).
+        //Restrictions: None.
+
+//----------------------------------------------------------------------------
+        static size_t licensePlateBytes();
+        //Job: Returns the width of the license plate field.
+        //Usage: Key width passed to findRecordKey.
+        //Restrictions: The plate is zero-padded, so equal plates have equal bytes.
 //----------------------------------------------------------------------------
     private:
         char licensePlate[11]; //License plate (max 10 chars + null terminator)
@@ -111,4 +142,20 @@ bool getVehicleDimensions(fstream& vehicleFile,       //input
 //Usage: Called while creating a Sailings report. Or when fare is calculated
 //Restrictions: vehicle file must be open. license plate has to be in range, vehicle must exist
 
+//----------------------------------------------------------------------------
+bool loadVehicleCache(fstream& vehicleFile//input
+                      );
+//Job: Loads the plate -> (length, height) cache from the vehicle file.
+//Usage: Called once at startup. Lookups reload it automatically if the file
+//       was changed without going through writeVehicle.
+//Restrictions: vehicle file must be open. Holds at most the configured limit.
+
+//----------------------------------------------------------------------------
+void setVehicleCacheLimit(int maxVehicles//input
+                          );
+//Job: Sets the maximum number of vehicles kept in the cache.
+//Usage: Called before loadVehicleCache to bound memory use. Lookups of
+//       vehicles that do not fit fall back to searching the file.
+//Restrictions: Negative values are treated as 0 (cache disabled).
+
 #endif //VEHICLE_H
@@ -1,6 +1,12 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: VesselFileIO.cpp
+// Rev.6 - 17/10/2026 - Appends lock the tail of the file against other processes.
+// Rev.5 - 17/10/2026 - Appends and record counts use a PositionalFile
+//                      (pread/pwrite) instead of seeking the fstream.
+// Rev.4 - 17/10/2026 - Appends are recorded in the write-ahead log.
+// Rev.3 - 17/10/2026 - The catalog is loaded through the mapped record store.
+// Rev.2 - 17/10/2026 - Lookups served from a resident VesselCatalog.
 // Rev.1 - 24/07/2025 - Implementation of Vessel file I/O operations.
 //
 // ----------------------------------------------------------------------------
@@ -12,7 +18,12 @@
 //
 // Implementation Strategy:
 // - Data is stored as fixed-length binary records (using sizeof(Vessel)).
-// - All lookups are performed using a linear search of the file.
+// - Reads use the RecordStore module: the file is mapped as a Vessel array
+//   when possible, with positional reads as fallback. Appends and the
+//   record count use the module's PositionalFile, so the caller's fstream
+//   cursor is never moved.
+// - The file is read once into a VesselCatalog (name -> both capacities);
+//   all lookups are answered from it and new vessels are written through.
 // - String data (vessel name) is stored in a fixed-size char array to
 //   ensure a consistent record size for binary I/O.
 //
@@ -21,77 +32,121 @@
 
 #include "VesselFileIO.h"
 #include "VesselUserIO.h"
+#include "RecordStore.h"
+#include "WriteAheadLog.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
 using namespace std;
 
+static MappedRecordFile<Vessel> vesselRecords(fileNameVessel);  //Mapped view of the file
+static PositionalFile vesselData(fileNameVessel);  //pread/pwrite access to the file
+static VesselCatalog vesselCatalog;  //Shared catalog behind the lookup functions
+
 //----------------------------------------------------------------------------
-bool writeVesselToFile(fstream& vesselFile, const Vessel& vessel){
-//Description: Appends a new Vessel record to the end of the vessel file.
-//             Assumes file is already opened by caller.
-    vesselFile.clear();                //Reset any fail/eof flags
-    vesselFile.seekp(0, ios::end);     //Move to the end for appending
+static int countVesselRecords(fstream& vesselFile){
+//Description: Returns the number of Vessel records in the file.
+    long long bytes = vesselFile.is_open() ? vesselData.size() : -1;
+    return bytes < 0 ? 0 : static_cast<int>(bytes / static_cast<long long>(sizeof(Vessel)));
+}
+
+//----------------------------------------------------------------------------
+bool VesselCatalog::load(fstream& vesselFile){
+//Description: Replaces the catalog contents with every record in the file.
+    vessels.clear();
+    loadedRecordCount = -1;
+    if (!vesselFile.is_open()) return false;
+
+    int count = 0;
+    scanRecords(vesselData, vesselRecords, [&](const Vessel& temp, int){
+        vessels[temp.getName()] = make_pair(temp.getMaxSmall(), temp.getMaxBig());
+        ++count;
+        return true;
+    });
+    loadedRecordCount = count;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool VesselCatalog::find(const string& vesselName, float& maxRegular, float& maxSpecial) const{
+//Description: Single hash lookup returning both capacities.
+    unordered_map<string, pair<float, float> >::const_iterator it = vessels.find(vesselName);
+    if (it == vessels.end()) return false;
+    maxRegular = it->second.first;
+    maxSpecial = it->second.second;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool VesselCatalog::contains(const string& vesselName) const{
+//Description: Returns true if the vessel is in the catalog.
+    return vessels.count(vesselName) != 0;
+}
+
+//----------------------------------------------------------------------------
+void VesselCatalog::add(const Vessel& vessel){
+//Description: Adds one appended vessel and counts its record.
+    vessels[vessel.getName()] = make_pair(vessel.getMaxSmall(), vessel.getMaxBig());
+    if (loadedRecordCount >= 0) ++loadedRecordCount;
+}
 
-    if (!vesselFile){
+//----------------------------------------------------------------------------
+int VesselCatalog::recordCount() const{
+//Description: Returns the number of file records reflected in the catalog.
+    return loadedRecordCount;
+}
+
+//----------------------------------------------------------------------------
+VesselCatalog& getVesselCatalog(fstream& vesselFile){
+//Description: Returns the shared catalog, (re)loading it when it does not
+//             match the number of records in the file.
+    if (vesselCatalog.recordCount() < 0 || vesselCatalog.recordCount() != countVesselRecords(vesselFile)){
+        vesselCatalog.load(vesselFile);
+    }
+    return vesselCatalog;
+}
+
+//----------------------------------------------------------------------------
+bool writeVesselToFile(fstream& vesselFile, const Vessel& vessel){
+//Description: Appends a new Vessel record to the end of the vessel file
+//             and adds it to the catalog. Assumes file is already opened by caller.
+    RecordLock tail(vesselData, vesselData.size(), toEndOfFile, true);  //Appends take turns at the tail
+    if (!tail.isHeld()) return false;
+    bool catalogInSync = vesselCatalog.recordCount() >= 0 && vesselCatalog.recordCount() == countVesselRecords(vesselFile);
+    long long end = vesselFile.is_open() ? vesselData.size() : -1;  //Append at the end of file
+    if (end < 0){
         cerr << "Error: Vessel file stream is not available for writing.\n";
         return false;
     }
 
-    vesselFile.write(reinterpret_cast<const char*>(&vessel), sizeof(Vessel));
-    vesselFile.flush();                //Ensure write hits disk
+    logRecordWrite(fileNameVessel, end, &vessel, sizeof(Vessel));
+    if (!vesselData.writeAt(end, &vessel, sizeof(Vessel))) return false;
+    if (catalogInSync) vesselCatalog.add(vessel);
     return true;
 }
 
 //----------------------------------------------------------------------------
 bool doesVesselExist(fstream& vesselFile, const string& vesselName){
 //Description: Checks if a vessel with the given name exists in the file.
-//             Uses a linear search through the entire file.
-    vesselFile.clear();                //Reset stream flags
-    vesselFile.seekg(0, ios::beg);     //Start reading from beginning
-
-    Vessel temp;
-    //Linear search: read one record at a time
-    while (vesselFile.read(reinterpret_cast<char*>(&temp), sizeof(Vessel))){
-        if (temp.getName() == vesselName){
-            return true;
-        }
-    }
-    return false;
+//             Answered from the catalog.
+    return getVesselCatalog(vesselFile).contains(vesselName);
 }
 
 //----------------------------------------------------------------------------
 float getMaxRegularLength(const string& vesselName, fstream& vesselFile){
 //Description: Retrieves the max regular (low vehicle) capacity for a given vessel name.
 //             Returns -1.0f if vessel not found.
-    vesselFile.clear();                //Reset stream flags
-    vesselFile.seekg(0, ios::beg);     //Start from beginning
-
-    Vessel temp;
-    //Linear search to find matching vessel
-    while (vesselFile.read(reinterpret_cast<char*>(&temp), sizeof(Vessel))){
-        if (temp.getName() == vesselName){
-            return temp.getMaxSmall(); //Return regular capacity
-        }
-    }
-    return -1.0f;  //Not found
+    float maxRegular, maxSpecial;
+    if (!getVesselCatalog(vesselFile).find(vesselName, maxRegular, maxSpecial)) return -1.0f;
+    return maxRegular;
 }
 
 //----------------------------------------------------------------------------
 float getMaxSpecialLength(const string& vesselName, fstream& vesselFile){
 //Description: Retrieves the max special (oversize vehicle) capacity 
 //             for a given vessel. Returns -1.0f if vessel not found.
-    vesselFile.clear();
-    vesselFile.seekg(0, ios::beg);
-
-    Vessel temp;
-    //Linear search to find matching vessel
-    while (vesselFile.read(reinterpret_cast<char*>(&temp), sizeof(Vessel))){
-        if (temp.getName() == vesselName){
-            return temp.getMaxBig();  //Return special capacity
-        }
-    }
-    return -1.0f;
+    float maxRegular, maxSpecial;
+    if (!getVesselCatalog(vesselFile).find(vesselName, maxRegular, maxSpecial)) return -1.0f;
+    return maxSpecial;
 }
-
@@ -1,13 +1,16 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: VesselFileIO.h
+// Rev.2 - 17/10/2026 - Added the VesselCatalog class for single-lookup capacities
+//                    - Fixed getMax*Length declarations to match the definitions
 // Rev.1 - 24/07/2025 - Initial creation of low-level Vessel file I/O header.
 // 
 // ----------------------------------------------------------------------------
 // This header declares the low-level functions for direct binary file access
 // to vessel records. It serves as the data persistence layer for vessels,
 // abstracting away the details of reading and writing fixed-length vessel
-// records from the data file.
+// records from the data file. The VesselCatalog keeps every vessel resident
+// so both capacities of a vessel come back from a single hash lookup.
 //
 // These functions are called by the VesselUserIO and SailingUserIO modules.
 // ----------------------------------------------------------------------------
@@ -18,8 +21,66 @@
 #include "VesselUserIO.h"
 #include <string>
 #include <fstream>
+#include <unordered_map>
+#include <utility>
 using namespace std;
 
+//In-memory catalog of all vessels, keyed on vessel name
+class VesselCatalog{
+public:
+    VesselCatalog() : loadedRecordCount(-1){}
+
+//----------------------------------------------------------------------------
+    bool load(fstream& vesselFile//input
+              );
+    //Job: Reads every Vessel record from the file into the catalog.
+    //Usage: Called by getVesselCatalog when the catalog is empty or stale,
+    //       and by the sailings report on a private catalog.
+    //Restrictions: File must be open in binary read mode.
+
+//----------------------------------------------------------------------------
+    bool find(const string& vesselName, //input
+              float& maxRegular,        //output
+              float& maxSpecial         //output
+              ) const;
+    //Job: Returns both lane capacities of a vessel from one lookup.
+    //Usage: Used when creating sailings and printing the sailings report.
+    //Restrictions: Returns false (outputs untouched) if the vessel is unknown.
+
+//----------------------------------------------------------------------------
+    bool contains(const string& vesselName//input
+                  ) const;
+    //Job: Checks whether a vessel with this name is in the catalog.
+    //Usage: Used to prevent duplicate vessel names.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+    void add(const Vessel& vessel//input
+             );
+    //Job: Adds a vessel that was just appended to the vessel file.
+    //Usage: Called by writeVesselToFile to keep the catalog write-through.
+    //Restrictions: Catalog must have been loaded from the same file.
+
+//----------------------------------------------------------------------------
+    int recordCount() const;
+    //Job: Returns how many file records the catalog reflects (-1 if not loaded).
+    //Usage: Used to detect a vessel file changed outside this module.
+    //Restrictions: None.
+
+//----------------------------------------------------------------------------
+private:
+    unordered_map<string, pair<float, float> > vessels;  //name -> (regular, special)
+    int loadedRecordCount;                                //File records loaded (-1 = none)
+};
+
+//----------------------------------------------------------------------------
+VesselCatalog& getVesselCatalog(fstream& vesselFile//input
+                                );
+//Job: Returns the shared vessel catalog, loading it on first use and
+//     reloading it if the file's record count no longer matches.
+//Usage: Called wherever vessel capacities or existence are needed.
+//Restrictions: File must be open in binary read mode.
+
 
 //----------------------------------------------------------------------------
 bool writeVesselToFile(fstream& vesselFile, const Vessel& vessel);
@@ -29,20 +90,22 @@ bool writeVesselToFile(fstream& vesselFile, const Vessel& vessel);
 
 //----------------------------------------------------------------------------
 bool doesVesselExist(fstream& vesselFile, const string& vesselName);
-//Job: Checks if a vessel with the given name exists in the file.
+//Job: Checks if a vessel with the given name exists in the catalog.
 //Usage: Called before writing a new vessel to prevent duplicates.
 //Restrictions: File must be open in read mode.
 
 //----------------------------------------------------------------------------
-float getMaxRegularLength(fstream& vesselFile, const string& vesselName);
+float getMaxRegularLength(const string& vesselName, fstream& vesselFile);
 //Job: Retrieves the max regular vehicle capacity for a specific vessel.
-//Usage: Used during sailing or booking validation.
+//Usage: Used during sailing or booking validation. Prefer
+//       getVesselCatalog().find() when both capacities are needed.
 //Restrictions: File must be open in read mode. Returns -1 if not found.
 
 //----------------------------------------------------------------------------
-float getMaxSpecialLength(fstream& vesselFile, const string& vesselName);
+float getMaxSpecialLength(const string& vesselName, fstream& vesselFile);
 //Job: Retrieves the max special vehicle capacity for a specific vessel.
-//Usage: Used during sailing or booking validation.
+//Usage: Used during sailing or booking validation. Prefer
+//       getVesselCatalog().find() when both capacities are needed.
 //Restrictions: File must be open in read mode. Returns -1 if not found.
 
 #endif //VESSEL_IO_H
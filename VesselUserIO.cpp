@@ -1,6 +1,7 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: VesselUserIO.cpp
+// Rev.3 - 17/10/2026 - Added Vessel::hasName.
 // Rev.2 - 05/08/2025 - Updated user input logic to correctly check for blank inputs.
 //                    - Functions now clear the terminal before outputting their result.
 // Rev.1 - 24/07/2025 - Vessel class implementation.
@@ -136,6 +137,12 @@ string Vessel::getName() const{
     return string(name);
 }
 
+//----------------------------------------------------------------------------
+bool Vessel::hasName(const string& vesselName) const{
+//Description: Compares the stored characters with vesselName, no copy made.
+    return vesselName.compare(name) == 0;
+}
+
 //----------------------------------------------------------------------------
 float Vessel::getMaxSmall() const{
 //Description: Returns how many regular vehicles this vessel can carry.
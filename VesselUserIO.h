@@ -1,6 +1,7 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: VesselUserIO.h
+// Rev.3 - 17/10/2026 - Added Vessel::getNameChars and hasName.
 // Rev.2 - 24/07/2025 - Minor changes to function comments
 //                    - Changed the file name from "Vessel.h" to current
 // Rev.1 - 09/07/2025 - Vessel class header created.
@@ -58,6 +59,19 @@ public:
     //Usage: Used for reports, searching, or I/O.
     //Restrictions: None.
 
+//----------------------------------------------------------------------------
+    const char* getNameChars() const{ return name; }
+    //Job: Returns the vessel's name as it is stored in the record.
+    //Usage: Scan loops that must not build a string per record.
+    //Restrictions: Null-terminated; valid as long as the record is.
+
+//----------------------------------------------------------------------------
+    bool hasName(const std::string& vesselName//input
+                 ) const;
+    //Job: Returns true if this is the vessel with the given name.
+    //Usage: Compares in place, without copying the name out.
+    //Restrictions: None.
+
 //----------------------------------------------------------------------------    
     float getMaxSmall() const;
     //Job: Retrieves the regular deck capacity.
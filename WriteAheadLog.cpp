@@ -0,0 +1,913 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: WriteAheadLog.cpp
+// Rev.5 - 18/10/2026 - Each process writes its own log slot; startup only
+//                      recovers the logs of processes that are gone.
+// Rev.4 - 18/10/2026 - Added abortWalTransaction, which rolls a transaction
+//                      back to where it (or its nested level) began.
+// Rev.3 - 17/10/2026 - Group-commit fdatasyncs are queued on an io_uring and
+//                      checkpoints sync the data files together.
+// Rev.2 - 17/10/2026 - Added getWalTransactionId.
+// Rev.1 - 17/10/2026 - Implements the write-ahead log, group commit and replay.
+//
+// ----------------------------------------------------------------------------
+// This module implements the write-ahead log declared in WriteAheadLog.h.
+//
+// Log format (native byte order, records appended back to back):
+// - Write record:    type, txn, stamp, file name, offset, prior file size,
+//                    new bytes (redo image), old bytes (undo image)
+// - Truncate record: type, txn, stamp, file name, new size, prior file size,
+//                    removed tail bytes (undo image)
+// - Commit record:   type, txn, checksum of the transaction's records
+// The stamp is the machine's monotonic clock in nanoseconds when the change
+// was logged.
+//
+// Files next to the log (for a log named ferryq.wal):
+// - ferryq.wal, ferryq.wal.1, ... up to walMaxLogs slots: one log per
+//   running process, each held with an exclusive flock by its owner.
+// - ferryq.wal.lock: flocked to serialize startup recovery and updates of
+//   the checkpoint table.
+// - ferryq.wal.ckpt: the checkpoint table, one line per data file with the
+//   stamp of its latest checkpoint (replaced whole with a rename).
+//
+// Implementation Strategy:
+// - Every change is physical (bytes at an offset, or a new file size), so
+//   redo is idempotent and undo is exact.
+// - A transaction's records are written to the log before its data writes
+//   (except under walNone); its commit record closes it. The checksum
+//   rejects a transaction torn by a crash in the middle of a log write.
+// - Transaction ids are per log. A change to a record is logged and written
+//   while the FileIO module holds an exclusive lock on it, so the stamps of
+//   the changes to one record, in all logs, are in the order they were made.
+// - Startup takes the startup lock and probes every slot with a
+//   non-blocking flock: a slot it can lock belongs to a process that is
+//   gone. If no other process is running, the dead logs are recovered as a
+//   whole: committed changes newer than their file's checkpoint stamp are
+//   redone in stamp order, then unfinished ones are undone, newest first,
+//   and the checkpoint table is cleared along with the logs. If others are
+//   running, their page cache already holds the dead process's writes, so
+//   only its unfinished changes are undone; the files are then checkpointed
+//   before its log is dropped. The process then claims the lowest free slot.
+// - An undo is a compare-and-restore under an exclusive byte-range lock:
+//   the before-image goes back only if the bytes still equal the change's
+//   after-image, a cut-off append only if it is still the end of the file,
+//   and a truncate's tail only if nothing was appended since. A change that
+//   another process has since overwritten is left alone.
+// - A checkpoint takes a shared lock on every file it syncs, without
+//   waiting. Holding them, no logged change is still on its way to the file
+//   in any process, so once the files are synced every change stamped
+//   before that moment is durable. That stamp goes into the checkpoint
+//   table, which is what lets recovery skip older changes still in other
+//   processes' logs instead of redoing them over newer data. If a lock is
+//   busy, the checkpoint is tried again at the next commit.
+// - Inside a transaction the undo image of every change is also kept in
+//   memory, logging or not. abortWalTransaction writes the undo images back,
+//   newest first, down to the savepoint its nesting level began at, with
+//   the same compare-and-restore as recovery. Each restore is logged as an
+//   ordinary change of the same transaction, which then commits, so replay
+//   redoes the changes and the restores in order.
+// - Checkpoint: once the log passes walCheckpointBytes, the data files are
+//   fsynced (all at once through IoRing where available), the checkpoint
+//   table is updated and the log is emptied.
+// - Under walGroupFsync the fdatasync closing a group is queued on an
+//   io_uring and not waited for; the next group sync (or any synchronous
+//   one) first waits for it. Only one group is ever unsynced in the kernel
+//   beyond the one being filled. Log records themselves are still written
+//   synchronously, since they must reach the OS before the data write.
+// - Platforms without POSIX descriptors run with logging switched off.
+//
+// Used By: BookingFileIO, SailingFileIO, VehicleFileIO and VesselFileIO log
+//          their writes; the UserIO modules group them; main opens the log.
+// ----------------------------------------------------------------------------
+
+#include "WriteAheadLog.h"
+#include "IoRing.h"
+#include "RecordStore.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+static const unsigned char walWriteRecord = 1;
+static const unsigned char walTruncateRecord = 2;
+static const unsigned char walCommitRecord = 3;
+static const size_t walNoneBufferBytes = 64 * 1024;  //Buffer limit under walNone
+
+static int walFd = -1;                       //Open log (-1 = logging off), flocked
+static long walPid = 0;                      //Process that opened walFd
+static string walBaseName;                   //Log name given to openWriteAheadLog (slot 0)
+static string walLogName;                    //Slot this process claimed
+static string walLockName;                   //Startup lock file
+static string walTableName;                  //Checkpoint table file
+static WalDurability durability = walGroupFsync;
+static int groupCommitSize = defaultGroupCommitSize;
+static int unsyncedCommits = 0;              //Commits since the last fdatasync
+static int transactionDepth = 0;             //Nesting of beginWalTransaction
+static unsigned int currentTxn = 0;          //Open transaction id (0 = none)
+static unsigned int nextTxn = 1;
+static unsigned int txnChecksum = 0;         //Running checksum of currentTxn
+static int txnRecords = 0;                   //Records logged by currentTxn
+static string pending;                       //Encoded records not yet written
+static vector<size_t> savepoints;            //Size of txnChanges when each nesting level began
+static long long walBytes = 0;               //Bytes written to the log
+static map<string, int> dataFds;             //Data file -> read/write descriptor
+static set<string> touchedFiles;             //Written since last checkpoint
+static unique_ptr<IoRing> syncRing;          //Ring for group syncs (null if unused)
+
+//----------------------------------------------------------------------------
+static unsigned int checksumBytes(unsigned int hash, const char* data, size_t bytes){
+//Description: FNV-1a over a byte range, continuing from hash.
+    for (size_t i = 0; i < bytes; ++i){
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+static void putValue(string& out, T value){
+//Description: Appends a fixed-size value to an encoded record.
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+static bool getValue(const string& in, size_t& pos, T& value){
+//Description: Reads a fixed-size value from an encoded log; false if truncated.
+    if (pos + sizeof(T) > in.size()) return false;
+    memcpy(&value, in.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool getBytes(const string& in, size_t& pos, string& value){
+//Description: Reads a length-prefixed byte string from an encoded log.
+    unsigned int length;
+    if (!getValue(in, pos, length) || pos + length > in.size()) return false;
+    value.assign(in, pos, length);
+    pos += length;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static void putBytes(string& out, const char* data, size_t bytes){
+//Description: Appends a length-prefixed byte string to an encoded record.
+    putValue(out, static_cast<unsigned int>(bytes));
+    out.append(data, bytes);
+}
+
+//Decoded log record used during replay
+struct WalEntry{
+    unsigned char type;
+    unsigned int txn;
+    long long stamp;      //Monotonic nanoseconds when logged
+    string fileName;
+    long long offset;     //Write offset, or new size for a truncate
+    long long priorSize;  //File size before the change
+    string after;         //Redo bytes (writes only)
+    string before;        //Undo bytes
+};
+
+static vector<WalEntry> txnChanges;          //Changes of the open transaction, for rollback
+
+#if !defined(_WIN32)
+
+//----------------------------------------------------------------------------
+static int dataFileFd(const string& fileName){
+//Description: Returns a cached read/write descriptor for a data file.
+    map<string, int>::const_iterator it = dataFds.find(fileName);
+    if (it != dataFds.end()) return it->second;
+    int fd = open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd >= 0) dataFds[fileName] = fd;
+    return fd;
+}
+
+//----------------------------------------------------------------------------
+static void closeDataFileFds(){
+//Description: Closes every cached data file descriptor.
+    for (map<string, int>::const_iterator it = dataFds.begin(); it != dataFds.end(); ++it){
+        close(it->second);
+    }
+    dataFds.clear();
+}
+
+//----------------------------------------------------------------------------
+static long long dataFileSize(int fd){
+//Description: Returns the current size of an open data file.
+    struct stat info;
+    if (fstat(fd, &info) != 0) return 0;
+    return static_cast<long long>(info.st_size);
+}
+
+//----------------------------------------------------------------------------
+static string readDataBytes(int fd, long long offset, long long bytes){
+//Description: Reads bytes at offset; used to capture undo images.
+    string result;
+    if (bytes <= 0) return result;
+    result.resize(static_cast<size_t>(bytes));
+    ssize_t got = pread(fd, &result[0], result.size(), static_cast<off_t>(offset));
+    result.resize(got > 0 ? static_cast<size_t>(got) : 0);
+    return result;
+}
+
+//----------------------------------------------------------------------------
+static bool writeAll(int fd, const char* data, size_t bytes){
+//Description: Appends the whole buffer, retrying short writes.
+    while (bytes > 0){
+        ssize_t done = write(fd, data, bytes);
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) return false;
+        data += done;
+        bytes -= static_cast<size_t>(done);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static bool writePending(){
+//Description: Hands buffered log records to the OS.
+    if (pending.empty()) return true;
+    bool ok = writeAll(walFd, pending.data(), pending.size());
+    walBytes += static_cast<long long>(pending.size());
+    pending.clear();
+    return ok;
+}
+
+//----------------------------------------------------------------------------
+static void waitForGroupSync(){
+//Description: Waits for the queued group sync, if one is in flight.
+    unsigned long long tag;
+    int result;
+    while (syncRing && syncRing->getInFlight() > 0 && syncRing->waitCompletion(tag, result)){}
+}
+
+//----------------------------------------------------------------------------
+static void syncLog(){
+//Description: Forces the log to stable storage.
+    waitForGroupSync();
+    fdatasync(walFd);
+    unsyncedCommits = 0;
+}
+
+//----------------------------------------------------------------------------
+static void queueGroupSync(){
+//Description: Starts the fdatasync closing a group without waiting for it,
+//             once the previous one has finished. Syncs synchronously when
+//             there is no ring.
+    waitForGroupSync();
+    if (syncRing && syncRing->queueSync(walFd, true, 0) && syncRing->submit()){
+        unsyncedCommits = 0;
+        return;
+    }
+    syncLog();
+}
+
+//----------------------------------------------------------------------------
+static long long walStamp(){
+//Description: Returns the machine's monotonic clock in nanoseconds, which
+//             orders the changes logged by every process since boot.
+    return static_cast<long long>(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//----------------------------------------------------------------------------
+static string logSlotName(const string& logFileName, int slot){
+//Description: Returns the file name of a log slot; slot 0 is the log itself.
+    return slot == 0 ? logFileName : logFileName + "." + to_string(slot);
+}
+
+//----------------------------------------------------------------------------
+static bool setFileLock(int fd, short type, long long offset, long long length, bool wait){
+//Description: Sets a byte-range lock owned by the descriptor (length 0
+//             reaches past the end of file). Without wait, fails at once
+//             if a conflicting lock is held.
+    struct flock range;
+    memset(&range, 0, sizeof(range));
+    range.l_type = type;
+    range.l_whence = SEEK_SET;
+    range.l_start = static_cast<off_t>(offset);
+    range.l_len = static_cast<off_t>(length);
+#if defined(F_OFD_SETLKW)
+    int command = wait ? F_OFD_SETLKW : F_OFD_SETLK;
+#else
+    int command = wait ? F_SETLKW : F_SETLK;
+#endif
+    while (fcntl(fd, command, &range) != 0){
+        if (errno != EINTR) return errno == ENOLCK || errno == EOPNOTSUPP || errno == EINVAL;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static int lockStartup(bool wait){
+//Description: Takes the startup lock, which also guards the checkpoint
+//             table. Returns its descriptor, or -1 if it is busy (without
+//             wait) or cannot be opened.
+    int fd = open(walLockName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+    int result;
+    while ((result = flock(fd, wait ? LOCK_EX : LOCK_EX | LOCK_NB)) != 0 && errno == EINTR){}
+    if (result != 0){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+//----------------------------------------------------------------------------
+static void unlockStartup(int fd){
+//Description: Releases the startup lock.
+    if (fd >= 0) close(fd);
+}
+
+//----------------------------------------------------------------------------
+static map<string, long long> readCheckpointTable(){
+//Description: Returns data file -> stamp of its latest checkpoint. A
+//             missing table is empty.
+    map<string, long long> table;
+    int fd = open(walTableName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return table;
+    string text;
+    char buffer[4096];
+    ssize_t got;
+    while ((got = read(fd, buffer, sizeof(buffer))) > 0) text.append(buffer, static_cast<size_t>(got));
+    close(fd);
+    istringstream lines(text);
+    long long stamp;
+    string fileName;
+    while (lines >> stamp && getline(lines >> ws, fileName)) table[fileName] = stamp;
+    return table;
+}
+
+//----------------------------------------------------------------------------
+static bool writeCheckpointTable(const map<string, long long>& table){
+//Description: Replaces the checkpoint table with a synced copy, so a crash
+//             leaves either the old table or the new one.
+    if (table.empty()) return unlink(walTableName.c_str()) == 0 || errno == ENOENT;
+    ostringstream text;
+    for (map<string, long long>::const_iterator it = table.begin(); it != table.end(); ++it){
+        text << it->second << ' ' << it->first << '\n';
+    }
+    string copyName = walTableName + ".tmp";
+    int fd = open(copyName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    string bytes = text.str();
+    bool ok = writeAll(fd, bytes.data(), bytes.size()) && fsync(fd) == 0;
+    close(fd);
+    return ok && rename(copyName.c_str(), walTableName.c_str()) == 0;
+}
+
+//----------------------------------------------------------------------------
+static bool syncCheckpoint(const set<string>& files, bool wait){
+//Description: With a shared lock on each file, so that no logged change is
+//             still on its way to it from any process, takes a stamp,
+//             syncs the files and records the stamp for each in the
+//             checkpoint table. The startup lock must be held. Without
+//             wait, gives up as soon as a file is busy.
+    vector<int> fds;
+    bool locked = true;
+    for (set<string>::const_iterator it = files.begin(); it != files.end() && locked; ++it){
+        int fd = dataFileFd(*it);
+        if (fd < 0) continue;
+        locked = setFileLock(fd, F_RDLCK, 0, 0, wait);
+        if (locked) fds.push_back(fd);
+    }
+    bool ok = false;
+    if (locked){
+        long long stamp = walStamp();
+        ok = syncFilesTogether(fds, false);
+        map<string, long long> table = readCheckpointTable();
+        for (set<string>::const_iterator it = files.begin(); it != files.end(); ++it){
+            table[*it] = max(table[*it], stamp);
+        }
+        ok = writeCheckpointTable(table) && ok;
+    }
+    for (size_t i = 0; i < fds.size(); ++i) setFileLock(fds[i], F_UNLCK, 0, 0, false);
+    return ok;
+}
+
+//----------------------------------------------------------------------------
+static bool checkpoint(bool wait){
+//Description: Makes every logged change durable in the data files, records
+//             it in the checkpoint table, then empties the log. The empty
+//             log is synced before new records are appended so stale
+//             records can never be replayed. Without wait, returns false
+//             (keeping the log) if another process is in the way.
+    writePending();
+    int startupFd = lockStartup(wait);
+    if (startupFd < 0) return false;
+    bool synced = syncCheckpoint(touchedFiles, wait);
+    unlockStartup(startupFd);
+    if (!synced) return false;
+    touchedFiles.clear();
+    if (ftruncate(walFd, 0) == 0){
+        walBytes = 0;
+    }
+    syncLog();
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static void appendRecord(const string& record){
+//Description: Adds one encoded record of the open transaction to the log.
+//             Except under walNone it reaches the OS before the data write.
+    txnChecksum = checksumBytes(txnChecksum, record.data(), record.size());
+    ++txnRecords;
+    pending += record;
+    if (durability != walNone || pending.size() >= walNoneBufferBytes) writePending();
+}
+
+//----------------------------------------------------------------------------
+static void redoEntry(const WalEntry& entry){
+//Description: Applies one logged change to its data file again.
+    int fd = dataFileFd(entry.fileName);
+    if (fd < 0) return;
+    if (entry.type == walWriteRecord){
+        pwrite(fd, entry.after.data(), entry.after.size(), static_cast<off_t>(entry.offset));
+    } else if (entry.type == walTruncateRecord){
+        if (ftruncate(fd, static_cast<off_t>(entry.offset)) != 0) return;
+    }
+}
+
+//----------------------------------------------------------------------------
+static bool undoEntry(const WalEntry& entry){
+//Description: Takes one logged change back out of its data file, under an
+//             exclusive lock on the bytes it covers, but only if they still
+//             hold what the change left there. Returns false if the file
+//             could not be restored.
+    int fd = dataFileFd(entry.fileName);
+    if (fd < 0) return false;
+    long long size = dataFileSize(fd);
+    bool ok = true;
+    if (entry.type == walWriteRecord){
+        long long bytes = static_cast<long long>(entry.after.size());
+        bool lockedHere = !isRangeLockedByThisThread(entry.fileName, entry.offset, bytes);
+        if (lockedHere) setFileLock(fd, F_WRLCK, entry.offset, bytes, true);
+        if (readDataBytes(fd, entry.offset, bytes) == entry.after){
+            if (!entry.before.empty()){
+                ok = pwrite(fd, entry.before.data(), entry.before.size(), static_cast<off_t>(entry.offset)) ==
+                     static_cast<ssize_t>(entry.before.size());
+            }
+            if (entry.offset + bytes > entry.priorSize && dataFileSize(fd) == entry.offset + bytes){
+                ok = ftruncate(fd, static_cast<off_t>(entry.priorSize)) == 0 && ok;
+            }
+        }
+        if (lockedHere) setFileLock(fd, F_UNLCK, entry.offset, bytes, false);
+    } else if (entry.type == walTruncateRecord && size == entry.offset){
+        ok = pwrite(fd, entry.before.data(), entry.before.size(), static_cast<off_t>(entry.offset)) ==
+             static_cast<ssize_t>(entry.before.size());
+    }
+    return ok;
+}
+
+//----------------------------------------------------------------------------
+static int readLog(const string& logFileName, vector<WalEntry>& entries, set<unsigned int>& committed){
+//Description: Decodes a log up to its end or its first torn record,
+//             appending its changes and the ids of its committed
+//             transactions. Returns how many transactions committed.
+    int fd = open(logFileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    string log;
+    char buffer[64 * 1024];
+    ssize_t got;
+    while ((got = read(fd, buffer, sizeof(buffer))) > 0) log.append(buffer, static_cast<size_t>(got));
+    close(fd);
+
+    map<unsigned int, unsigned int> checksums;  //txn -> checksum of its records
+    int count = 0;
+    size_t pos = 0;
+    while (pos < log.size()){
+        size_t start = pos;
+        WalEntry entry;
+        unsigned char nameLength;
+        if (!getValue(log, pos, entry.type) || !getValue(log, pos, entry.txn)) break;
+        if (entry.type == walCommitRecord){
+            unsigned int expected;
+            if (!getValue(log, pos, expected)) break;
+            map<unsigned int, unsigned int>::const_iterator sum = checksums.find(entry.txn);
+            if (sum == checksums.end() || sum->second != expected) break;
+            committed.insert(entry.txn);
+            ++count;
+            continue;
+        }
+        if (entry.type != walWriteRecord && entry.type != walTruncateRecord) break;
+        if (!getValue(log, pos, entry.stamp)) break;
+        if (!getValue(log, pos, nameLength) || pos + nameLength > log.size()) break;
+        entry.fileName.assign(log, pos, nameLength);
+        pos += nameLength;
+        if (!getValue(log, pos, entry.offset) || !getValue(log, pos, entry.priorSize) ||
+            !getBytes(log, pos, entry.after) || !getBytes(log, pos, entry.before)) break;
+        if (checksums.find(entry.txn) == checksums.end()) checksums[entry.txn] = 2166136261u;
+        checksums[entry.txn] = checksumBytes(checksums[entry.txn], log.data() + start, pos - start);
+        entries.push_back(entry);
+    }
+    return count;
+}
+
+//----------------------------------------------------------------------------
+static bool stampOrder(const WalEntry* a, const WalEntry* b){
+//Description: Orders changes from several logs by when they were logged.
+    return a->stamp < b->stamp;
+}
+
+//----------------------------------------------------------------------------
+static int recoverLogs(const vector<string>& logFileNames, bool redo, const map<string, long long>& checkpoints,
+                       set<string>& files){
+//Description: Redoes (if asked) the committed changes of the logs that are
+//             newer than their file's checkpoint, in stamp order, then
+//             undoes the unfinished ones newest first. Collects the names
+//             of the files named in the logs. Returns how many
+//             transactions had committed.
+    vector<vector<WalEntry> > entries(logFileNames.size());
+    vector<set<unsigned int> > committed(logFileNames.size());
+    int count = 0;
+    for (size_t i = 0; i < logFileNames.size(); ++i) count += readLog(logFileNames[i], entries[i], committed[i]);
+
+    vector<const WalEntry*> done, unfinished;
+    for (size_t i = 0; i < entries.size(); ++i){
+        for (size_t j = 0; j < entries[i].size(); ++j){
+            const WalEntry& entry = entries[i][j];
+            files.insert(entry.fileName);
+            if (!committed[i].count(entry.txn)){
+                unfinished.push_back(&entry);
+                continue;
+            }
+            map<string, long long>::const_iterator mark = checkpoints.find(entry.fileName);
+            if (mark == checkpoints.end() || entry.stamp > mark->second) done.push_back(&entry);
+        }
+    }
+    stable_sort(done.begin(), done.end(), stampOrder);
+    stable_sort(unfinished.begin(), unfinished.end(), stampOrder);
+    if (redo){
+        for (size_t i = 0; i < done.size(); ++i) redoEntry(*done[i]);
+    }
+    for (size_t i = unfinished.size(); i-- > 0; ) undoEntry(*unfinished[i]);
+    return count;
+}
+
+//----------------------------------------------------------------------------
+int replayWriteAheadLog(const string& logFileName){
+//Description: Redoes one log's committed transactions in order and undoes
+//             its unfinished ones, then syncs the files it names.
+    set<string> files;
+    int count = recoverLogs(vector<string>(1, logFileName), true, map<string, long long>(), files);
+    for (set<string>::const_iterator it = files.begin(); it != files.end(); ++it){
+        int dataFd = dataFileFd(*it);
+        if (dataFd >= 0) fsync(dataFd);
+    }
+    return count;
+}
+
+//----------------------------------------------------------------------------
+bool openWriteAheadLog(const string& logFileName){
+//Description: Under the startup lock, recovers the logs of processes that
+//             are gone, then claims the lowest free slot and opens it empty.
+//             A forked child drops the parent's log without touching it.
+    if (walFd >= 0 && walPid != static_cast<long>(getpid())){
+        close(walFd);
+        walFd = -1;
+        syncRing.reset();
+        closeDataFileFds();
+        transactionDepth = 0;
+        currentTxn = 0;
+        savepoints.clear();
+        txnChanges.clear();
+        pending.clear();
+    }
+    if (walFd >= 0) closeWriteAheadLog();
+    walBaseName = logFileName;
+    walLockName = logFileName + ".lock";
+    walTableName = logFileName + ".ckpt";
+    int startupFd = lockStartup(true);
+    if (startupFd < 0) return false;
+
+    //A slot whose flock can be taken belongs to no running process
+    vector<string> deadLogs;
+    vector<int> deadFds;
+    bool othersRunning = false;
+    int freeSlot = -1;
+    for (int slot = 0; slot < walMaxLogs; ++slot){
+        string name = logSlotName(logFileName, slot);
+        int fd = open(name.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        if (fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) != 0){
+            othersRunning = true;
+            close(fd);
+            continue;
+        }
+        if (freeSlot < 0) freeSlot = slot;
+        if (fd < 0) continue;
+        deadLogs.push_back(name);
+        deadFds.push_back(fd);
+    }
+
+    //Alone, the dead logs are recovered in full; otherwise the unfinished
+    //changes are undone and the files checkpointed before the logs go
+    set<string> files;
+    recoverLogs(deadLogs, !othersRunning, readCheckpointTable(), files);
+    bool recovered;
+    if (othersRunning){
+        recovered = syncCheckpoint(files, true);
+    } else{
+        vector<int> fds;
+        for (set<string>::const_iterator it = files.begin(); it != files.end(); ++it){
+            int fd = dataFileFd(*it);
+            if (fd >= 0) fds.push_back(fd);
+        }
+        recovered = syncFilesTogether(fds, false) && writeCheckpointTable(map<string, long long>());
+    }
+
+    walLogName = freeSlot < 0 ? string() : logSlotName(logFileName, freeSlot);
+    for (size_t i = 0; i < deadLogs.size(); ++i){
+        if (deadLogs[i] == walLogName){
+            walFd = deadFds[i];  //Reused, with its flock
+            continue;
+        }
+        if (recovered) unlink(deadLogs[i].c_str());
+        close(deadFds[i]);
+    }
+    if (walFd < 0 && !walLogName.empty()){
+        walFd = open(walLogName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (walFd >= 0 && flock(walFd, LOCK_EX | LOCK_NB) != 0){
+            close(walFd);
+            walFd = -1;
+        }
+    }
+    bool opened = walFd >= 0 && recovered && ftruncate(walFd, 0) == 0;
+    unlockStartup(startupFd);
+    if (!opened){
+        if (walFd >= 0) close(walFd);
+        walFd = -1;
+        return false;
+    }
+    if (isAsyncIoEnabled()){
+        syncRing.reset(new IoRing(4));
+        if (!syncRing->isOpen()) syncRing.reset();
+    }
+    syncLog();
+    walBytes = 0;
+    pending.clear();
+    walPid = static_cast<long>(getpid());
+    return true;
+}
+
+//----------------------------------------------------------------------------
+void closeWriteAheadLog(){
+//Description: Commits anything open, checkpoints (waiting for other
+//             processes if need be) and gives up the slot. A slot other
+//             than the first is removed under the startup lock, so no
+//             process starting meanwhile can claim the file being removed.
+    if (walFd < 0) return;
+    if (transactionDepth > 0){
+        transactionDepth = 1;
+        savepoints.resize(1);
+        commitWalTransaction();
+    }
+    bool clean = checkpoint(true);
+    syncRing.reset();
+    int startupFd = clean && walLogName != walBaseName ? lockStartup(true) : -1;
+    if (startupFd >= 0) unlink(walLogName.c_str());
+    close(walFd);
+    unlockStartup(startupFd);
+    walFd = -1;
+    closeDataFileFds();
+}
+
+//----------------------------------------------------------------------------
+static void logChange(unsigned char type, const string& dataFile, long long offset, const char* data, size_t bytes,
+                      bool undoable){
+//Description: Captures what a write (or a truncate to offset) is about to
+//             replace and logs the change. Inside a transaction the undo
+//             image is kept for abortWalTransaction even with the log off.
+    bool keep = undoable && transactionDepth > 0;
+    if (walFd < 0 && !keep) return;
+    int fd = dataFileFd(dataFile);
+    if (fd < 0) return;
+    bool autoCommit = transactionDepth == 0;
+    if (autoCommit) beginWalTransaction();
+
+    WalEntry change;
+    change.type = type;
+    change.txn = currentTxn;
+    change.stamp = walStamp();
+    change.fileName = dataFile;
+    change.offset = offset;
+    change.priorSize = dataFileSize(fd);
+    if (type == walWriteRecord){
+        long long overlap = change.priorSize - offset;
+        if (overlap > static_cast<long long>(bytes)) overlap = static_cast<long long>(bytes);
+        change.before = readDataBytes(fd, offset, overlap);
+        change.after.assign(data, bytes);
+    } else{
+        change.before = readDataBytes(fd, offset, change.priorSize - offset);
+    }
+
+    if (walFd >= 0){
+        string record;
+        putValue(record, type);
+        putValue(record, currentTxn);
+        putValue(record, change.stamp);
+        putValue(record, static_cast<unsigned char>(dataFile.size()));
+        record += dataFile;
+        putValue(record, offset);
+        putValue(record, change.priorSize);
+        putBytes(record, change.after.data(), change.after.size());
+        putBytes(record, change.before.data(), change.before.size());
+        appendRecord(record);
+        touchedFiles.insert(dataFile);
+    }
+    if (keep) txnChanges.push_back(change);
+
+    if (autoCommit) commitWalTransaction();
+}
+
+//----------------------------------------------------------------------------
+static bool restoreChange(const WalEntry& change){
+//Description: Puts back what one change of the open transaction replaced,
+//             logging the restore (which is not undoable itself), under an
+//             exclusive lock on the bytes unless the caller holds one. As
+//             in recovery, bytes another process has changed since are
+//             left alone, and false is returned.
+    int fd = dataFileFd(change.fileName);
+    if (fd < 0) return false;
+    long long bytes = change.type == walWriteRecord ? static_cast<long long>(change.after.size()) : 0;
+    bool lockedHere = !isRangeLockedByThisThread(change.fileName, change.offset, bytes);
+    if (lockedHere) setFileLock(fd, F_WRLCK, change.offset, bytes, true);
+    bool restored;
+    if (change.type == walWriteRecord){
+        restored = readDataBytes(fd, change.offset, bytes) == change.after;
+        if (restored && !change.before.empty()){
+            logChange(walWriteRecord, change.fileName, change.offset, change.before.data(), change.before.size(), false);
+            restored = pwrite(fd, change.before.data(), change.before.size(), static_cast<off_t>(change.offset)) ==
+                       static_cast<ssize_t>(change.before.size());
+        }
+        if (restored && change.offset + bytes > change.priorSize && dataFileSize(fd) == change.offset + bytes){
+            logChange(walTruncateRecord, change.fileName, change.priorSize, "", 0, false);
+            restored = ftruncate(fd, static_cast<off_t>(change.priorSize)) == 0;
+        }
+    } else{
+        restored = dataFileSize(fd) == change.offset;
+        if (restored && !change.before.empty()){
+            logChange(walWriteRecord, change.fileName, change.offset, change.before.data(), change.before.size(), false);
+            restored = pwrite(fd, change.before.data(), change.before.size(), static_cast<off_t>(change.offset)) ==
+                       static_cast<ssize_t>(change.before.size());
+        }
+    }
+    if (lockedHere) setFileLock(fd, F_UNLCK, change.offset, bytes, false);
+    return restored;
+}
+
+//----------------------------------------------------------------------------
+static bool rollBackTo(size_t savepoint){
+//Description: Undoes the open transaction's changes after savepoint,
+//             newest first.
+    bool restored = true;
+    for (size_t i = txnChanges.size(); i-- > savepoint; ){
+        restored = restoreChange(txnChanges[i]) && restored;
+    }
+    txnChanges.resize(savepoint);
+    return restored;
+}
+
+//----------------------------------------------------------------------------
+void logRecordWrite(const string& dataFile, long long offset, const void* data, size_t bytes){
+//Description: Logs the new bytes and the bytes they replace (or the prior
+//             file size, for an append).
+    logChange(walWriteRecord, dataFile, offset, static_cast<const char*>(data), bytes, true);
+}
+
+//----------------------------------------------------------------------------
+void logFileTruncate(const string& dataFile, long long newSize){
+//Description: Logs a truncate along with the tail it removes.
+    logChange(walTruncateRecord, dataFile, newSize, "", 0, true);
+}
+
+//----------------------------------------------------------------------------
+bool abortWalTransaction(){
+//Description: Rolls back to the savepoint of the innermost level, then
+//             closes that level like a commit. The outermost level still
+//             writes its commit record, covering the changes and restores.
+    if (transactionDepth == 0) return false;
+    bool restored = rollBackTo(savepoints.back());
+    commitWalTransaction();
+    return restored;
+}
+
+//----------------------------------------------------------------------------
+bool commitWalTransaction(){
+//Description: Writes the commit record for the outermost transaction and
+//             syncs the log according to the durability level.
+    if (transactionDepth == 0) return true;
+    savepoints.pop_back();
+    if (--transactionDepth > 0) return true;
+    txnChanges.clear();
+    if (walFd < 0 || txnRecords == 0) return true;  //Nothing was written
+
+    string record;
+    putValue(record, walCommitRecord);
+    putValue(record, currentTxn);
+    putValue(record, txnChecksum);
+    pending += record;
+    currentTxn = 0;
+
+    bool ok = true;
+    if (durability != walNone || pending.size() >= walNoneBufferBytes) ok = writePending();
+    if (durability == walFsync){
+        syncLog();
+    } else if (durability == walGroupFsync && ++unsyncedCommits >= groupCommitSize){
+        queueGroupSync();
+    }
+    if (walBytes >= walCheckpointBytes) checkpoint(false);  //Retried at the next commit if busy
+    return ok;
+}
+
+#else
+
+//----------------------------------------------------------------------------
+int replayWriteAheadLog(const string&){
+//Description: Logging is not supported on this platform.
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+bool openWriteAheadLog(const string&){
+//Description: Logging is not supported on this platform.
+    return false;
+}
+
+//----------------------------------------------------------------------------
+void closeWriteAheadLog(){
+//Description: Nothing to close on this platform.
+}
+
+//----------------------------------------------------------------------------
+void logRecordWrite(const string&, long long, const void*, size_t){
+//Description: Logging is not supported on this platform.
+}
+
+//----------------------------------------------------------------------------
+void logFileTruncate(const string&, long long){
+//Description: Logging is not supported on this platform.
+}
+
+//----------------------------------------------------------------------------
+bool commitWalTransaction(){
+//Description: Closes the transaction nesting; nothing is logged.
+    if (transactionDepth == 0) return true;
+    savepoints.pop_back();
+    --transactionDepth;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool abortWalTransaction(){
+//Description: Nothing was kept to roll back with on this platform.
+    if (transactionDepth > 0) commitWalTransaction();
+    return false;
+}
+
+#endif
+
+//----------------------------------------------------------------------------
+void beginWalTransaction(){
+//Description: Opens a transaction, or nests inside the open one; either
+//             way marks the savepoint an abort of this level returns to.
+    savepoints.push_back(txnChanges.size());
+    if (transactionDepth++ > 0) return;
+    currentTxn = nextTxn++;
+    txnChecksum = 2166136261u;
+    txnRecords = 0;
+}
+
+//----------------------------------------------------------------------------
+unsigned int getWalTransactionId(){
+//Description: Returns the id of the open transaction, 0 outside one.
+    return transactionDepth > 0 ? currentTxn : 0;
+}
+
+//----------------------------------------------------------------------------
+void setWalDurability(WalDurability level){
+//Description: Selects when commits are forced to stable storage.
+    durability = level;
+}
+
+//----------------------------------------------------------------------------
+void setGroupCommitSize(int commits){
+//Description: Sets how many commits share one fdatasync.
+    groupCommitSize = commits < 1 ? 1 : commits;
+}
@@ -0,0 +1,144 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: WriteAheadLog.h
+// Rev.5 - 18/10/2026 - One log slot per running process; recovery of dead logs only.
+// Rev.4 - 18/10/2026 - Added abortWalTransaction.
+// Rev.3 - 17/10/2026 - Group-commit syncs may run asynchronously.
+// Rev.2 - 17/10/2026 - Added getWalTransactionId.
+// Rev.1 - 17/10/2026 - Write-ahead log with group commit across the data files.
+//
+// ----------------------------------------------------------------------------
+// This header declares the write-ahead log (WAL) that makes each logical
+// operation (a booking, a check-in, a cancellation, a sailing delete) atomic
+// across booking.txt, sailing.txt, vehicle.txt and vessel.txt.
+//
+// The FileIO modules report every record write and truncate to the log before
+// applying it. The writes of one operation are grouped into a transaction by
+// beginWalTransaction/commitWalTransaction; writes made outside a transaction
+// commit on their own. A workflow that fails part way calls
+// abortWalTransaction instead, which puts back everything written since
+// its beginWalTransaction.
+//
+// Each running process claims its own log slot (ferryq.wal, ferryq.wal.1,
+// ...) so several instances can share the data files. On startup
+// openWriteAheadLog recovers only the logs whose owner has died: committed
+// transactions are redone in time order and unfinished ones are rolled back.
+//
+// The durability level decides when a commit reaches stable storage:
+//   walNone       - log records are buffered in memory; no crash protection
+//   walFlush      - records reach the OS before the data write (survives a
+//                   program crash, not a power failure)
+//   walFsync      - as walFlush, plus fdatasync of the log on every commit
+//   walGroupFsync - as walFlush, plus one fdatasync per group of commits;
+//                   with io_uring the sync runs while the next group fills
+// ----------------------------------------------------------------------------
+
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include <string>
+#include <cstddef>
+using namespace std;
+
+enum WalDurability{
+    walNone,
+    walFlush,
+    walFsync,
+    walGroupFsync
+};
+
+const string fileNameWal = "ferryq.wal";           //Log file name
+const int defaultGroupCommitSize = 16;             //Commits per fdatasync in walGroupFsync
+const long long walCheckpointBytes = 1024 * 1024;  //Log size that triggers a checkpoint
+const int walMaxLogs = 32;                         //Log slots, one per running process
+
+//----------------------------------------------------------------------------
+bool openWriteAheadLog(const string& logFileName//input
+                       );
+//Job: Recovers the logs left by processes that died, then claims a free log
+//     slot (logFileName, or logFileName.N while others run) for appending.
+//Usage: Called by main before the data files are opened.
+//Restrictions: Logs of running processes are left alone. Returns false
+//              (logging stays off) if the log cannot be opened or all
+//              walMaxLogs slots are in use.
+
+//----------------------------------------------------------------------------
+void closeWriteAheadLog();
+//Job: Syncs the data files, empties this process's log and closes it.
+//Usage: Called by main on a clean shutdown.
+//Restrictions: Any open transaction is committed first. Waits for the
+//              shared locks the checkpoint needs on the data files.
+
+//----------------------------------------------------------------------------
+void setWalDurability(WalDurability level//input
+                      );
+//Job: Selects when commits are forced to stable storage.
+//Usage: Called at startup; walGroupFsync is the default.
+//Restrictions: None.
+
+//----------------------------------------------------------------------------
+void setGroupCommitSize(int commits//input
+                        );
+//Job: Sets how many commits share one fdatasync under walGroupFsync.
+//Usage: Larger groups give more throughput but risk more recent commits.
+//Restrictions: Values below 1 are treated as 1.
+
+//----------------------------------------------------------------------------
+void beginWalTransaction();
+//Job: Starts grouping the following writes into one atomic operation.
+//Usage: Called by UserIO workflows that change more than one record.
+//Restrictions: May be nested; only the outermost commit ends the transaction.
+
+//----------------------------------------------------------------------------
+bool commitWalTransaction();
+//Job: Ends the current transaction and applies the durability level.
+//Usage: Paired with beginWalTransaction.
+//Restrictions: Returns false if the commit could not be written to the log.
+
+//----------------------------------------------------------------------------
+bool abortWalTransaction();
+//Job: Rolls back every write made since the matching beginWalTransaction
+//     and ends that level of the transaction.
+//Usage: Called instead of commitWalTransaction when a step of the operation
+//       failed, so none of it stays in the files.
+//Restrictions: Works with the log off too. A nested abort only undoes its
+//              own level; the enclosing transaction goes on. In-memory
+//              indexes over the restored files must be rebuilt by the
+//              caller. Returns false if a restore could not be written.
+
+//----------------------------------------------------------------------------
+unsigned int getWalTransactionId();
+//Job: Returns the id of the open transaction, or 0 when none is open.
+//Usage: Lets a module tell whether buffered writes belong to the open
+//       transaction (e.g. before flushing the LSM booking memtable).
+//Restrictions: Ids are unique within one log, not across processes.
+
+//----------------------------------------------------------------------------
+void logRecordWrite(const string& dataFile,  //input
+                    long long offset,        //input
+                    const void* data,        //input
+                    size_t bytes             //input
+                    );
+//Job: Logs a write to a data file (redo and undo images) before it happens.
+//Usage: Called by the FileIO modules immediately before each record write.
+//Restrictions: Outside a transaction, no effect unless the log is open.
+
+//----------------------------------------------------------------------------
+void logFileTruncate(const string& dataFile, //input
+                     long long newSize       //input
+                     );
+//Job: Logs a truncate of a data file, keeping the removed tail for undo.
+//Usage: Called by the FileIO modules immediately before truncate().
+//Restrictions: Outside a transaction, no effect unless the log is open.
+
+//----------------------------------------------------------------------------
+int replayWriteAheadLog(const string& logFileName//input
+                        );
+//Job: Applies one log to the data files: redoes committed transactions in
+//     order and rolls back unfinished ones.
+//Usage: Usable on its own for recovery tools; openWriteAheadLog recovers
+//       the dead logs of all slots together.
+//Restrictions: The owner of the log must not be running. Returns the
+//              number of committed transactions replayed.
+
+#endif //WRITE_AHEAD_LOG_H
@@ -1,6 +1,26 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: main.cpp
+// Rev.13 - 18/10/2026 - Stops if the hash or LSM booking store is in use by
+//                       another process.
+// Rev.12 - 18/10/2026 - Stops if the sailing index cannot be built.
+// Rev.11 - 18/10/2026 - Refuses booking and sailing files without the header
+//                       of the current record layout.
+// Rev.10 - 17/10/2026 - "--scan-threads=N" sets the worker threads of parallel scans.
+// Rev.9 - 17/10/2026 - "--record-store=stream" reads records with positional
+//                      reads instead of mappings; "--sync-io" turns off the
+//                      io_uring backend used by those scans and the log.
+// Rev.8 - 17/10/2026 - "--serve[=socket]" runs the ferryqd daemon on the open
+//                      files (also when started as "ferryqd"); "--connect[=socket]"
+//                      runs a terminal against it without opening any file.
+// Rev.7 - 17/10/2026 - "--booking-store=lsm" selects the LSM booking engine;
+//                      the booking store is closed before the files.
+// Rev.6 - 17/10/2026 - "--booking-store=hash" selects the on-disk hash table
+//                      as the booking storage engine.
+// Rev.5 - 17/10/2026 - Opens (and recovers from) the write-ahead log before the
+//                      data files, and checkpoints it on shutdown.
+// Rev.4 - 17/10/2026 - Builds the booking and sailing indexes, the vehicle
+//                      cache and the vessel catalog once the files are open.
 // Rev.3 - 05/08/2025 - FerryQ now clears the terminal before launching
 // Rev.2 - 24/07/2025 - main now opens all the files and calls the main UI loop.
 // Rev.1 - 09/07/2025 - Main module created
@@ -10,8 +30,15 @@
 //
 // What it does:
 // - Initializes all fstream objects for binary file I/O.
+// - Replays the write-ahead log so the data files reflect every committed
+//   operation, then keeps it open for the session.
 // - Creates the data files (.txt) if they do not already exist.
-// - Launches the main user interface loop, passing the open file streams.
+// - Refuses booking and sailing files written in an older record layout.
+// - Refuses a hash or LSM booking store that another process has open.
+// - Builds the in-memory lookup indexes and caches over the data files.
+// - Launches the main user interface loop, passing the open file streams,
+//   or serves other terminals as the ferryqd daemon.
+// - As a terminal of a running daemon, opens no file and runs the client menus.
 // - Handles the final closing of all file streams upon program termination.
 //
 // Used By: This module is called by the operating system to start the program.
@@ -19,24 +46,113 @@
 
 #include "UserInterface.h"
 #include "VesselUserIO.h"
+#include "VesselFileIO.h"
 #include "VehicleFileIO.h"
 #include "BookingUserIO.h"
+#include "BookingFileIO.h"
 #include "SailingUserIO.h"
+#include "SailingFileIO.h"
+#include "WriteAheadLog.h"
+#include "RecordStore.h"
+#include "IoRing.h"
+#include "FerryServer.h"
+#include "FerryClient.h"
+#include "FerryProtocol.h"
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <cstdlib>
 using namespace std;
 
 
 //--------------------------------------------------------------------------
-int main(){
+int main(int argc, char* argv[]){
 //Job: Entry point of the FerryQ system. Initializes all binary file streams,
 //     creates them if missing, then launches the main user interface loop.
 //Usage: Called when the FerryQ program is executed. Ensures all required
-//       system data files exist and are opened correctly.
+//       system data files exist and are opened correctly. Accepts
+//       "--booking-store=hash" to keep bookings in the hash store, or
+//       "--booking-store=lsm" for the write-optimized LSM store.
+//       "--serve[=socket]" (implied when run as "ferryqd") serves terminals
+//       on a Unix-domain socket with "--workers=N" threads; "--connect[=socket]"
+//       runs this terminal against such a server. "--record-store=stream"
+//       scans with read-ahead block reads instead of mappings, and
+//       "--sync-io" keeps all I/O synchronous. "--scan-threads=N" caps the
+//       threads of whole-file scans (default: one per core).
 //Restrictions: Files must be accessible for read/write in binary mode.
-    system("cls");
+    string program = argc > 0 ? argv[0] : "";
+    size_t slash = program.find_last_of("/\\");
+    if (slash != string::npos) program = program.substr(slash + 1);
+    bool serve = (program == "ferryqd");
+    bool connectOnly = false;
+    string socketPath = defaultFerrySocket;
+    int workers = defaultFerryWorkers;
+
+    for (int i = 1; i < argc; ++i){
+        string arg = argv[i];
+        if (arg == "--serve" || arg.compare(0, 8, "--serve=") == 0){
+            serve = true;
+            if (arg.size() > 8) socketPath = arg.substr(8);
+        } else if (arg == "--connect" || arg.compare(0, 10, "--connect=") == 0){
+            connectOnly = true;
+            if (arg.size() > 10) socketPath = arg.substr(10);
+        } else if (arg.compare(0, 10, "--workers=") == 0){
+            workers = atoi(arg.substr(10).c_str());
+            if (workers < 1){
+                cerr << "Bad option: " << arg << endl;
+                return 1;
+            }
+        } else if (arg == "--booking-store=hash"){
+            setBookingStoreEngine(hashBookingStore);
+        } else if (arg == "--booking-store=lsm"){
+            setBookingStoreEngine(lsmBookingStore);
+        } else if (arg == "--booking-store=heap"){
+            setBookingStoreEngine(heapBookingStore);
+        } else if (arg == "--record-store=stream"){
+            setRecordStoreMode(streamRecordStore);
+        } else if (arg == "--record-store=mapped"){
+            setRecordStoreMode(mappedRecordStore);
+        } else if (arg == "--sync-io"){
+            setAsyncIoEnabled(false);
+        } else if (arg.compare(0, 15, "--scan-threads=") == 0){
+            int threads = atoi(arg.substr(15).c_str());
+            if (threads < 1){
+                cerr << "Bad option: " << arg << endl;
+                return 1;
+            }
+            setScanThreads(threads);
+        } else{
+            cerr << "Unknown option: " << arg << endl;
+            return 1;
+        }
+    }
+
+    if (serve && connectOnly){
+        cerr << "Error: --serve and --connect cannot be combined." << endl;
+        return 1;
+    }
+
+    //A terminal of a running server never touches the data files
+    if (connectOnly){
+        FerryClient client;
+        if (!client.connectTo(socketPath)){
+            cerr << "Error: no FerryQ server is listening on " << socketPath << "." << endl;
+            return 1;
+        }
+        system("cls");
+        cout << "Welcome to the FerryQ!!!" << endl << endl;
+        clientInterfaceLoop(client);
+        return 0;
+    }
+
+    if (!serve) system("cls");
     cout << "Welcome to the FerryQ!!!" << endl << endl;
 
+    //Recover any operation interrupted by a crash, then log all writes
+    if (!openWriteAheadLog(fileNameWal)){
+        cerr << "Warning: write-ahead log unavailable; changes are not crash-safe." << endl;
+    }
+
     //Open all system files or create if missing
     fstream vesselFile(fileNameVessel, ios::in | ios::out | ios::binary);
     if (!vesselFile){
@@ -50,10 +166,11 @@ int main(){
         vehicleFile.open(fileNameVehicle, ios::in | ios::out | ios::binary);
     }
 
-    fstream bookingFile(fileNameBooking, ios::in | ios::out | ios::binary);
+    const string bookingFileName = getBookingFileName();
+    fstream bookingFile(bookingFileName, ios::in | ios::out | ios::binary);
     if (!bookingFile){
-        ofstream tmp(fileNameBooking, ios::binary); tmp.close();
-        bookingFile.open(fileNameBooking, ios::in | ios::out | ios::binary);
+        ofstream tmp(bookingFileName, ios::binary); tmp.close();
+        bookingFile.open(bookingFileName, ios::in | ios::out | ios::binary);
     }
 
     fstream sailingFile(fileNameSailing, ios::in | ios::out | ios::binary);
@@ -67,17 +184,54 @@ int main(){
         return 1;
     }
 
-    //Launch main interface
+    //The hash and LSM engines serve one process at a time
+    if (!claimBookingStore()){
+        cerr << "Error: " << bookingFileName << " is in use by another FerryQ process; the hash and LSM"
+             << " booking stores serve one process at a time (use --booking-store=heap or the daemon)." << endl;
+        return 1;
+    }
 
-    userInterfaceLoop(vesselFile, vehicleFile, bookingFile, sailingFile);
+    //Refuse files written in an older record layout rather than misread them
+    if (!checkSailingFileFormat()){
+        cerr << "Error: " << fileNameSailing << " was written by an older FerryQ (or is not a sailing file)." << endl;
+        return 1;
+    }
+    if (!checkBookingFileFormat()){
+        cerr << "Error: " << bookingFileName << " was written by an older FerryQ (or is not a booking file)." << endl;
+        return 1;
+    }
+
+    //Build lookup indexes so gate transactions don't scan the files
+    if (!buildBookingIndex(bookingFile)){
+        cerr << "Error: " << bookingFileName << " is not a valid booking file." << endl;
+        return 1;
+    }
+    if (!buildSailingIndex(sailingFile)){
+        cerr << "Error: " << fileNameSailing << " is not a valid sailing file." << endl;
+        return 1;
+    }
+    loadVehicleCache(vehicleFile);
+    getVesselCatalog(vesselFile);
+
+    //Launch main interface, or serve the terminals until stopped
+    bool ok = true;
+    if (serve){
+        cout << "Serving terminals on " << socketPath << " with " << workers << " workers." << endl;
+        ok = runFerryServer(socketPath, workers, vesselFile, vehicleFile, bookingFile, sailingFile);
+        if (ok) cout << "Server stopped." << endl;
+    } else{
+        userInterfaceLoop(vesselFile, vehicleFile, bookingFile, sailingFile);
+    }
 
     //Final cleanup
+    closeBookingStore(bookingFile);
     vesselFile.close();
     vehicleFile.close();
     bookingFile.close();
     sailingFile.close();
+    closeWriteAheadLog();
 
-    return 0;
+    return ok ? 0 : 1;
 }
 
 /*                      CODING CONVENTIONS:
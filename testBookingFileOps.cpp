@@ -0,0 +1,271 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testBookingFileOps.cpp
+// Rev.9 - 18/10/2026 - Mapped reads checked from several threads while the
+//                      file is replaced under them
+// Rev.8 - 18/10/2026 - Compaction checked to count tombstones the index missed
+// Rev.7 - 18/10/2026 - Files without the format header checked to be refused,
+//                      and not indexed
+// Rev.6 - 17/10/2026 - Positional reads checked from several threads at once
+// Rev.5 - 17/10/2026 - markCheckedIn checked to update the flag in place
+// Rev.4 - 17/10/2026 - Posting lists checked to follow records moved by compaction
+// Rev.3 - 17/10/2026 - Deletes checked as tombstones, then reclaimed by compaction
+// Rev.2 - 17/10/2026 - Bulk delete now checked with survivors around the matches
+// Rev.1 - 17/10/2026 - Implemented a test driver for booking file IO
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for booking file IO, covering the
+// key index across appends, tombstone deletes and compaction, under both
+// the mapped and the fstream record store, and the format header check.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include "BookingFileIO.h"
+#include "RecordStore.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+static int countSlots(fstream& file){
+//Description: Returns the number of record slots in the file, tombstones included.
+    file.clear();
+    file.seekg(0, ios::end);
+    long long bytes = static_cast<long long>(file.tellg()) - recordFileHeaderBytes;
+    return bytes < 0 ? 0 : static_cast<int>(bytes / static_cast<long long>(sizeof(Booking)));
+}
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    // Open (and truncate) the booking file
+    fstream file(fileNameBooking, ios::binary | ios::in | ios::out | ios::trunc);
+    if (!file) {
+        cerr << "Error: Unable to open " << fileNameBooking << endl;
+        return 1;
+    }
+
+    bool pass = true;
+    setCompactionThreshold(1.0f);  //Keep tombstones until compacted explicitly
+
+    // A file in the layout from before the format header is refused
+    {
+        Booking old("OLD111", "TSA-12-08", "6045551234", false);
+        ofstream out(fileNameBooking.c_str(), ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char*>(&old), sizeof(old));
+    }
+    if (checkBookingFileFormat() || buildBookingIndex(file)) {
+        cerr << "Error: a booking file without the format header was accepted" << endl;
+        pass = false;
+    }
+    { ofstream reset(fileNameBooking.c_str(), ios::binary | ios::trunc); }
+    buildBookingIndex(file);
+
+    // Write three bookings, two on the same sailing
+    Booking b1("ABC123", "TSA-12-08", "6045551234", false);
+    Booking b2("XYZ789", "TSA-12-08", "6045550000", false);
+    Booking b3("ABC123", "TSA-13-09", "6045551234", false);
+    if (!writeBooking(b1, file) || !writeBooking(b2, file) || !writeBooking(b3, file)) {
+        cerr << "Error: writeBooking failed" << endl;
+        pass = false;
+    }
+
+    // The first booking gave the empty file its header
+    file.clear();
+    file.seekg(0, ios::end);
+    if (!checkBookingFileFormat() || static_cast<long long>(file.tellg()) != recordFileHeaderBytes + 3 * static_cast<long long>(sizeof(Booking))) {
+        cerr << "Error: the booking file did not get its format header" << endl;
+        pass = false;
+    }
+
+    // Test lookups by composite key
+    Booking found;
+    if (!loadBookingByKey("TSA-13-09", "ABC123", found, file) || found.getSailingID() != "TSA-13-09") {
+        cerr << "Error: booking ABC123 on TSA-13-09 not found" << endl;
+        pass = false;
+    }
+    if (loadBookingByKey("TSA-13-09", "XYZ789", found, file)) {
+        cerr << "Error: found a booking that should not exist" << endl;
+        pass = false;
+    }
+    if (countBookingsForSailing("TSA-12-08", file) != 2) {
+        cerr << "Error: expected 2 bookings on TSA-12-08" << endl;
+        pass = false;
+    }
+
+    // Delete the first record; it stays in the file as a tombstone
+    if (!deleteBookingRecord("TSA-12-08", "ABC123", file)) {
+        cerr << "Error: deleteBookingRecord failed" << endl;
+        pass = false;
+    }
+    if (loadBookingByKey("TSA-12-08", "ABC123", found, file)) {
+        cerr << "Error: deleted booking is still found" << endl;
+        pass = false;
+    }
+    if (!loadBookingByKey("TSA-13-09", "ABC123", found, file) ||
+        !loadBookingByKey("TSA-12-08", "XYZ789", found, file)) {
+        cerr << "Error: remaining bookings not found after delete" << endl;
+        pass = false;
+    }
+    if (countBookingRecords(file) != 2 || countSlots(file) != 3) {
+        cerr << "Error: expected 2 live records in 3 slots after delete" << endl;
+        pass = false;
+    }
+
+    // Remove every booking on a sailing, with survivors on both sides
+    Booking b4("LMN456", "TSA-12-08", "6045559999", false);
+    Booking b5("QRS111", "TSA-14-10", "6045558888", false);
+    writeBooking(b4, file);
+    writeBooking(b5, file);
+    if (deleteBookingsBySailingID(file, "TSA-12-08") != 2 ||
+        !loadBookingByKey("TSA-14-10", "QRS111", found, file)) {
+        cerr << "Error: deleteBookingsBySailingID removed the wrong bookings" << endl;
+        pass = false;
+    }
+    if (countBookingsForSailing("TSA-12-08", file) != 0 || countBookingRecords(file) != 2) {
+        cerr << "Error: deleteBookingsBySailingID left bookings behind" << endl;
+        pass = false;
+    } else {
+        cout << "Bookings for TSA-12-08 removed, " << countBookingRecords(file) << " record(s) left" << endl;
+    }
+
+    // Compaction reclaims the three tombstones and keeps the index correct
+    if (!compactBookingFile(file) || countSlots(file) != 2 ||
+        !loadBookingByKey("TSA-14-10", "QRS111", found, file) ||
+        !loadBookingByKey("TSA-13-09", "ABC123", found, file)) {
+        cerr << "Error: compaction lost a live booking or left tombstones" << endl;
+        pass = false;
+    }
+    vector<Booking> onSailing;
+    if (!loadBookingsForSailing("TSA-14-10", onSailing, file) || onSailing.size() != 1 ||
+        onSailing[0].getLicensePlate() != "QRS111" || countBookingsForSailing("TSA-13-09", file) != 1) {
+        cerr << "Error: sailing posting lists out of step after compaction" << endl;
+        pass = false;
+    }
+
+    // A tombstone written by another process that has not bumped the
+    // generation yet is found by compaction's own count under its lock
+    Booking b6("DEF222", "TSA-15-11", "6045557777", false);
+    writeBooking(b6, file);
+    {
+        Booking dead = b6;
+        dead.setDeleted(true);
+        fstream other(fileNameBooking.c_str(), ios::binary | ios::in | ios::out);
+        other.seekp(recordFileHeaderBytes + 2 * static_cast<long long>(sizeof(Booking)));
+        other.write(reinterpret_cast<const char*>(&dead), sizeof(dead));
+    }
+    if (!compactBookingFile(file) || countSlots(file) != 2 || countBookingRecords(file) != 2 ||
+        countBookingsForSailing("TSA-15-11", file) != 0 || loadBookingByKey("TSA-15-11", "DEF222", found, file)) {
+        cerr << "Error: compaction missed a tombstone the index did not know of" << endl;
+        pass = false;
+    }
+    setCompactionThreshold(defaultCompactionThreshold);
+
+    // Check-in flips the flag in place: same slot count, same position
+    int slotsBefore = countSlots(file);
+    vector<Booking> before;
+    loadBookingsForSailing("TSA-13-09", before, file);
+    if (!markCheckedIn("TSA-13-09", "ABC123", file) || countSlots(file) != slotsBefore ||
+        !loadBookingByKey("TSA-13-09", "ABC123", found, file) || !found.getCheckedIn() ||
+        found.getPhoneNumber() != before[0].getPhoneNumber() || markCheckedIn("TSA-13-09", "NOPE99", file)) {
+        cerr << "Error: markCheckedIn did not update the record in place" << endl;
+        pass = false;
+    }
+
+    // Threads read the file through one PositionalFile at once; with no
+    // shared cursor every read lands on the record it asked for
+    {
+        PositionalFile positional(fileNameBooking, recordFileHeaderBytes);
+        MappedRecordFile<Booking> unusedView(fileNameBooking, recordFileHeaderBytes);
+        setRecordStoreMode(streamRecordStore);
+        int slots = countSlots(file);
+        vector<Booking> expected(slots);
+        for (int i = 0; i < slots; ++i) readRecordAt(positional, unusedView, i, expected[i]);
+        atomic<int> mismatches(0);
+        vector<thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.push_back(thread([&, t]() {
+                for (int round = 0; round < 2000; ++round) {
+                    int index = (round + t) % slots;
+                    Booking got;
+                    if (!readRecordAt(positional, unusedView, index, got) ||
+                        got.getLicensePlate() != expected[index].getLicensePlate() ||
+                        got.getSailingID() != expected[index].getSailingID()) ++mismatches;
+                    int seen = 0;
+                    scanRecords(positional, unusedView, [&](const Booking&, int) { ++seen; return true; });
+                    if (seen != slots) ++mismatches;
+                }
+            }));
+        }
+        for (size_t t = 0; t < readers.size(); ++t) readers[t].join();
+        setRecordStoreMode(mappedRecordStore);
+        if (mismatches != 0 || positional.size() != static_cast<long long>(slots) * static_cast<long long>(sizeof(Booking))) {
+            cerr << "Error: concurrent positional reads disagreed with the file" << endl;
+            pass = false;
+        }
+    }
+
+    // Threads read through one mapping while another replaces the file; a
+    // refresh maps the new file and the old mapping outlives its readers
+    {
+        const string viewName = "testMappedViews.dat";
+        const int records = 2000;
+        vector<Booking> expected;
+        for (int i = 0; i < records; ++i) expected.push_back(Booking("M" + to_string(i), "TSA-12-08", "6045551234", false));
+        { ofstream out(viewName.c_str(), ios::binary | ios::trunc); out.write(reinterpret_cast<const char*>(&expected[0]), records * sizeof(Booking)); }
+        PositionalFile positional(viewName);
+        MappedRecordFile<Booking> mapped(viewName);
+        atomic<bool> replacing(true);
+        atomic<int> mismatches(0);
+        vector<thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.push_back(thread([&, t]() {
+                for (int index = t; replacing; index = (index + 7) % records) {
+                    Booking got;
+                    if (!readRecordAt(positional, mapped, index, got) ||
+                        got.getLicensePlate() != expected[index].getLicensePlate()) ++mismatches;
+                    int seen = 0;
+                    scanRecords(positional, mapped, [&](const Booking& temp, int at) {
+                        if (temp.hasLicensePlate(expected[at].getLicensePlate())) ++seen;
+                        return true;
+                    });
+                    if (seen != records) ++mismatches;
+                }
+            }));
+        }
+        for (int round = 0; round < 200; ++round) {
+            string next = viewName + ".next";
+            { ofstream out(next.c_str(), ios::binary | ios::trunc); out.write(reinterpret_cast<const char*>(&expected[0]), records * sizeof(Booking)); }
+            rename(next.c_str(), viewName.c_str());
+        }
+        replacing = false;
+        for (size_t t = 0; t < readers.size(); ++t) readers[t].join();
+        remove(viewName.c_str());
+        if (mismatches != 0) {
+            cerr << "Error: " << mismatches << " mapped reads went wrong while the file was replaced" << endl;
+            pass = false;
+        }
+    }
+
+    // The positional read path must agree with the mapped one
+    setRecordStoreMode(streamRecordStore);
+    buildBookingIndex(file);
+    if (!loadBookingByKey("TSA-14-10", "QRS111", found, file) || countBookingsForSailing("TSA-13-09", file) != 1) {
+        cerr << "Error: stream record store disagrees with mapped store" << endl;
+        pass = false;
+    }
+    setRecordStoreMode(mappedRecordStore);
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,136 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testBookingHashStore.cpp
+// Rev.2 - 18/10/2026 - Checks the resize is spread over later writes and that
+//                      a stored key is refused
+// Rev.1 - 17/10/2026 - Implemented a test driver for the hash booking engine
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for the on-disk hash table engine,
+// used through the BookingFileIO.h functions: inserts past the first
+// resize (which must still be under way, with every key found, a few
+// inserts after it starts), refused duplicate keys, in-place check-ins and
+// deletes, reopening, and per-sailing deletes.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "BookingFileIO.h"
+#include "BookingHashStore.h"
+#include "RecordStore.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+static string plateFor(int i){
+//Description: Builds a distinct license plate for test booking i.
+    return "P" + to_string(i);
+}
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    setBookingStoreEngine(hashBookingStore);
+    { ofstream reset(getBookingFileName().c_str(), ios::binary | ios::trunc); }
+    fstream file(getBookingFileName(), ios::binary | ios::in | ios::out);
+    if (!file || !buildBookingIndex(file)) {
+        cerr << "Error: Unable to open " << getBookingFileName() << endl;
+        return 1;
+    }
+
+    bool pass = true;
+    const int total = 3000;  //Well past the first resize at 512 records
+    const int midResize = hashStoreInitialBuckets / 2 + 8;  //A few inserts after the first resize starts
+    PositionalFile raw(getBookingFileName());
+
+    // Insert bookings spread over two sailings
+    for (int i = 0; i < total; ++i) {
+        Booking b(plateFor(i), i % 2 == 0 ? "TSA-12-08" : "TSA-13-09", "6045551234", false);
+        if (!writeBooking(b, file)) {
+            cerr << "Error: writeBooking failed at " << i << endl;
+            pass = false;
+            break;
+        }
+        if (i + 1 != midResize) continue;
+        BookingHashHeader header;
+        raw.readAt(0, &header, sizeof(header));
+        int missing = 0;
+        Booking found;
+        for (int j = 0; j < midResize; ++j) {
+            if (!loadBookingByKey(j % 2 == 0 ? "TSA-12-08" : "TSA-13-09", plateFor(j), found, file)) ++missing;
+        }
+        if (header.nextBuckets != 2 * hashStoreInitialBuckets || header.migrated == 0 ||
+            header.migrated >= header.bucketCount || missing != 0) {
+            cerr << "Error: resize not spread over the inserts (" << header.migrated << " of "
+                 << header.bucketCount << " buckets moved, " << missing << " keys lost)" << endl;
+            pass = false;
+        }
+    }
+    if (countBookingRecords(file) != total || countBookingsForSailing("TSA-12-08", file) != total / 2) {
+        cerr << "Error: wrong counts after inserts" << endl;
+        pass = false;
+    }
+
+    // Every key is found after the table has grown
+    Booking found;
+    for (int i = 0; i < total; ++i) {
+        if (!loadBookingByKey(i % 2 == 0 ? "TSA-12-08" : "TSA-13-09", plateFor(i), found, file)) {
+            cerr << "Error: booking " << plateFor(i) << " lost after resize" << endl;
+            pass = false;
+            break;
+        }
+    }
+
+    // A stored key is refused; a check-in updates in place. Then delete and
+    // check the probe chain still works
+    Booking updated(plateFor(1), "TSA-13-09", "6045550000", true);
+    if (writeBooking(updated, file) || !loadBookingByKey("TSA-13-09", plateFor(1), found, file) ||
+        found.getCheckedIn()) {
+        cerr << "Error: writeBooking replaced a stored booking" << endl;
+        pass = false;
+    }
+    if (!markCheckedIn("TSA-13-09", plateFor(1), file) ||
+        !loadBookingByKey("TSA-13-09", plateFor(1), found, file) || !found.getCheckedIn() ||
+        countBookingRecords(file) != total) {
+        cerr << "Error: in-place check-in failed" << endl;
+        pass = false;
+    }
+    for (int i = 0; i < total; i += 3) {
+        deleteBookingRecord(i % 2 == 0 ? "TSA-12-08" : "TSA-13-09", plateFor(i), file);
+    }
+    if (loadBookingByKey("TSA-12-08", plateFor(0), found, file) ||
+        !loadBookingByKey("TSA-13-09", plateFor(total - 1), found, file)) {
+        cerr << "Error: delete removed the wrong bookings" << endl;
+        pass = false;
+    }
+
+    // Reopening recounts the table from the file
+    int live = countBookingRecords(file);
+    file.close();
+    file.open(getBookingFileName(), ios::binary | ios::in | ios::out);
+    if (!buildBookingIndex(file) || countBookingRecords(file) != live || live != total - total / 3) {
+        cerr << "Error: counts differ after reopening" << endl;
+        pass = false;
+    }
+
+    // Remove one sailing, then compact away the tombstones
+    int removed = deleteBookingsBySailingID(file, "TSA-12-08");
+    if (removed != total / 2 - total / 6 || countBookingsForSailing("TSA-12-08", file) != 0 ||
+        !compactBookingFile(file) || countBookingRecords(file) != live - removed ||
+        !loadBookingByKey("TSA-13-09", plateFor(1), found, file)) {
+        cerr << "Error: per-sailing delete or compaction failed" << endl;
+        pass = false;
+    } else {
+        cout << removed << " bookings removed, " << countBookingRecords(file) << " left" << endl;
+    }
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
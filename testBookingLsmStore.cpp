@@ -0,0 +1,149 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testBookingLsmStore.cpp
+// Rev.2 - 18/10/2026 - A rolled-back check-in checked to leave no gap in the journal
+// Rev.1 - 17/10/2026 - Implemented a test driver for the LSM booking engine
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for the log-structured engine, used
+// through the BookingFileIO.h functions: a burst of inserts through several
+// flushes and merges, updates and deletes shadowing older runs, reopening
+// from the manifest and journal, a rolled-back check-in, and per-sailing
+// deletes with compaction.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include "BookingFileIO.h"
+#include "BookingLsmStore.h"
+#include "WriteAheadLog.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+static string plateFor(int i){
+//Description: Builds a distinct license plate for test booking i.
+    return "P" + to_string(i);
+}
+
+//----------------------------------------------------------------------------
+static string sailingFor(int i){
+//Description: Spreads the test bookings over two sailings.
+    return i % 2 == 0 ? "TSA-12-08" : "TSA-13-09";
+}
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    setBookingStoreEngine(lsmBookingStore);
+    remove(fileNameBookingLsmManifest.c_str());  //Old runs are no longer listed
+    { ofstream reset(getBookingFileName().c_str(), ios::binary | ios::trunc); }
+    fstream file(getBookingFileName(), ios::binary | ios::in | ios::out);
+    if (!file || !buildBookingIndex(file)) {
+        cerr << "Error: Unable to open " << getBookingFileName() << endl;
+        return 1;
+    }
+
+    bool pass = true;
+    const int total = 10 * lsmMemtableLimit;  //Enough flushes for a merge
+
+    // Insert a burst of bookings
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < total; ++i) {
+        Booking b(plateFor(i), sailingFor(i), "6045551234", false);
+        if (!writeBooking(b, file)) {
+            cerr << "Error: writeBooking failed at " << i << endl;
+            pass = false;
+            break;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (countBookingRecords(file) != total || countBookingsForSailing("TSA-12-08", file) != total / 2 ||
+        lsmStoreRunCount() == 0) {
+        cerr << "Error: wrong counts after inserts" << endl;
+        pass = false;
+    } else {
+        cout << total << " inserts at " << static_cast<long long>(total / seconds) << " per second, "
+             << lsmStoreRunCount() << " runs" << endl;
+    }
+
+    // Every key is found in the memtable or one of the runs
+    Booking found;
+    for (int i = 0; i < total; ++i) {
+        if (!loadBookingByKey(sailingFor(i), plateFor(i), found, file)) {
+            cerr << "Error: booking " << plateFor(i) << " lost after flush" << endl;
+            pass = false;
+            break;
+        }
+    }
+
+    // A newer copy shadows the one in an older run, and tombstones hide keys
+    Booking updated(plateFor(1), "TSA-13-09", "6045550000", true);
+    writeBooking(updated, file);
+    if (!loadBookingByKey("TSA-13-09", plateFor(1), found, file) || !found.getCheckedIn() ||
+        countBookingRecords(file) != total) {
+        cerr << "Error: update failed" << endl;
+        pass = false;
+    }
+    for (int i = 0; i < total; i += 3) {
+        deleteBookingRecord(sailingFor(i), plateFor(i), file);
+    }
+    vector<Booking> listed;
+    loadBookingsForSailing("TSA-13-09", listed, file);
+    if (loadBookingByKey("TSA-12-08", plateFor(0), found, file) ||
+        !loadBookingByKey(sailingFor(total - 2), plateFor(total - 2), found, file) ||
+        static_cast<int>(listed.size()) != countBookingsForSailing("TSA-13-09", file)) {
+        cerr << "Error: delete removed the wrong bookings" << endl;
+        pass = false;
+    }
+
+    // Reopening rebuilds the memtable and counts from the journal and runs
+    int live = countBookingRecords(file);
+    closeBookingStore(file);
+    file.close();
+    file.open(getBookingFileName(), ios::binary | ios::in | ios::out);
+    if (!buildBookingIndex(file) || countBookingRecords(file) != live || live != total - (total + 2) / 3) {
+        cerr << "Error: counts differ after reopening" << endl;
+        pass = false;
+    }
+
+    // A rolled-back check-in truncates its copy off the journal; after the
+    // store is reloaded the next append follows on with no zeroed gap
+    beginWalTransaction();
+    markCheckedIn(sailingFor(5), plateFor(5), file);
+    abortWalTransaction();
+    buildBookingIndex(file);
+    Booking late("LATE01", "TSA-13-09", "6045551234", false);
+    writeBooking(late, file);
+    buildBookingIndex(file);  //Replays the journal
+    if (countBookingRecords(file) != live + 1 || !loadBookingByKey(sailingFor(5), plateFor(5), found, file) ||
+        found.getCheckedIn() || !loadBookingByKey("TSA-13-09", "LATE01", found, file)) {
+        cerr << "Error: a rolled-back check-in left the journal out of step" << endl;
+        pass = false;
+    }
+    deleteBookingRecord("TSA-13-09", "LATE01", file);
+
+    // Remove one sailing, then merge everything into one run
+    int removed = deleteBookingsBySailingID(file, "TSA-12-08");
+    if (removed != total / 2 - (total + 5) / 6 || countBookingsForSailing("TSA-12-08", file) != 0 ||
+        !compactBookingFile(file) || lsmStoreRunCount() != 1 || countBookingRecords(file) != live - removed ||
+        !loadBookingByKey("TSA-13-09", plateFor(1), found, file)) {
+        cerr << "Error: per-sailing delete or compaction failed" << endl;
+        pass = false;
+    } else {
+        cout << removed << " bookings removed, " << countBookingRecords(file) << " left" << endl;
+    }
+    closeBookingStore(file);
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
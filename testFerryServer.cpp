@@ -0,0 +1,207 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testFerryServer.cpp
+// Rev.2 - 18/10/2026 - Vehicle and fare lookups checked while the bookings
+//                      are being made
+// Rev.1 - 17/10/2026 - Implemented a test driver for the ferryqd daemon
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for the ferryqd server: eight terminals
+// book the same sailing at once over the socket until it is full, while
+// two more look vehicles and fares up, then
+// queries, check-in, cancellation and the report are checked against what
+// was booked.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include "FerryServer.h"
+#include "FerryClient.h"
+#include "FerryProtocol.h"
+#include "BookingFileIO.h"
+#include "SailingFileIO.h"
+#include "VehicleFileIO.h"
+#include "VesselUserIO.h"
+
+using namespace std;
+
+const string testSocket = "testFerryServer.sock";
+
+//----------------------------------------------------------------------------
+static fstream openEmpty(const string& name){
+//Description: Truncates a data file and opens it for read/write.
+    { ofstream reset(name.c_str(), ios::binary | ios::trunc); }
+    return fstream(name.c_str(), ios::binary | ios::in | ios::out);
+}
+
+//----------------------------------------------------------------------------
+static bool connectWhenReady(FerryClient& client){
+//Description: Retries until the server thread is listening.
+    for (int i = 0; i < 200; ++i){
+        if (client.connectTo(testSocket)) return true;
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------
+static bool send(FerryClient& client, const string& line, vector<string>& reply,
+                 vector<vector<string> >* rows = NULL){
+//Description: Sends a request written with spaces between the fields.
+    vector<string> fields;
+    size_t start = 0;
+    while (start <= line.size()){
+        size_t space = line.find(' ', start);
+        if (space == string::npos) space = line.size();
+        fields.push_back(line.substr(start, space - start));
+        start = space + 1;
+    }
+    return client.request(fields, reply, rows) && reply[0] == ferryReplyOk;
+}
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    fstream vesselFile = openEmpty(fileNameVessel);
+    fstream vehicleFile = openEmpty(fileNameVehicle);
+    fstream bookingFile = openEmpty(fileNameBooking);
+    fstream sailingFile = openEmpty(fileNameSailing);
+    buildBookingIndex(bookingFile);
+    buildSailingIndex(sailingFile);
+    loadVehicleCache(vehicleFile);
+
+    // A sailing with 100 m in the regular lane and 20 m in the special lane
+    Sailing s;
+    s.setSailingID("TSA-12-08");
+    s.setVesselName("Queen of Test");
+    s.setCurrentCapacitySmall(100.0f);
+    s.setCurrentCapacityBig(20.0f);
+    s.setInitialCapacities(100.0f, 20.0f);
+    bool pass = appendSailingRecord(sailingFile, s);
+
+    bool served = false;
+    thread server([&]() {
+        served = runFerryServer(testSocket, 4, vesselFile, vehicleFile, bookingFile, sailingFile);
+    });
+
+    // Eight terminals book 2.5 m regular vehicles until the sailing refuses
+    const int terminals = 8;
+    atomic<int> booked(0);
+    atomic<int> refused(0);
+    atomic<int> lost(0);
+    atomic<int> badReads(0);
+    atomic<bool> booking(true);
+    vector<thread> threads;
+    vector<thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.push_back(thread([&, t]() {
+            FerryClient client;
+            if (!connectWhenReady(client)) { ++badReads; return; }
+            while (booking) {
+                vector<string> reply;
+                string plate = "T" + to_string(t) + "V0";
+                if (send(client, "VEHICLE " + plate, reply) && (reply[1] != "2.5" || reply[2] != "1.5")) ++badReads;
+                if (send(client, "FARE TSA-12-08 " + plate, reply) && reply.size() != 2) ++badReads;
+                if (!client.isConnected()) { ++badReads; return; }
+            }
+        }));
+    }
+    for (int t = 0; t < terminals; ++t) {
+        threads.push_back(thread([&, t]() {
+            FerryClient client;
+            if (!connectWhenReady(client)) { ++lost; return; }
+            for (int i = 0; i < 10; ++i) {
+                vector<string> reply;
+                string plate = "T" + to_string(t) + "V" + to_string(i);
+                if (send(client, "BOOK TSA-12-08 " + plate + " 6045551234 2.5 1.5", reply)) ++booked;
+                else if (client.isConnected()) ++refused;
+                else ++lost;
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+    booking = false;
+    for (size_t t = 0; t < readers.size(); ++t) readers[t].join();
+    if (badReads != 0) {
+        cerr << "Error: " << badReads << " vehicle or fare lookups went wrong during the bookings" << endl;
+        pass = false;
+    }
+    if (booked != 40 || refused != terminals * 10 - 40 || lost != 0) {
+        cerr << "Error: " << booked << " booked, " << refused << " refused, " << lost << " lost" << endl;
+        pass = false;
+    } else {
+        cout << booked << " bookings granted, " << refused << " refused" << endl;
+    }
+
+    FerryClient client;
+    vector<string> reply;
+    vector<vector<string> > rows;
+    if (!connectWhenReady(client)) pass = false;
+
+    // The same vehicle cannot be booked twice, nor an unknown sailing
+    if (send(client, "BOOK TSA-12-08 T0V0 6045551234 2.5 1.5", reply) ||
+        send(client, "BOOK TSA-99-99 T0V0 6045551234 2.5 1.5", reply) ||
+        send(client, "BOOK TSA-12-08 T0V0 12ab 2.5 1.5", reply) ||
+        send(client, "NOPE", reply) || !client.isConnected()) {
+        cerr << "Error: an invalid booking was accepted" << endl;
+        pass = false;
+    }
+
+    // The special lane is separate; a known vehicle keeps its dimensions
+    if (!send(client, "BOOK TSA-12-08 BIG999 6045550000 12 3", reply) || reply[1] != "special" ||
+        !send(client, "VEHICLE BIG999", reply) || reply[1] != "12" || reply[2] != "3") {
+        cerr << "Error: special booking or vehicle lookup failed" << endl;
+        pass = false;
+    }
+
+    // Query by ID and by terminal
+    if (!send(client, "QUERY TSA-12-08", reply, &rows) || rows.size() != 1 || rows[0].size() != 6 ||
+        rows[0][2] != "0" || rows[0][3] != "8" || rows[0][4] != "41" ||
+        !send(client, "QUERY TSA", reply, &rows) || rows.size() != 1 ||
+        !send(client, "QUERY XYZ", reply, &rows) || !rows.empty()) {
+        cerr << "Error: query rows are wrong" << endl;
+        pass = false;
+    }
+
+    // Fare, check-in (only once), then cancellation gives the space back
+    if (!send(client, "FARE TSA-12-08 BIG999", reply) || reply[1] != "31" ||
+        !send(client, "CHECKIN TSA-12-08 BIG999", reply) ||
+        send(client, "CHECKIN TSA-12-08 BIG999", reply) ||
+        !send(client, "CANCEL TSA-12-08 T3V1", reply) ||
+        send(client, "CANCEL TSA-12-08 T3V1", reply) ||
+        !send(client, "BOOK TSA-12-08 NEW123 6045550000 2 1", reply)) {
+        cerr << "Error: fare, check-in or cancellation failed" << endl;
+        pass = false;
+    }
+
+    // The report agrees with the bookings made
+    if (!send(client, "REPORT", reply, &rows) || rows.size() != 1 || rows[0][4] != "41" ||
+        rows[0][2] != "0.5") {
+        cerr << "Error: report rows are wrong" << endl;
+        pass = false;
+    }
+    client.disconnect();
+
+    stopFerryServer();
+    server.join();
+    Booking found;
+    if (!served || countBookingsForSailing("TSA-12-08", bookingFile) != 41 ||
+        !loadBookingByKey("TSA-12-08", "BIG999", found, bookingFile) || !found.getCheckedIn()) {
+        cerr << "Error: the booking file disagrees with the replies" << endl;
+        pass = false;
+    }
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
@@ -1,6 +1,8 @@
 // @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 //
 // MODULE NAME: testFileOps.cpp
+// Rev.2 - 17/10/2026 - Added a check that lookups still work when the
+//                      vehicle cache is smaller than the file
 // Rev.1 - 09/07/2025 - Implemented a test driver for vehicle file IO
 //
 // ----------------------------------------------------------------------------
@@ -78,6 +80,17 @@ int main() {
         cout << "getVehicleDimensions stopped successfully at EOF" << endl;
     }
 
+    // Test lookups with a cache too small to hold every vehicle
+    setVehicleCacheLimit(1);
+    loadVehicleCache(file);
+    if (!getVehicleDimensions(file, "XYZ789", length, height) || length != v2.getLength() ||
+        !isVehicleExist(file, "ABC123") || isVehicleExist(file, "MYSTERY")) {
+        cerr << "Error: lookups failed with a partial vehicle cache" << endl;
+        pass = false;
+    } else {
+        cout << "Lookups succeeded with a partial vehicle cache" << endl;
+    }
+
     // Final result
     if(pass){
         cout << "Test passed!" << endl;
@@ -0,0 +1,214 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testParallelScan.cpp
+// Rev.2 - 18/10/2026 - The booking file is written after its format header
+// Rev.1 - 17/10/2026 - Implemented a test driver for parallelScanRecords
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for the parallel scan. A file that is
+// not a whole number of chunks is aggregated with 1 to 8 threads, through
+// the mapping and through positional reads, and every result must equal
+// the one of a sequential scan. The same aggregate is then run through a
+// snapshot while another thread rewrites the file; the workers must see the
+// snapshot's version. Finally the booking totals of the report engine are
+// checked on a booking file large enough to be split.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include "BookingFileIO.h"
+#include "RecordStore.h"
+
+using namespace std;
+
+//A 24-byte record, numbered in file order
+struct TestRecord{
+    int index;
+    int group;
+    long long value;
+    int dead;
+    int fill;
+};
+
+//What the test aggregates: a sum, a count per group and the dead indexes
+struct ScanTotals{
+    ScanTotals() : records(0), sum(0){}
+    long long records;
+    long long sum;
+    unordered_map<int, long long> groups;
+    vector<int> dead;
+};
+
+const int records = 5 * parallelScanChunkRecords + 123;  //Several chunks, the last one short
+
+//----------------------------------------------------------------------------
+static TestRecord makeRecord(int index, long long generation){
+//Description: Builds record index of the given generation.
+    TestRecord record;
+    memset(&record, 0, sizeof(record));
+    record.index = index;
+    record.group = index % 7;
+    record.value = generation * 1000003LL + index;
+    record.dead = (index % 11 == 0);
+    return record;
+}
+
+//----------------------------------------------------------------------------
+static ScanTotals parallelTotals(PositionalFile& file, MappedRecordFile<TestRecord>& mapped){
+//Description: Aggregates the file with parallelScanRecords.
+    ScanTotals totals;
+    parallelScanRecords(file, mapped, totals,
+        [](ScanTotals& partial, const TestRecord& record, int index){
+            if (record.index != index) return;  //Wrong index: missing from the sum
+            ++partial.records;
+            partial.sum += record.value;
+            ++partial.groups[record.group];
+            if (record.dead) partial.dead.push_back(index);
+        },
+        [](ScanTotals& all, const ScanTotals& partial){
+            all.records += partial.records;
+            all.sum += partial.sum;
+            for (unordered_map<int, long long>::const_iterator it = partial.groups.begin(); it != partial.groups.end(); ++it){
+                all.groups[it->first] += it->second;
+            }
+            all.dead.insert(all.dead.end(), partial.dead.begin(), partial.dead.end());
+        });
+    sort(totals.dead.begin(), totals.dead.end());
+    return totals;
+}
+
+//----------------------------------------------------------------------------
+static ScanTotals sequentialTotals(PositionalFile& file, MappedRecordFile<TestRecord>& mapped){
+//Description: Aggregates the file with scanRecords.
+    ScanTotals totals;
+    scanRecords(file, mapped, [&](const TestRecord& record, int index){
+        if (record.index != index) return true;
+        ++totals.records;
+        totals.sum += record.value;
+        ++totals.groups[record.group];
+        if (record.dead) totals.dead.push_back(index);
+        return true;
+    });
+    return totals;
+}
+
+//----------------------------------------------------------------------------
+static bool sameTotals(const ScanTotals& a, const ScanTotals& b){
+//Description: Compares two aggregates field by field.
+    return a.records == b.records && a.sum == b.sum && a.groups == b.groups && a.dead == b.dead;
+}
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    const string dataName = "testParallelScan.dat";
+    bool pass = true;
+    {
+        ofstream out(dataName.c_str(), ios::binary | ios::trunc);
+        for (int i = 0; i < records; ++i){
+            TestRecord record = makeRecord(i, 1);
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+    }
+    PositionalFile file(dataName);
+    MappedRecordFile<TestRecord> mapped(dataName);
+    const long long recordBytes = static_cast<long long>(sizeof(TestRecord));
+
+    // Every thread count and read path gives the sequential result
+    ScanTotals expected = sequentialTotals(file, mapped);
+    if (expected.records != records){
+        cerr << "Error: sequential scan saw " << expected.records << " records" << endl;
+        pass = false;
+    }
+    RecordStoreMode modes[] = {mappedRecordStore, streamRecordStore};
+    for (int m = 0; m < 2; ++m){
+        setRecordStoreMode(modes[m]);
+        for (int threads = 1; threads <= 8; threads *= 2){
+            setScanThreads(threads);
+            if (!sameTotals(parallelTotals(file, mapped), expected)){
+                cerr << "Error: " << threads << " threads differ from the sequential scan (mode " << m << ")" << endl;
+                pass = false;
+            }
+        }
+    }
+    setRecordStoreMode(mappedRecordStore);
+    setScanThreads(0);
+
+    // Workers read at the caller's snapshot while the file is rewritten
+    {
+        StoreSnapshot snapshot;
+        thread writer([&]() {
+            for (int i = 0; i < records; i += 97){
+                TestRecord record = makeRecord(i, 2);
+                file.writeAt(i * recordBytes, &record, sizeof(record));
+            }
+            file.resize((records / 2) * recordBytes);
+        });
+        writer.join();
+        setScanThreads(4);
+        if (!sameTotals(parallelTotals(file, mapped), expected)){
+            cerr << "Error: scan workers did not read at the snapshot's version" << endl;
+            pass = false;
+        }
+    }
+    if (parallelTotals(file, mapped).records != records / 2){
+        cerr << "Error: changes not visible to the parallel scan after the snapshot" << endl;
+        pass = false;
+    }
+    remove(dataName.c_str());
+
+    // Report totals over a booking file split into chunks
+    int expectedLive = 0;
+    {
+        ofstream out(fileNameBooking.c_str(), ios::binary | ios::trunc);
+        RecordFileHeader header = makeRecordFileHeader(bookingFileMagic, bookingFileVersion, sizeof(Booking));
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        const char* sailings[] = {"TSA-12-08", "TSA-12-20", "YVR-13-09"};
+        for (int i = 0; i < parallelScanMinRecords + 5000; ++i){
+            Booking booking("P" + to_string(i), sailings[i % 3], "6045550000", i % 4 == 0);
+            if (i % 10 == 0) booking.setDeleted(true);
+            else ++expectedLive;
+            out.write(reinterpret_cast<const char*>(&booking), sizeof(booking));
+        }
+    }
+    fstream bookingFile(fileNameBooking, ios::binary | ios::in | ios::out);
+    unordered_map<SailingKey, SailingBookingTotals> totals;
+    unordered_map<SailingKey, SailingBookingTotals> oneThread;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    aggregateBookingsBySailing(bookingFile, totals);
+    double parallelMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    setScanThreads(1);
+    start = chrono::steady_clock::now();
+    aggregateBookingsBySailing(bookingFile, oneThread);
+    double serialMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    setScanThreads(0);
+    int live = 0;
+    for (unordered_map<SailingKey, SailingBookingTotals>::const_iterator it = totals.begin(); it != totals.end(); ++it){
+        live += it->second.vehicles;
+        if (oneThread[it->first].vehicles != it->second.vehicles || oneThread[it->first].checkedIn != it->second.checkedIn) pass = false;
+    }
+    if (!pass || totals.size() != 3 || live != expectedLive){
+        cerr << "Error: parallel report totals (" << live << " live bookings) differ from one thread" << endl;
+        pass = false;
+    } else{
+        cout << live << " bookings totalled in " << parallelMs << " ms (" << getScanThreads()
+             << " scan threads), " << serialMs << " ms (1 thread)" << endl;
+    }
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
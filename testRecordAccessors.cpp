@@ -0,0 +1,139 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testRecordAccessors.cpp
+// Rev.2 - 18/10/2026 - The counting operator new/delete are kept out of line
+// Rev.1 - 17/10/2026 - Implemented a test driver for the non-allocating accessors
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for the in-place accessors and equality
+// helpers of the record classes. They must agree with the string getters,
+// including for values too long to be stored, and a scan of a large booking
+// file that matches keys with them must not allocate any memory. Heap
+// allocations are counted by replacing the global operator new and delete,
+// which allocate with malloc and release with free. They are never inlined,
+// so the compiler does not see malloc or free paired with new or delete at
+// a call site (-Wmismatched-new-delete).
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "BookingUserIO.h"
+#include "SailingUserIO.h"
+#include "VehicleFileIO.h"
+#include "VesselUserIO.h"
+#include "RecordStore.h"
+
+using namespace std;
+
+#if defined(__GNUC__)
+#define NOT_INLINED __attribute__((noinline))
+#else
+#define NOT_INLINED
+#endif
+
+static long long allocations = 0;  //Calls to operator new so far
+
+NOT_INLINED void* operator new(size_t bytes){
+    ++allocations;
+    void* p = malloc(bytes == 0 ? 1 : bytes);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+NOT_INLINED void operator delete(void* p) noexcept{
+    free(p);
+}
+
+NOT_INLINED void operator delete(void* p, size_t) noexcept{
+    free(p);
+}
+
+const int bookings = 200000;  //Records in the scanned file
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    bool pass = true;
+
+    // Accessors agree with the getters; helpers match only the exact value
+    Booking booking("ABC123", "TSA-12-08", "6045551234", false);
+    Sailing sailing;
+    sailing.setSailingID("TSA-12-08");
+    sailing.setVesselName("Coastal Celebration");
+    Vehicle vehicle("ABC123", 2.0f, 5.0f);
+    Vessel vessel("Queen of Nanaimo", 40, 10);
+    if (booking.getLicensePlate() != booking.getLicensePlateChars() ||
+        booking.getPhoneNumber() != booking.getPhoneNumberChars() ||
+        sailing.getVesselName() != sailing.getVesselNameChars() ||
+        vehicle.getLicensePlate() != vehicle.getLicensePlateChars() ||
+        vessel.getName() != vessel.getNameChars()){
+        cerr << "Error: in-place accessors differ from the getters" << endl;
+        pass = false;
+    }
+    if (!booking.hasLicensePlate("ABC123") || booking.hasLicensePlate("ABC12") || booking.hasLicensePlate("ABC1234") ||
+        !booking.hasKey(packSailingKey("TSA-12-08"), "ABC123") || booking.hasKey(packSailingKey("TSA-12-09"), "ABC123") ||
+        !sailing.hasSailingID("TSA-12-08") || sailing.hasSailingID("TSA-12") || sailing.hasSailingID("bad") ||
+        !sailing.hasVesselName("Coastal Celebration") || sailing.hasVesselName("Coastal") ||
+        !vehicle.hasLicensePlate("ABC123") || vehicle.hasLicensePlate("ABC") ||
+        !vessel.hasName("Queen of Nanaimo") || vessel.hasName("Queen of Nanaimo II")){
+        cerr << "Error: equality helpers matched the wrong values" << endl;
+        pass = false;
+    }
+    Vehicle truncated("ABCDEFGHIJKL", 2.0f, 5.0f);  //Stored as its first 10 characters
+    if (truncated.hasLicensePlate("ABCDEFGHIJKL") || !truncated.hasLicensePlate("ABCDEFGHIJ")){
+        cerr << "Error: a truncated plate compared like the getter would not" << endl;
+        pass = false;
+    }
+
+    // A scan matching keys with the helpers allocates nothing
+    const string dataName = "testRecordAccessors.dat";
+    const string plate = "P42";
+    SailingKey key = packSailingKey("YVR-13-09");
+    int expectedMatches = 0, expectedCheckedIn = 0, expectedLong = 0;
+    {
+        ofstream out(dataName.c_str(), ios::binary | ios::trunc);
+        const char* sailings[] = {"TSA-12-08", "TSA-12-20", "YVR-13-09", "NAN-01-07"};
+        for (int i = 0; i < bookings; ++i){
+            Booking record("P" + to_string(i % 4999), sailings[i % 4], "6045550000", i % 3 == 0);
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            if (record.getLicensePlate() == plate && record.getSailingID() == "YVR-13-09") ++expectedMatches;
+            if (record.getLicensePlate() == plate && record.getCheckedIn()) ++expectedCheckedIn;
+            if (record.getLicensePlate().size() + record.getPhoneNumber().size() > 14) ++expectedLong;
+        }
+    }
+    PositionalFile file(dataName);
+    MappedRecordFile<Booking> mapped(dataName);
+    int matches = 0, checkedIn = 0, longPlates = 0;
+    long long before = -1, during = -1;
+    scanRecords(file, mapped, [&](const Booking& temp, int index){
+        if (index == 0) before = allocations;
+        if (temp.hasKey(key, plate)) ++matches;
+        if (temp.hasLicensePlate(plate) && temp.getCheckedIn()) ++checkedIn;
+        if (strlen(temp.getLicensePlateChars()) + strlen(temp.getPhoneNumberChars()) > 14) ++longPlates;
+        if (index == bookings - 1) during = allocations - before;
+        return true;
+    });
+    remove(dataName.c_str());
+    if (during != 0 || matches != expectedMatches || expectedMatches == 0 || checkedIn != expectedCheckedIn ||
+        longPlates != expectedLong){
+        cerr << "Error: scan made " << during << " allocations and found " << matches << " matches, "
+             << checkedIn << " checked in, " << longPlates << " long plates" << endl;
+        pass = false;
+    } else{
+        cout << bookings << " bookings scanned with " << during << " allocations" << endl;
+    }
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
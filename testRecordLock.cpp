@@ -0,0 +1,290 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testRecordLock.cpp
+// Rev.6 - 18/10/2026 - A sailing lookup waiting for a locked record does not
+//                      hold up lookups of other sailings
+// Rev.5 - 18/10/2026 - The hash booking store is refused to a second process
+// Rev.4 - 18/10/2026 - A delete made by another process reaches this one's counts
+// Rev.3 - 18/10/2026 - Two processes update one sailing's capacity at once
+// Rev.2 - 18/10/2026 - Checks that a nested exclusive lock upgrades a shared one
+// Rev.1 - 17/10/2026 - Implemented a test driver for byte-range file locking
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for RecordLock. Two FerryQ processes
+// append bookings to the same file at once; with the tail locked no append
+// lands on top of another. A booking deleted by a second process must then
+// drop out of the first one's counts and lookups. Two processes then update the capacity of one
+// sailing at once, and every update must be counted. The hash booking store,
+// which one process at a time may use, must be refused to a second process
+// while the first has it. A reader is then checked to wait for a writer
+// holding its record, and to pass a writer holding a different record, and
+// an exclusive lock nested in a shared one is checked to upgrade it only
+// until it is released. Last, a sailing lookup waiting for a record held by
+// a writer must not hold up a lookup of another sailing.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "BookingFileIO.h"
+#include "SailingFileIO.h"
+#include "RecordStore.h"
+
+using namespace std;
+
+const int bookingsPerProcess = 2000;
+const int updatesPerProcess = 500;
+
+//----------------------------------------------------------------------------
+static void appendBookings(const string& prefix){
+//Description: Appends bookingsPerProcess bookings with plates prefix0, prefix1, ...
+    fstream file(fileNameBooking, ios::binary | ios::in | ios::out);
+    buildBookingIndex(file);
+    for (int i = 0; i < bookingsPerProcess; ++i) {
+        Booking booking(prefix + to_string(i), "TSA-12-08", "6045551234", false);
+        writeBooking(booking, file);
+    }
+}
+
+//----------------------------------------------------------------------------
+static bool updateCapacity(){
+//Description: Books updatesPerProcess 0.1 m vehicles onto sailing TSA-12-08.
+    fstream file(fileNameSailing, ios::binary | ios::in | ios::out);
+    buildSailingIndex(file);
+    for (int i = 0; i < updatesPerProcess; ++i) {
+        if (!updateSailingCapacities(file, "TSA-12-08", 0.1f, 0.0f, 1, 0)) return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+static long long waitedForRead(PositionalFile& file, MappedRecordFile<Booking>& mapped,
+                               long long lockedOffset, int readIndex){
+//Description: Holds an exclusive lock on one record from another thread and
+//             returns how many milliseconds a read of readIndex took.
+    bool locked = false;
+    thread writer([&]() {
+        RecordLock lock(file, lockedOffset, static_cast<long long>(sizeof(Booking)), true);
+        locked = lock.isHeld();
+        this_thread::sleep_for(chrono::milliseconds(300));
+    });
+    this_thread::sleep_for(chrono::milliseconds(50));  //Let the writer take its lock
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Booking record;
+    readRecordAt(file, mapped, readIndex, record);
+    long long waited = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    writer.join();
+    return locked ? waited : -1;
+}
+
+//----------------------------------------------------------------------------
+static long long waitedForNestedRead(PositionalFile& file, MappedRecordFile<Booking>& mapped){
+//Description: Holds a shared lock on the file from another thread, with an
+//             exclusive lock on record 0 nested in it for the first 300 ms,
+//             and returns how many milliseconds a read of record 0 took.
+    bool locked = false;
+    thread writer([&]() {
+        RecordLock outer(file, 0, toEndOfFile, false);
+        {
+            RecordLock inner(file, 0, static_cast<long long>(sizeof(Booking)), true);
+            locked = outer.isHeld() && inner.isHeld();
+            this_thread::sleep_for(chrono::milliseconds(300));
+        }
+        this_thread::sleep_for(chrono::milliseconds(300));
+    });
+    this_thread::sleep_for(chrono::milliseconds(50));  //Let the writer take its locks
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Booking record;
+    readRecordAt(file, mapped, 0, record);
+    long long waited = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    writer.join();
+    return locked ? waited : -1;
+}
+
+//----------------------------------------------------------------------------
+static long long waitedForOtherSailing(fstream& sailingFile){
+//Description: Holds an exclusive lock on TSA-12-08's record from another
+//             thread for 300 ms while a third thread looks it up, and
+//             returns how many milliseconds a lookup of TSA-13-09 took
+//             meanwhile (-1 if it failed).
+    PositionalFile data(fileNameSailing, recordFileHeaderBytes);
+    long long offset = static_cast<long long>(findSailingIndexByID(sailingFile, "TSA-12-08")) *
+                       static_cast<long long>(sizeof(Sailing));
+    thread writer([&]() {
+        RecordLock lock(data, offset, static_cast<long long>(sizeof(Sailing)), true);
+        this_thread::sleep_for(chrono::milliseconds(300));
+    });
+    this_thread::sleep_for(chrono::milliseconds(50));  //Let the writer take its lock
+    thread blocked([&]() { findSailingIndexByID(sailingFile, "TSA-12-08"); });
+    this_thread::sleep_for(chrono::milliseconds(50));  //Let the lookup reach the locked record
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool found = findSailingIndexByID(sailingFile, "TSA-13-09") >= 0;
+    long long waited = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    writer.join();
+    blocked.join();
+    return found ? waited : -1;
+}
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    { ofstream reset(fileNameBooking.c_str(), ios::binary | ios::trunc); }
+    bool pass = true;
+
+    // Two processes append at the same time
+    pid_t child = fork();
+    if (child == 0) {
+        appendBookings("C");
+        _exit(0);
+    }
+    appendBookings("P");
+    int status = 0;
+    if (child < 0 || waitpid(child, &status, 0) != child || status != 0) {
+        cerr << "Error: the second process failed" << endl;
+        pass = false;
+    }
+
+    fstream file(fileNameBooking, ios::binary | ios::in | ios::out);
+    buildBookingIndex(file);
+    int missing = 0;
+    Booking found;
+    for (int i = 0; i < bookingsPerProcess; ++i) {
+        if (!loadBookingByKey("TSA-12-08", "C" + to_string(i), found, file)) ++missing;
+        if (!loadBookingByKey("TSA-12-08", "P" + to_string(i), found, file)) ++missing;
+    }
+    if (countBookingRecords(file) != 2 * bookingsPerProcess || missing != 0) {
+        cerr << "Error: " << countBookingRecords(file) << " records, " << missing << " bookings lost" << endl;
+        pass = false;
+    } else {
+        cout << 2 * bookingsPerProcess << " bookings appended by two processes, none lost" << endl;
+    }
+
+    // Another process deletes a booking this one has indexed
+    countBookingsForSailing("TSA-12-08", file);
+    child = fork();
+    if (child == 0) {
+        fstream other(fileNameBooking, ios::binary | ios::in | ios::out);
+        buildBookingIndex(other);
+        _exit(deleteBookingRecord("TSA-12-08", "C0", other) ? 0 : 1);
+    }
+    if (child < 0 || waitpid(child, &status, 0) != child || status != 0) {
+        cerr << "Error: the second process could not delete" << endl;
+        pass = false;
+    }
+    if (countBookingsForSailing("TSA-12-08", file) != 2 * bookingsPerProcess - 1 ||
+        countBookingRecords(file) != 2 * bookingsPerProcess - 1 ||
+        loadBookingByKey("TSA-12-08", "C0", found, file)) {
+        cerr << "Error: " << countBookingsForSailing("TSA-12-08", file)
+             << " bookings counted after another process deleted one" << endl;
+        pass = false;
+    }
+
+    // Two processes update the same sailing's capacity at once
+    { ofstream reset(fileNameSailing.c_str(), ios::binary | ios::trunc); }
+    {
+        fstream sailingFile(fileNameSailing, ios::binary | ios::in | ios::out);
+        buildSailingIndex(sailingFile);
+        Sailing s;
+        s.setSailingID("TSA-12-08");
+        s.setVesselName("Queen of Test");
+        s.setCurrentCapacitySmall(200.0f);
+        s.setCurrentCapacityBig(20.0f);
+        s.setInitialCapacities(200.0f, 20.0f);
+        appendSailingRecord(sailingFile, s);
+    }
+    child = fork();
+    if (child == 0) {
+        _exit(updateCapacity() ? 0 : 1);
+    }
+    bool updated = updateCapacity();
+    if (child < 0 || waitpid(child, &status, 0) != child || status != 0 || !updated) {
+        cerr << "Error: a capacity update was refused" << endl;
+        pass = false;
+    }
+    fstream sailingFile(fileNameSailing, ios::binary | ios::in | ios::out);
+    buildSailingIndex(sailingFile);
+    Sailing stored;
+    loadSailingByIndex(sailingFile, findSailingIndexByID(sailingFile, "TSA-12-08"), stored);
+    float expectedLeft = 200.0f - 2 * updatesPerProcess * 0.1f;
+    if (stored.getBookedVehicles() != 2 * updatesPerProcess ||
+        stored.getCurrentCapacitySmall() < expectedLeft - 0.05f || stored.getCurrentCapacitySmall() > expectedLeft + 0.05f) {
+        cerr << "Error: " << stored.getBookedVehicles() << " vehicles and " << stored.getCurrentCapacitySmall()
+             << " m left after " << 2 * updatesPerProcess << " updates" << endl;
+        pass = false;
+    } else {
+        cout << 2 * updatesPerProcess << " capacity updates by two processes, none lost" << endl;
+    }
+
+    // A second process cannot open the hash store while the first has it
+    int ready[2], done[2];
+    if (pipe(ready) != 0 || pipe(done) != 0) return 1;
+    child = fork();
+    if (child == 0) {
+        close(ready[0]);
+        close(done[1]);
+        setBookingStoreEngine(hashBookingStore);
+        char claimed = claimBookingStore() ? 1 : 0;
+        if (write(ready[1], &claimed, 1) != 1) _exit(1);
+        read(done[0], &claimed, 1);  //Holds the claim until the parent is done
+        _exit(0);
+    }
+    close(ready[1]);
+    close(done[0]);
+    char claimed = 0;
+    bool childClaimed = read(ready[0], &claimed, 1) == 1 && claimed == 1;
+    setBookingStoreEngine(hashBookingStore);
+    bool refused = !claimBookingStore() && !buildBookingIndex(file);
+    setBookingStoreEngine(heapBookingStore);
+    close(ready[0]);
+    close(done[1]);
+    waitpid(child, &status, 0);
+    if (!childClaimed || !refused) {
+        cerr << "Error: two processes opened the hash booking store at once" << endl;
+        pass = false;
+    }
+
+#if defined(F_OFD_SETLKW)
+    // A read waits for a writer on its record, but not for one on another
+    PositionalFile data(fileNameBooking);
+    MappedRecordFile<Booking> mapped(fileNameBooking);
+    long long blocked = waitedForRead(data, mapped, 0, 0);
+    long long unblocked = waitedForRead(data, mapped, static_cast<long long>(sizeof(Booking)), 0);
+    if (blocked < 200 || unblocked < 0 || unblocked > 100) {
+        cerr << "Error: read waited " << blocked << " ms on a locked record, " << unblocked << " ms on a free one" << endl;
+        pass = false;
+    }
+
+    // The nested exclusive lock blocks the read; the shared lock left after it does not
+    long long nested = waitedForNestedRead(data, mapped);
+    if (nested < 200 || nested > 450) {
+        cerr << "Error: read waited " << nested << " ms on a nested exclusive lock" << endl;
+        pass = false;
+    }
+
+    // A lookup waiting for one sailing's record does not hold up another sailing's
+    Sailing second;
+    second.setSailingID("TSA-13-09");
+    second.setVesselName("Queen of Test");
+    second.setInitialCapacities(200.0f, 20.0f);
+    appendSailingRecord(sailingFile, second);
+    long long otherLookup = waitedForOtherSailing(sailingFile);
+    if (otherLookup < 0 || otherLookup > 100) {
+        cerr << "Error: a lookup of another sailing waited " << otherLookup << " ms" << endl;
+        pass = false;
+    }
+#endif
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
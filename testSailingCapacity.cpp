@@ -0,0 +1,92 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testSailingCapacity.cpp
+// Rev.1 - 17/10/2026 - Implemented a test driver for the capacity ledger
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for atomic capacity reservation: many
+// threads race to book a sailing until it is full, and the number of
+// successful reservations, the counters and the Sailing record must agree.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include "SailingFileIO.h"
+#include "SailingCapacity.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    { ofstream reset(fileNameSailing.c_str(), ios::binary | ios::trunc); }
+    fstream file(fileNameSailing, ios::binary | ios::in | ios::out);
+    buildSailingIndex(file);
+
+    // A sailing with 100 m in the regular lane and 20 m in the special lane
+    Sailing s;
+    s.setSailingID("TSA-12-08");
+    s.setVesselName("Queen of Test");
+    s.setCurrentCapacitySmall(100.0f);
+    s.setCurrentCapacityBig(20.0f);
+    s.setInitialCapacities(100.0f, 20.0f);
+    bool pass = appendSailingRecord(file, s);
+
+    // Eight agents book 2.5 m regular vehicles until the sailing refuses
+    const int agents = 8;
+    atomic<int> booked(0);
+    atomic<int> refused(0);
+    vector<thread> threads;
+    for (int t = 0; t < agents; ++t) {
+        threads.push_back(thread([&]() {
+            for (int i = 0; i < 20; ++i) {
+                if (reserveSailingCapacity(file, "TSA-12-08", 2.5f, 0.0f)) ++booked;
+                else ++refused;
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+
+    float regularLeft = -1, specialLeft = -1;
+    Sailing stored;
+    loadSailingByIndex(file, findSailingIndexByID(file, "TSA-12-08"), stored);
+    if (booked != 40 || refused != agents * 20 - 40 ||
+        !getReservedCapacity(file, "TSA-12-08", regularLeft, specialLeft) || regularLeft != 0.0f ||
+        stored.getCurrentCapacitySmall() != 0.0f || stored.getBookedVehicles() != 40) {
+        cerr << "Error: the sailing was overbooked or the record disagrees" << endl;
+        pass = false;
+    } else {
+        cout << booked << " reservations granted, " << refused << " refused" << endl;
+    }
+
+    // A full lane does not block the other one, and a release makes room again
+    if (!reserveSailingCapacity(file, "TSA-12-08", 0.0f, 12.0f) ||
+        reserveSailingCapacity(file, "TSA-12-08", 0.0f, 8.5f) ||
+        !releaseSailingCapacity(file, "TSA-12-08", 2.5f, 0.0f, false) ||
+        !reserveSailingCapacity(file, "TSA-12-08", 2.5f, 0.0f) ||
+        reserveSailingCapacity(file, "NOT-00-00", 1.0f, 0.0f)) {
+        cerr << "Error: lane separation or release failed" << endl;
+        pass = false;
+    }
+
+    // Counters reloaded from the record match the ones in memory
+    resetSailingCapacities();
+    if (!getReservedCapacity(file, "TSA-12-08", regularLeft, specialLeft) ||
+        regularLeft != 0.0f || specialLeft != 8.0f) {
+        cerr << "Error: counters reloaded from the record differ" << endl;
+        pass = false;
+    }
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
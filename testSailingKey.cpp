@@ -0,0 +1,117 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testSailingKey.cpp
+// Rev.1 - 17/10/2026 - Implemented a test driver for packed sailing IDs
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for SailingKey. IDs must survive a
+// pack and unpack unchanged, keys must sort exactly like the ID strings,
+// prefix ranges must cover exactly the IDs with that prefix, and malformed
+// IDs must be refused. Finally sailings are looked up by prefix through
+// the sorted index of SailingFileIO.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "SailingKey.h"
+#include "SailingFileIO.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    bool pass = true;
+    const char* terminals[] = {"AAA", "TSA", "TSa", "YVR", "ZZz", "abc", "zzz"};
+    vector<string> ids;
+    for (int t = 0; t < 7; ++t){
+        for (int day = 0; day < 100; day += 7){
+            for (int hour = 0; hour < 100; hour += 11){
+                string id = string(terminals[t]) + "-" + (day < 10 ? "0" : "") + to_string(day) +
+                            "-" + (hour < 10 ? "0" : "") + to_string(hour);
+                ids.push_back(id);
+            }
+        }
+    }
+
+    // Round trip and ordering
+    int badRoundTrips = 0, badOrders = 0;
+    for (size_t i = 0; i < ids.size(); ++i){
+        SailingKey key = packSailingKey(ids[i]);
+        if (key == noSailingKey || unpackSailingKey(key) != ids[i]) ++badRoundTrips;
+        for (size_t j = 0; j < ids.size(); j += 13){
+            if ((ids[i] < ids[j]) != (key < packSailingKey(ids[j]))) ++badOrders;
+        }
+    }
+    if (badRoundTrips != 0 || badOrders != 0){
+        cerr << "Error: " << badRoundTrips << " round trips and " << badOrders << " orderings wrong" << endl;
+        pass = false;
+    }
+
+    // Prefix ranges hold exactly the IDs with the prefix
+    const char* prefixes[] = {"TSA", "TSa", "TSA-14", "zzz-98"};
+    for (int p = 0; p < 4; ++p){
+        SailingKey first, last;
+        if (!getSailingKeyRange(prefixes[p], first, last)){
+            cerr << "Error: prefix " << prefixes[p] << " refused" << endl;
+            pass = false;
+            continue;
+        }
+        for (size_t i = 0; i < ids.size(); ++i){
+            SailingKey key = packSailingKey(ids[i]);
+            bool inRange = key >= first && key <= last;
+            if (inRange != (ids[i].compare(0, string(prefixes[p]).size(), prefixes[p]) == 0)){
+                cerr << "Error: " << ids[i] << " misplaced for prefix " << prefixes[p] << endl;
+                pass = false;
+                break;
+            }
+        }
+    }
+
+    // Malformed IDs
+    const char* malformed[] = {"", "TSA", "TSA-1-08", "TS1-12-08", "TSA-12-8a", "TSA_12_08", "TSA-12-080", "T\xe9S-12-08"};
+    for (int m = 0; m < 8; ++m){
+        if (packSailingKey(malformed[m]) != noSailingKey){
+            cerr << "Error: malformed ID \"" << malformed[m] << "\" was packed" << endl;
+            pass = false;
+        }
+    }
+    SailingKey first, last;
+    if (getSailingKeyRange("TS", first, last) || getSailingKeyRange("TSA-1", first, last) || unpackSailingKey(noSailingKey) != ""){
+        cerr << "Error: bad prefix accepted" << endl;
+        pass = false;
+    }
+
+    // Prefix lookups through the sorted sailing index
+    { ofstream reset(fileNameSailing.c_str(), ios::binary | ios::trunc); }
+    fstream sailingFile(fileNameSailing, ios::binary | ios::in | ios::out);
+    const char* stored[] = {"TSA-13-09", "TSA-12-08", "YVR-12-08", "TSA-12-20", "TSB-12-08"};
+    for (int i = 0; i < 5; ++i){
+        Sailing s;
+        s.setSailingID(stored[i]);
+        s.setVesselName("Queen of Nanaimo");
+        appendSailingRecord(sailingFile, s);
+    }
+    vector<int> day = findSailingIndexesByPrefix(sailingFile, "TSA-12");
+    vector<int> terminal = findSailingIndexesByPrefix(sailingFile, "TSA");
+    vector<int> one = findSailingIndexesByPrefix(sailingFile, "YVR-12-08");
+    if (day != vector<int>{1, 3} || terminal != vector<int>{1, 3, 0} || one != vector<int>{2} ||
+        findSailingIndexByID(sailingFile, "TSB-12-08") != 4){
+        cerr << "Error: prefix lookups through the sailing index returned wrong records" << endl;
+        pass = false;
+    } else{
+        cout << ids.size() << " IDs packed; index prefix lookups returned SailingID order" << endl;
+    }
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
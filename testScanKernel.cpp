@@ -0,0 +1,100 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testScanKernel.cpp
+// Rev.1 - 17/10/2026 - Implemented a test driver for the scan kernels
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for findRecordKey. Blocks of records
+// of several strides hold keys that differ from the one searched for in a
+// single byte; every variant the processor supports must find the same
+// record as the scalar loop for every field offset and width. The last
+// block ends against a page that cannot be read, so a load past the end of
+// the last record would crash the test.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "ScanKernel.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+static void fillRecords(char* records, size_t stride, int count, size_t keyOffset, const char* key,
+                        size_t keyBytes, int target){
+//Description: Gives every record a near miss of the key (one byte changed)
+//             and puts the key itself in record target (none if -1).
+    for (int i = 0; i < count; ++i){
+        char* record = records + static_cast<size_t>(i) * stride;
+        for (size_t b = 0; b < stride; ++b) record[b] = static_cast<char>(rand());
+        memcpy(record + keyOffset, key, keyBytes);
+        if (i != target) record[keyOffset + static_cast<size_t>(rand()) % keyBytes] ^= static_cast<char>(1 + rand() % 255);
+    }
+}
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    bool pass = true;
+    srand(17);
+    const size_t strides[] = {11, 16, 20, 40, 56, 64};
+    const int count = 37;  //Not a multiple of the unrolling
+    const ScanKernelKind kinds[] = {scalarScanKernel, sse2ScanKernel, avx2ScanKernel};
+    ScanKernelKind best = getBestScanKernel();
+
+    // The last record ends where an unreadable page begins
+    long page = sysconf(_SC_PAGESIZE);
+    char* area = static_cast<char*>(mmap(0, static_cast<size_t>(page) * 3, PROT_READ | PROT_WRITE,
+                                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (area == MAP_FAILED || mprotect(area + 2 * page, static_cast<size_t>(page), PROT_NONE) != 0){
+        cerr << "Error: could not set up the guard page" << endl;
+        return 1;
+    }
+
+    int checks = 0;
+    for (size_t s = 0; s < sizeof(strides) / sizeof(strides[0]); ++s){
+        size_t stride = strides[s];
+        char* records = area + 2 * page - stride * count;
+        for (size_t keyBytes = 1; keyBytes <= maxScanKeyBytes && keyBytes <= stride; ++keyBytes){
+            for (size_t keyOffset = 0; keyOffset + keyBytes <= stride; keyOffset += 3){
+                char key[maxScanKeyBytes];
+                for (size_t b = 0; b < keyBytes; ++b) key[b] = static_cast<char>(rand());
+                int targets[] = {-1, 0, 1, 2, 3, 4, count / 2, count - 2, count - 1};
+                for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); ++t){
+                    fillRecords(records, stride, count, keyOffset, key, keyBytes, targets[t]);
+                    for (int k = 0; k < 3; ++k){
+                        setScanKernel(kinds[k]);
+                        int found = findRecordKey(records, stride, count, keyOffset, key, keyBytes);
+                        ++checks;
+                        if (found != targets[t]){
+                            cerr << "Error: kernel " << getScanKernel() << " found " << found << " instead of " << targets[t]
+                                 << " (stride " << stride << ", offset " << keyOffset << ", " << keyBytes << " bytes)" << endl;
+                            pass = false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Unsupported variants fall back to the best one available
+    setScanKernel(avx2ScanKernel);
+    if (getScanKernel() != best){
+        cerr << "Error: variant beyond the processor was selected" << endl;
+        pass = false;
+    }
+    munmap(area, static_cast<size_t>(page) * 3);
+    cout << checks << " searches agreed; best variant " << (best == avx2ScanKernel ? "AVX2" : best == sse2ScanKernel ? "SSE2" : "scalar") << endl;
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,173 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testStoreSnapshot.cpp
+// Rev.2 - 18/10/2026 - Adds a multi-record write and writes to a second file
+// Rev.1 - 17/10/2026 - Implemented a test driver for StoreSnapshot
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for snapshot reads. While the main
+// thread holds a StoreSnapshot, another thread overwrites, appends and
+// truncates a data file (one write covering several records under a later
+// one-record write), writes the same offsets of a second file, and adds a
+// booking; reads, scans and sizes through
+// the snapshot must still show the files as they were. Once it is released
+// the same reads show the new contents.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include "BookingFileIO.h"
+#include "RecordStore.h"
+
+using namespace std;
+
+//A 50-byte record, numbered in file order
+struct TestRecord{
+    int index;
+    char fill[46];
+};
+
+const int records = 3000;  //Several scan batches
+
+//----------------------------------------------------------------------------
+static TestRecord makeRecord(int index, int generation){
+//Description: Builds record index of the given generation.
+    TestRecord record;
+    memset(&record, 0, sizeof(record));
+    record.index = index;
+    record.fill[0] = static_cast<char>(generation);
+    return record;
+}
+
+//----------------------------------------------------------------------------
+static bool showsOriginal(PositionalFile& file, MappedRecordFile<TestRecord>& mapped){
+//Description: Checks size, point reads and a scan all see the first
+//             generation of every record.
+    if (file.size() != static_cast<long long>(records) * static_cast<long long>(sizeof(TestRecord))) return false;
+    TestRecord record;
+    int probes[] = {0, 5, 12, 15, 999, records - 1};
+    for (int i = 0; i < 6; ++i){
+        if (!readRecordAt(file, mapped, probes[i], record) || record.index != probes[i] || record.fill[0] != 1) return false;
+    }
+    if (readRecordAt(file, mapped, records, record)) return false;
+    int seen = 0;
+    bool original = true;
+    scanRecords(file, mapped, [&](const TestRecord& temp, int index){
+        if (temp.index != index || temp.fill[0] != 1) original = false;
+        ++seen;
+        return true;
+    });
+    return original && seen == records;
+}
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    const string dataName = "testStoreSnapshot.dat";
+    bool pass = true;
+    {
+        ofstream out(dataName.c_str(), ios::binary | ios::trunc);
+        for (int i = 0; i < records; ++i){
+            TestRecord record = makeRecord(i, 1);
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+    }
+    const string otherName = "testStoreSnapshot2.dat";
+    PositionalFile file(dataName);
+    PositionalFile other(otherName);
+    MappedRecordFile<TestRecord> mapped(dataName);
+    const long long recordBytes = static_cast<long long>(sizeof(TestRecord));
+
+    // Another thread changes the file while a snapshot is pinned
+    {
+        StoreSnapshot snapshot;
+        thread writer([&]() {
+            TestRecord record = makeRecord(5, 2);
+            file.writeAt(5 * recordBytes, &record, sizeof(record));
+            TestRecord block[10];
+            for (int i = 0; i < 10; ++i) block[i] = makeRecord(10 + i, 2);
+            file.writeAt(10 * recordBytes, block, sizeof(block));
+            record = makeRecord(15, 3);
+            file.writeAt(15 * recordBytes, &record, sizeof(record));
+            for (int i = 0; i < 20; ++i){
+                record = makeRecord(-1, 4);
+                other.writeAt(i * recordBytes, &record, sizeof(record));
+            }
+            for (int i = records; i < records + 100; ++i){
+                record = makeRecord(i, 2);
+                file.writeAt(i * recordBytes, &record, sizeof(record));
+            }
+            file.resize(1000 * recordBytes);
+            record = makeRecord(999, 3);
+            file.writeAt(999 * recordBytes, &record, sizeof(record));
+            record = makeRecord(1500, 3);
+            file.writeAt(1500 * recordBytes, &record, sizeof(record));
+        });
+        writer.join();
+        if (!showsOriginal(file, mapped)){
+            cerr << "Error: snapshot did not read the original file" << endl;
+            pass = false;
+        }
+        {
+            StoreSnapshot inner;  //Shares the outer version
+            if (inner.getVersion() != snapshot.getVersion() || !showsOriginal(file, mapped)){
+                cerr << "Error: nested snapshot read a different version" << endl;
+                pass = false;
+            }
+        }
+    }
+
+    // Released: the same reads see the changes
+    TestRecord record;
+    if (!isSnapshotActive() && file.size() == 1501 * recordBytes &&
+        readRecordAt(file, mapped, 999, record) && record.fill[0] == 3 &&
+        readRecordAt(file, mapped, 5, record) && record.fill[0] == 2 &&
+        readRecordAt(file, mapped, 12, record) && record.fill[0] == 2 &&
+        readRecordAt(file, mapped, 15, record) && record.fill[0] == 3 &&
+        readRecordAt(file, mapped, 1200, record) && record.index == 0){
+        cout << "Snapshot read " << records << " original records under overwrite, append and truncate" << endl;
+    } else{
+        cerr << "Error: changes not visible after the snapshot was released" << endl;
+        pass = false;
+    }
+    remove(dataName.c_str());
+    remove(otherName.c_str());
+
+    // A report-style aggregate ignores a booking added after its snapshot
+    { ofstream reset(fileNameBooking.c_str(), ios::binary | ios::trunc); }
+    fstream bookingFile(fileNameBooking, ios::binary | ios::in | ios::out);
+    buildBookingIndex(bookingFile);
+    writeBooking(Booking("SNAP1", "TSA-12-08", "6045551234", false), bookingFile);
+    unordered_map<SailingKey, SailingBookingTotals> totals;
+    {
+        StoreSnapshot snapshot;
+        thread writer([&]() {
+            writeBooking(Booking("SNAP2", "TSA-12-08", "6045551234", false), bookingFile);
+        });
+        writer.join();
+        aggregateBookingsBySailing(bookingFile, totals);
+    }
+    if (totals[packSailingKey("TSA-12-08")].vehicles != 1){
+        cerr << "Error: snapshot aggregate saw " << totals[packSailingKey("TSA-12-08")].vehicles << " bookings" << endl;
+        pass = false;
+    }
+    aggregateBookingsBySailing(bookingFile, totals);
+    if (totals[packSailingKey("TSA-12-08")].vehicles != 2){
+        cerr << "Error: aggregate after release saw " << totals[packSailingKey("TSA-12-08")].vehicles << " bookings" << endl;
+        pass = false;
+    }
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}
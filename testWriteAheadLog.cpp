@@ -0,0 +1,150 @@
+// @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
+//
+// MODULE NAME: testWriteAheadLog.cpp
+// Rev.4 - 18/10/2026 - The file header stamped by the index build is a committed change too
+// Rev.3 - 18/10/2026 - Checks that a second process claims its own log slot
+// Rev.2 - 18/10/2026 - Checks that an abort rolls back its own level only
+// Rev.1 - 17/10/2026 - Implemented a test driver for write-ahead log recovery
+//
+// ----------------------------------------------------------------------------
+// This module contains a test driver for the write-ahead log. It takes a copy
+// of the log in the middle of a transaction (as a crash would leave it) and
+// checks that replay rolls back the unfinished booking and redoes the
+// committed one, and that abortWalTransaction undoes a nested level or the
+// whole transaction without a crash. A forked second process must claim its
+// own log slot and leave the first process's log alone.
+// ----------------------------------------------------------------------------
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "BookingFileIO.h"
+#include "WriteAheadLog.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+static void copyFile(const string& from, const string& to){
+//Description: Copies a file byte for byte.
+    ifstream in(from.c_str(), ios::binary);
+    ofstream out(to.c_str(), ios::binary | ios::trunc);
+    out << in.rdbuf();
+}
+
+//----------------------------------------------------------------------------
+static long long fileSize(const string& name){
+//Description: Returns the size of a file, or -1 if it does not exist.
+    struct stat info;
+    return stat(name.c_str(), &info) == 0 ? static_cast<long long>(info.st_size) : -1;
+}
+
+//----------------------------------------------------------------------------
+int main() {
+//Description: This is a test driver! not the actual main function of the program
+    const string logName = "testWal.wal";
+    const string crashLogName = "testWalCrash.wal";
+
+    // Start from an empty booking file and log
+    { ofstream reset(fileNameBooking.c_str(), ios::binary | ios::trunc); }
+    remove(logName.c_str());
+    if (!openWriteAheadLog(logName)) {
+        cerr << "Error: Unable to open " << logName << endl;
+        return 1;
+    }
+    setWalDurability(walFsync);
+    fstream file(fileNameBooking, ios::binary | ios::in | ios::out);
+    buildBookingIndex(file);
+
+    bool pass = true;
+    Booking b1("ABC123", "TSA-12-08", "6045551234", false);
+    Booking b2("XYZ789", "TSA-12-08", "6045550000", false);
+
+    // One committed booking, then a crash in the middle of the next one
+    beginWalTransaction();
+    writeBooking(b1, file);
+    commitWalTransaction();
+    beginWalTransaction();
+    writeBooking(b2, file);
+    copyFile(logName, crashLogName);
+
+    // Replay rolls back the unfinished booking (the file header and the
+    // first booking are the two committed transactions)
+    if (replayWriteAheadLog(crashLogName) != 2 || countBookingRecords(file) != 1) {
+        cerr << "Error: unfinished transaction was not rolled back" << endl;
+        pass = false;
+    }
+
+    // Replay also restores a committed booking whose data write was lost
+    { ofstream lost(fileNameBooking.c_str(), ios::binary | ios::trunc); }
+    replayWriteAheadLog(crashLogName);
+    Booking found;
+    if (!loadBookingByKey("TSA-12-08", "ABC123", found, file) ||
+        loadBookingByKey("TSA-12-08", "XYZ789", found, file)) {
+        cerr << "Error: committed booking was not redone" << endl;
+        pass = false;
+    } else {
+        cout << "Replay kept the committed booking and dropped the unfinished one" << endl;
+    }
+
+    // An abort undoes only its own level; the outer abort undoes the rest
+    commitWalTransaction();
+    beginWalTransaction();
+    writeBooking(b2, file);
+    beginWalTransaction();
+    deleteBookingRecord("TSA-12-08", "ABC123", file);
+    abortWalTransaction();
+    buildBookingIndex(file);
+    if (!loadBookingByKey("TSA-12-08", "ABC123", found, file) ||
+        !loadBookingByKey("TSA-12-08", "XYZ789", found, file)) {
+        cerr << "Error: nested abort did not restore only its own level" << endl;
+        pass = false;
+    }
+    abortWalTransaction();
+    buildBookingIndex(file);
+    if (countBookingRecords(file) != 1 || loadBookingByKey("TSA-12-08", "XYZ789", found, file)) {
+        cerr << "Error: abort did not roll back the transaction" << endl;
+        pass = false;
+    } else {
+        cout << "Abort restored the file as it was before the transaction" << endl;
+    }
+
+    // A second process gets the next slot; the first log is not replayed
+    remove((logName + ".1").c_str());
+    long long logBytes = fileSize(logName);
+    pid_t child = fork();
+    if (child == 0) {
+        bool claimed = openWriteAheadLog(logName) && fileSize(logName + ".1") == 0 &&
+                       fileSize(logName) == logBytes;
+        closeWriteAheadLog();
+        _exit(claimed && fileSize(logName + ".1") < 0 ? 0 : 1);
+    }
+    int status = 1;
+    waitpid(child, &status, 0);
+    if (child < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || fileSize(logName) != logBytes) {
+        cerr << "Error: second process did not get a log slot of its own" << endl;
+        pass = false;
+    } else {
+        cout << "Second process logged to its own slot and left the first log alone" << endl;
+    }
+
+    // A clean shutdown checkpoints and empties the log
+    closeWriteAheadLog();
+    ifstream log(logName.c_str(), ios::binary | ios::ate);
+    if (!log || log.tellg() != 0) {
+        cerr << "Error: log was not emptied by the checkpoint" << endl;
+        pass = false;
+    }
+    remove(crashLogName.c_str());
+
+    // Final result
+    if(pass){
+        cout << "Test passed!" << endl;
+        return 0;
+    } else {
+        cout << "Test Failed!" << endl;
+        return 1;
+    }
+}